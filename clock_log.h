@@ -0,0 +1,205 @@
+// Logging shared by esp1.cpp and esp2.cpp.
+//
+// LOG_ERROR/WARN/INFO/DEBUG format into a fixed-size record in a ring and
+// return; nothing waits on the UART. A low-priority task started by
+// logBegin() drains the ring to Serial, and esp1.cpp also serves it on
+// GET /logs. Calls above LOG_LEVEL compile to nothing, arguments included,
+// so define LOG_LEVEL before including this header to change it.
+//
+// Writers never block and never lock: each claims a position with one
+// atomic increment and publishes its slot with a sequence number that only
+// ever moves forward. When the ring wraps before a reader gets there, or a
+// writer is lapped mid-copy, the reader skips what it missed and counts it.
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <stdarg.h>
+#include <stddef.h>
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_RING_SLOTS 64  // power of two, so positions wrap cleanly
+#define LOG_TEXT_MAX 96    // longer messages are cut
+#define LOG_FORMATTED_MAX (LOG_TEXT_MAX + 24)
+#define LOG_DRAIN_INTERVAL_MS 50
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) logWrite(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) logWrite(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) logWrite(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) logWrite(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do {} while (0)
+#endif
+
+typedef struct LogLine {
+  uint32_t ms;     // millis() when logged
+  uint8_t level;   // LOG_LEVEL_*
+  uint8_t length;  // of text, without the terminator
+  char text[LOG_TEXT_MAX];
+} LogLine;
+
+typedef struct LogLineSlot {
+  // 2 * position + 1 while the record is being written, + 2 once it is
+  // complete; never moves back. A reader that sees it change under its
+  // copy skips the record.
+  std::atomic<uint32_t> seq;
+  LogLine record;
+} LogLineSlot;
+
+static_assert((LOG_RING_SLOTS & (LOG_RING_SLOTS - 1)) == 0, "LOG_RING_SLOTS must be a power of two");
+
+inline LogLineSlot logRing[LOG_RING_SLOTS];
+inline std::atomic<uint32_t> logHead{ 0 };     // next position to claim
+inline std::atomic<uint32_t> logDropped{ 0 };  // overwritten before reaching the UART
+inline TaskHandle_t logTaskHandle = NULL;
+
+inline void logWrite(uint8_t level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+inline LogLineSlot* logSlotClaim(uint32_t pos);
+inline void logSlotPublish(LogLineSlot& slot, uint32_t pos);
+
+inline void logWrite(uint8_t level, const char* format, ...) {
+  // Formatted off to the side, the slot is only held for one copy
+  LogLine record;
+  record.ms = millis();
+  record.level = level;
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(record.text, sizeof(record.text), format, args);
+  va_end(args);
+  record.length = (uint8_t)constrain(length, 0, LOG_TEXT_MAX - 1);
+
+  uint32_t pos = logHead.fetch_add(1, std::memory_order_relaxed);
+  LogLineSlot* slot = logSlotClaim(pos);
+  if (slot == NULL) return;
+  memcpy(&slot->record, &record, offsetof(LogLine, text) + record.length + 1);
+  logSlotPublish(*slot, pos);
+}
+
+// Marks the slot for pos as being written. NULL when a writer further
+// ahead already took it, this record is then lost and readers skip it.
+inline LogLineSlot* logSlotClaim(uint32_t pos) {
+  LogLineSlot& slot = logRing[pos % LOG_RING_SLOTS];
+  uint32_t seen = slot.seq.load(std::memory_order_relaxed);
+  do {
+    if ((int32_t)(seen - 2 * pos) > 0) return NULL;
+  } while (!slot.seq.compare_exchange_weak(seen, 2 * pos + 1, std::memory_order_relaxed));
+  std::atomic_thread_fence(std::memory_order_release);
+  return &slot;
+}
+
+inline void logSlotPublish(LogLineSlot& slot, uint32_t pos) {
+  uint32_t claimed = 2 * pos + 1;
+  if (slot.seq.compare_exchange_strong(claimed, 2 * pos + 2, std::memory_order_release, std::memory_order_relaxed)) return;
+
+  // Lapped while copying: the newer record may be mixed with this one.
+  // Moving seq past it makes readers skip it, never step back.
+  slot.seq.compare_exchange_strong(claimed, (claimed + 1) | 1, std::memory_order_release, std::memory_order_relaxed);
+}
+
+// Next record after cursor, advancing it. False once the reader has caught
+// up, or while the next record is still being written. Records overwritten
+// before they were read are skipped and added to *skipped.
+inline bool logRead(uint32_t& cursor, LogLine& out, uint32_t* skipped) {
+  for (;;) {
+    uint32_t head = logHead.load(std::memory_order_acquire);
+    if (head - cursor > LOG_RING_SLOTS) {
+      *skipped += head - LOG_RING_SLOTS - cursor;
+      cursor = head - LOG_RING_SLOTS;
+    }
+    if (cursor == head) return false;
+
+    LogLineSlot& slot = logRing[cursor % LOG_RING_SLOTS];
+    uint32_t want = 2 * cursor + 2;
+    uint32_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq != want) {
+      // Behind: not written yet. Ahead: a writer lapped us on this slot.
+      if ((int32_t)(seq - want) < 0) return false;
+      cursor++;
+      (*skipped)++;
+      continue;
+    }
+
+    memcpy(&out, &slot.record, sizeof(out));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != seq) {
+      cursor++;
+      (*skipped)++;
+      continue;
+    }
+
+    cursor++;
+    return true;
+  }
+}
+
+// Oldest position still held by the ring, where a new reader starts
+inline uint32_t logOldest() {
+  uint32_t head = logHead.load(std::memory_order_acquire);
+  return head > LOG_RING_SLOTS ? head - LOG_RING_SLOTS : 0;
+}
+
+// "[12.345] W text\n", returns the length without the terminator
+inline size_t logFormat(const LogLine& record, char* out, size_t maxLen) {
+  static const char levels[] = "?EWID";
+  int length = snprintf(out, maxLen, "[%lu.%03lu] %c %.*s\n",
+                        (unsigned long)(record.ms / 1000), (unsigned long)(record.ms % 1000),
+                        levels[record.level <= LOG_LEVEL_DEBUG ? record.level : 0],
+                        (int)record.length, record.text);
+  return (size_t)constrain(length, 0, (int)maxLen - 1);
+}
+
+// Writes everything new to Serial. Only ever called from one place at a
+// time: the drain task, or directly when there is no task (before deep sleep).
+inline void logDrainSerial() {
+  static uint32_t cursor = 0;
+  LogLine record;
+  char line[LOG_FORMATTED_MAX];
+  uint32_t skipped = 0;
+
+  while (logRead(cursor, record, &skipped)) {
+    if (skipped > 0) {
+      logDropped.fetch_add(skipped, std::memory_order_relaxed);
+      Serial.printf("[log] %lu records dropped\n", (unsigned long)skipped);
+      skipped = 0;
+    }
+    Serial.write((const uint8_t*)line, logFormat(record, line, sizeof(line)));
+  }
+  if (skipped > 0) logDropped.fetch_add(skipped, std::memory_order_relaxed);
+}
+
+inline void logTask(void* parameters) {
+  while (1) {
+    logDrainSerial();
+    vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_INTERVAL_MS));
+  }
+}
+
+// Idle priority: the UART only gets time nothing else wants
+inline void logBegin() {
+  xTaskCreate(logTask, "Task Log Drain", 3072, NULL, tskIDLE_PRIORITY, &logTaskHandle);
+}
@@ -0,0 +1,18 @@
+// Generated by tools/build_dashboard.py from assets/, do not edit.
+// The files live in data/a/, upload data/ as the LittleFS image.
+#pragma once
+
+#include <Arduino.h>
+
+typedef struct DashboardAsset {
+  const char* url;
+  const char* path;  // gzipped file on LittleFS
+  const char* contentType;
+} DashboardAsset;
+
+constexpr DashboardAsset DASHBOARD_ASSETS[] = {
+  { "/a/icons.22a5f75e36.svg", "/a/icons.22a5f75e36.svg.gz", "image/svg+xml" },  // 1585 -> 448 bytes
+  { "/a/alarm.111229b0b2.wav", "/a/alarm.111229b0b2.wav.gz", "audio/wav" },  // 8044 -> 389 bytes
+};
+
+constexpr size_t DASHBOARD_ASSET_COUNT = sizeof(DASHBOARD_ASSETS) / sizeof(DASHBOARD_ASSETS[0]);
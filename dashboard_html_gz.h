@@ -0,0 +1,353 @@
+// Generated by tools/build_dashboard.py from dashboard.html, do not edit.
+// raw 24262 bytes, minified 18329 bytes, gzip 5455 bytes
+#pragma once
+
+#include <Arduino.h>
+
+#define DASHBOARD_HTML_GZ_ETAG "\"f333780107ab9f07\""
+
+constexpr size_t DASHBOARD_HTML_GZ_LEN = 5455;
+
+constexpr uint8_t DASHBOARD_HTML_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xc5, 0x3c, 0xed, 0x76, 0xdb, 0xb6,
+  0x92, 0xff, 0xf5, 0x14, 0x88, 0xda, 0x5b, 0x52, 0x8d, 0x44, 0x4b, 0x72, 0xec, 0x24, 0xf2, 0xc7,
+  0x5d, 0xc7, 0x76, 0x36, 0xbe, 0x1b, 0xdb, 0x39, 0x91, 0xb2, 0x3d, 0x3d, 0x3d, 0x3d, 0x0d, 0x24,
+  0x42, 0x16, 0x1a, 0x8a, 0xe4, 0x92, 0x90, 0x6d, 0x5d, 0xd7, 0xef, 0xb4, 0xcf, 0xb0, 0x4f, 0xb6,
+  0x33, 0x03, 0x90, 0x04, 0x29, 0xd2, 0x1f, 0xb7, 0xdd, 0xb3, 0x3d, 0xa9, 0x25, 0x02, 0x83, 0xc1,
+  0xcc, 0x60, 0xbe, 0x41, 0x7b, 0xff, 0xc5, 0xc9, 0xe5, 0xf1, 0xe4, 0xe7, 0x4f, 0xa7, 0x6c, 0xa1,
+  0x96, 0xc1, 0x61, 0x6b, 0x1f, 0x3f, 0x58, 0xc0, 0xc3, 0xab, 0x83, 0xb6, 0xf4, 0xdb, 0x38, 0x20,
+  0xb8, 0x0f, 0x1f, 0x4b, 0xa1, 0x38, 0x9b, 0x2d, 0x78, 0x92, 0x0a, 0x75, 0xd0, 0xfe, 0x32, 0x79,
+  0xdf, 0x7b, 0xd3, 0xce, 0x86, 0x43, 0xbe, 0x14, 0x07, 0xed, 0x6b, 0x29, 0x6e, 0xe2, 0x28, 0x51,
+  0x6d, 0x36, 0x8b, 0x42, 0x25, 0x42, 0x00, 0xbb, 0x91, 0xbe, 0x5a, 0x1c, 0xf8, 0xe2, 0x5a, 0xce,
+  0x44, 0x8f, 0x1e, 0xba, 0x4c, 0x86, 0x52, 0x49, 0x1e, 0xf4, 0xd2, 0x19, 0x0f, 0xc4, 0xc1, 0xc0,
+  0xeb, 0x23, 0x1a, 0x25, 0x55, 0x20, 0x0e, 0xc7, 0x4b, 0x9e, 0xa8, 0xe3, 0x20, 0x9a, 0x7d, 0xdb,
+  0xdf, 0xd2, 0x23, 0xad, 0xfd, 0x54, 0xad, 0xf1, 0x73, 0x94, 0x44, 0x91, 0x62, 0x77, 0xad, 0x5e,
+  0x6f, 0x16, 0x05, 0x51, 0xd2, 0x0b, 0xe4, 0xd5, 0x42, 0x89, 0x54, 0x8d, 0xd8, 0x77, 0x27, 0xdb,
+  0xef, 0x07, 0x27, 0xef, 0xf7, 0xca, 0x53, 0x30, 0xfe, 0x66, 0xe7, 0xe8, 0xed, 0x1b, 0x6b, 0x7c,
+  0x29, 0x7c, 0xb9, 0x5a, 0xc2, 0xc4, 0xce, 0xd1, 0xee, 0xf1, 0xce, 0xeb, 0x62, 0xc2, 0xe7, 0xc9,
+  0x37, 0x1c, 0x1e, 0xee, 0xbc, 0x7b, 0xf5, 0x0a, 0x87, 0xe7, 0x40, 0x7f, 0x6f, 0xce, 0x97, 0x32,
+  0x58, 0x8f, 0x98, 0x73, 0x06, 0xcc, 0x24, 0x4e, 0x97, 0xa5, 0xeb, 0x54, 0x89, 0x65, 0x6f, 0x25,
+  0xbb, 0xac, 0xc7, 0xe3, 0x38, 0x10, 0x3d, 0x3d, 0xd2, 0x65, 0xce, 0x58, 0x5c, 0x45, 0x82, 0x7d,
+  0x39, 0x03, 0xa8, 0xcf, 0xd1, 0x34, 0x52, 0x11, 0x40, 0xf3, 0x30, 0xed, 0xa5, 0x22, 0x91, 0xf3,
+  0xbd, 0xd6, 0x7d, 0xeb, 0x47, 0x20, 0x1d, 0x98, 0xbb, 0x92, 0xe1, 0x88, 0xf5, 0xf7, 0x5a, 0x31,
+  0xf7, 0x7d, 0x19, 0x5e, 0xd1, 0xf7, 0x69, 0x74, 0xdb, 0x4b, 0xe5, 0x3f, 0xe9, 0x71, 0x1a, 0x25,
+  0xbe, 0x48, 0x7a, 0x30, 0xb4, 0xd7, 0x2a, 0x11, 0x71, 0xcd, 0x13, 0xb7, 0x44, 0x57, 0x87, 0xb0,
+  0x8e, 0x46, 0xa9, 0x08, 0xc4, 0x4c, 0xc9, 0x28, 0x84, 0x0d, 0xa6, 0x7c, 0xf6, 0xed, 0x2a, 0x89,
+  0x56, 0xa1, 0xaf, 0x19, 0xcb, 0x96, 0x15, 0x5c, 0xc2, 0xaa, 0x9a, 0x99, 0x4c, 0x96, 0x84, 0x73,
+  0x1a, 0xf9, 0xeb, 0x47, 0x71, 0x59, 0x2b, 0x9a, 0x77, 0x0a, 0x64, 0x28, 0x7a, 0x0b, 0xa1, 0x4f,
+  0x63, 0xe0, 0xed, 0x22, 0x76, 0x4f, 0xce, 0x88, 0x54, 0xd2, 0x05, 0x18, 0x15, 0xcb, 0xbd, 0x56,
+  0x0e, 0x82, 0x0f, 0xd7, 0x22, 0x51, 0x12, 0x34, 0xa3, 0xc7, 0x61, 0x0f, 0x10, 0x56, 0xaf, 0xef,
+  0x0d, 0x86, 0x3b, 0x38, 0x03, 0x8b, 0xa7, 0x2b, 0xa5, 0x68, 0x79, 0x21, 0x3f, 0x6f, 0x27, 0x11,
+  0x4b, 0x36, 0x48, 0x10, 0x42, 0x4b, 0x6f, 0xc4, 0xc2, 0x28, 0x14, 0xd9, 0x53, 0x2f, 0xe1, 0x70,
+  0xea, 0x69, 0x06, 0x69, 0xc4, 0x7a, 0x63, 0xb6, 0xdc, 0xe9, 0xc3, 0x01, 0xcc, 0x56, 0x49, 0x8a,
+  0x2c, 0xc4, 0x91, 0xc4, 0x93, 0xde, 0x6b, 0xa9, 0x04, 0xce, 0x4e, 0xa2, 0x50, 0x47, 0x8c, 0x07,
+  0x01, 0x2c, 0xdd, 0x4e, 0x99, 0xe0, 0xa9, 0x28, 0xb6, 0xd8, 0x60, 0x97, 0xa5, 0x51, 0x20, 0x7d,
+  0x36, 0x8c, 0x6f, 0x2d, 0x4a, 0x7b, 0xd1, 0x4a, 0xa1, 0x14, 0xfe, 0x1a, 0x79, 0xfe, 0x6b, 0x7b,
+  0x8f, 0x16, 0x11, 0xc8, 0xf4, 0x51, 0x0a, 0xb4, 0x71, 0x14, 0xfb, 0xdf, 0x2c, 0xa4, 0x12, 0x84,
+  0x6e, 0x19, 0xf9, 0x3c, 0x80, 0xf5, 0xbe, 0x4c, 0xe3, 0x80, 0xaf, 0x33, 0xf1, 0xc6, 0x51, 0x26,
+  0xa2, 0xb9, 0xbc, 0x15, 0x3e, 0x48, 0x2d, 0x8a, 0x49, 0x9f, 0x03, 0x31, 0x57, 0xf4, 0x25, 0x3b,
+  0xe3, 0x7e, 0xff, 0x6f, 0xd6, 0x21, 0xd3, 0xd3, 0x26, 0x2d, 0xc9, 0xd5, 0x94, 0xbb, 0xfd, 0x2e,
+  0x33, 0xff, 0xbc, 0x9d, 0x4e, 0xb1, 0x79, 0xcf, 0xf8, 0x93, 0x5a, 0x26, 0x0c, 0xa1, 0xb9, 0x46,
+  0x0c, 0x2d, 0x55, 0xc8, 0x0f, 0x5f, 0xeb, 0x87, 0x21, 0xe8, 0x2d, 0x52, 0xb0, 0xe4, 0xb7, 0x3d,
+  0xf3, 0x0c, 0x4a, 0x80, 0x92, 0x2b, 0x18, 0xe2, 0x53, 0x10, 0xe8, 0x0a, 0xb1, 0x12, 0x4f, 0x3b,
+  0x08, 0xaf, 0xb9, 0xa2, 0xaf, 0xa4, 0x1e, 0xf3, 0x28, 0x01, 0x57, 0x42, 0x5f, 0x03, 0xae, 0x84,
+  0xdb, 0x83, 0x29, 0xf0, 0x0b, 0xf0, 0xd3, 0x26, 0x9c, 0x9c, 0x18, 0x90, 0x4d, 0x4a, 0x07, 0x46,
+  0x2e, 0xd0, 0x10, 0x6a, 0xf4, 0x70, 0x17, 0xf5, 0x50, 0xfb, 0x07, 0x30, 0x7e, 0x38, 0xbe, 0x65,
+  0x01, 0xd8, 0xac, 0x10, 0xb0, 0x0d, 0x92, 0xd1, 0x43, 0x81, 0xc4, 0xb9, 0x83, 0x29, 0x10, 0x24,
+  0xc6, 0x6c, 0x2c, 0xa0, 0x80, 0x4f, 0x45, 0xe9, 0x30, 0xa7, 0xe8, 0x6d, 0x37, 0xf6, 0xee, 0x37,
+  0xef, 0x9d, 0x2b, 0x4a, 0x86, 0x18, 0x0f, 0x27, 0x89, 0x02, 0xcb, 0xa8, 0xe9, 0x88, 0x2b, 0x26,
+  0x5a, 0xa8, 0xef, 0x20, 0xbe, 0x35, 0x0a, 0xbb, 0x61, 0x01, 0x9d, 0x87, 0xad, 0xd6, 0x08, 0x30,
+  0x63, 0x4b, 0x8b, 0x78, 0x0e, 0x71, 0x81, 0xf4, 0x3b, 0x67, 0x69, 0x1e, 0x08, 0x38, 0xce, 0xdf,
+  0x57, 0xa9, 0x92, 0xf3, 0x75, 0xa6, 0x3b, 0x7a, 0xb8, 0x27, 0x42, 0xd0, 0xd4, 0x2b, 0x1e, 0x67,
+  0x68, 0x0c, 0xdf, 0x74, 0xce, 0x99, 0xc0, 0xef, 0x5b, 0xff, 0x86, 0x4c, 0x72, 0xe6, 0x5a, 0x4a,
+  0xf2, 0x7a, 0xf7, 0x4d, 0x7c, 0xdb, 0x81, 0x6d, 0xbc, 0xab, 0x04, 0x48, 0xbf, 0x6b, 0xe1, 0x47,
+  0x0f, 0xbc, 0x7f, 0x8c, 0xc7, 0x8f, 0x4c, 0xac, 0x96, 0x21, 0x6a, 0xda, 0x3c, 0x41, 0x0c, 0xf7,
+  0xad, 0xfd, 0x2d, 0x13, 0xb9, 0xf6, 0xb7, 0x4c, 0x04, 0x45, 0xcf, 0x9a, 0x05, 0x34, 0x26, 0xfd,
+  0x83, 0x76, 0xc8, 0xaf, 0xa7, 0x3c, 0xe9, 0xd1, 0x00, 0x04, 0x41, 0x4f, 0x3f, 0x57, 0x05, 0xf9,
+  0x04, 0xcf, 0xd1, 0xb1, 0xc4, 0x8d, 0x7c, 0x95, 0x8d, 0x20, 0x3b, 0xd4, 0xc7, 0xfc, 0x86, 0x21,
+  0xa7, 0x30, 0x36, 0x8b, 0xfd, 0xc1, 0x50, 0x1b, 0x49, 0x1e, 0xc3, 0x18, 0x5f, 0xa9, 0x68, 0xef,
+  0x51, 0xa1, 0xa7, 0x31, 0x87, 0xc8, 0x3f, 0x15, 0xea, 0x46, 0x88, 0x70, 0xaf, 0x45, 0x4e, 0xbd,
+  0x07, 0x06, 0xbb, 0x04, 0x51, 0xcd, 0x84, 0x76, 0xb7, 0xc5, 0xd6, 0x41, 0x74, 0x15, 0x95, 0xad,
+  0x65, 0xb8, 0x69, 0x2b, 0xaf, 0xfb, 0xe4, 0x64, 0x14, 0xac, 0xed, 0x21, 0x7a, 0xe2, 0xba, 0xb7,
+  0xed, 0xed, 0x20, 0x7d, 0x65, 0xa7, 0xf0, 0x44, 0x97, 0x57, 0xf8, 0x0e, 0x50, 0xcd, 0x01, 0xf1,
+  0x59, 0x51, 0xc3, 0x57, 0x65, 0x11, 0x69, 0x0f, 0x9b, 0x6e, 0x2a, 0x9d, 0xa5, 0x59, 0x55, 0xe8,
+  0x47, 0xa2, 0xd6, 0xc3, 0x71, 0x6a, 0x1a, 0x05, 0x7e, 0x8d, 0x11, 0x3c, 0x27, 0x72, 0xd9, 0x1a,
+  0x09, 0x84, 0xb1, 0x59, 0xc0, 0xd3, 0x34, 0xd3, 0x41, 0x4c, 0xc1, 0x7c, 0x59, 0x19, 0xcc, 0x4e,
+  0xb1, 0x7e, 0x12, 0xcf, 0xaa, 0x5d, 0xca, 0xd8, 0x00, 0xa6, 0x16, 0xd2, 0x48, 0x0b, 0xd1, 0x18,
+  0x51, 0xd4, 0xcd, 0xb3, 0x72, 0xd8, 0x6a, 0xb3, 0x28, 0x9c, 0x05, 0x72, 0xf6, 0xed, 0xa0, 0x4d,
+  0x76, 0x7e, 0x19, 0x8b, 0xd0, 0x75, 0x78, 0xc0, 0xc1, 0xe3, 0xd0, 0x80, 0xd3, 0x69, 0x1f, 0x5e,
+  0x88, 0x1b, 0x76, 0x84, 0x43, 0xfb, 0x5b, 0x7a, 0x35, 0x5a, 0x9b, 0x26, 0x23, 0xfb, 0x80, 0x3d,
+  0x4a, 0x36, 0x87, 0x3c, 0x71, 0xc0, 0x9f, 0xb0, 0xdc, 0xec, 0x8a, 0xa1, 0x8a, 0xe5, 0xd5, 0xe8,
+  0x7f, 0xe5, 0xbc, 0xc9, 0xa7, 0xf8, 0x32, 0xd1, 0x29, 0x18, 0xa8, 0x34, 0xb9, 0x01, 0x33, 0x7e,
+  0x93, 0xa0, 0x36, 0xe0, 0xcf, 0x06, 0xc5, 0xdf, 0xb0, 0x96, 0x6c, 0x42, 0xab, 0xd1, 0xb0, 0xce,
+  0xe0, 0x30, 0x98, 0xcf, 0x83, 0xe8, 0x66, 0xc4, 0x16, 0xd2, 0xf7, 0xd1, 0xa6, 0x40, 0xd1, 0xd2,
+  0xd5, 0xb4, 0x67, 0x73, 0xf1, 0x98, 0x55, 0xd6, 0xec, 0x53, 0x62, 0xbc, 0x76, 0x93, 0x19, 0x4f,
+  0xfc, 0xa7, 0x25, 0x32, 0x9d, 0x67, 0xc9, 0x09, 0x36, 0xdd, 0xdb, 0x94, 0xfb, 0xa2, 0x88, 0x8c,
+  0x14, 0x9c, 0x73, 0xf7, 0x86, 0x36, 0x3a, 0x7c, 0x55, 0x63, 0xa3, 0xbb, 0xc5, 0xd8, 0xe3, 0xbe,
+  0x0e, 0x99, 0xc9, 0xa3, 0xf3, 0x03, 0x29, 0xd7, 0x53, 0xb3, 0x36, 0x43, 0xff, 0x5c, 0xaa, 0x4c,
+  0xca, 0x35, 0x3e, 0x6a, 0x50, 0x3e, 0xd0, 0xbe, 0x66, 0xa6, 0x5f, 0xef, 0x6d, 0x0a, 0x67, 0xf1,
+  0x2c, 0xce, 0x0a, 0x23, 0xb7, 0x0c, 0x31, 0xd7, 0x8d, 0x8a, 0x29, 0x97, 0xf4, 0xa6, 0xad, 0x2d,
+  0x02, 0xec, 0xcd, 0x8a, 0x89, 0xe4, 0x7f, 0xb3, 0x55, 0x68, 0x3f, 0x63, 0x11, 0x82, 0xcb, 0x69,
+  0xe7, 0x98, 0x41, 0x8e, 0x54, 0x24, 0x0e, 0xed, 0x11, 0x2d, 0xd9, 0xf6, 0xe1, 0x7f, 0x44, 0x21,
+  0x28, 0x82, 0x64, 0x9f, 0x57, 0x50, 0x4f, 0xf2, 0x10, 0x22, 0xe1, 0xb0, 0x64, 0x8c, 0x22, 0xbc,
+  0x96, 0x49, 0x14, 0x2e, 0x05, 0xfa, 0xb5, 0xcc, 0x1c, 0xed, 0x41, 0xa3, 0x73, 0xcf, 0x8c, 0x32,
+  0x1b, 0xd6, 0xd7, 0xa4, 0xe7, 0xe5, 0xa4, 0xf4, 0x9e, 0xf6, 0x86, 0xb0, 0xa0, 0x12, 0x39, 0xdb,
+  0xdc, 0x35, 0xd7, 0xd5, 0x26, 0x65, 0xae, 0xb5, 0xf1, 0x86, 0x50, 0xde, 0xa8, 0x48, 0x85, 0xa2,
+  0x97, 0xd2, 0x26, 0x2b, 0x3c, 0xbc, 0xd6, 0xe3, 0x4a, 0xdc, 0xaa, 0xac, 0x48, 0xca, 0x36, 0xb3,
+  0xdd, 0x7f, 0x9e, 0xa5, 0xc2, 0x92, 0x61, 0xfa, 0x74, 0xcb, 0x28, 0x44, 0x90, 0x57, 0x0e, 0x75,
+  0x09, 0xef, 0xcf, 0x6e, 0x0f, 0xd4, 0xb4, 0x63, 0xca, 0xd7, 0x05, 0xf7, 0xd1, 0x5b, 0xa0, 0x4e,
+  0xc3, 0x68, 0x43, 0xae, 0xaa, 0xb1, 0xf6, 0x30, 0x1b, 0xaa, 0xf3, 0x52, 0xb5, 0xe2, 0xdb, 0xf0,
+  0x84, 0x79, 0x36, 0xf3, 0xc6, 0xa2, 0xd7, 0x14, 0x95, 0x0f, 0xc5, 0xf8, 0x8d, 0x9c, 0xc2, 0x2c,
+  0xcd, 0x12, 0xe2, 0xc7, 0x32, 0x74, 0x1d, 0x81, 0x1f, 0xc9, 0x87, 0x11, 0xe1, 0x35, 0x0f, 0x56,
+  0xa2, 0xd7, 0x18, 0x53, 0xca, 0x2a, 0xf7, 0x14, 0x11, 0x34, 0x7a, 0x6f, 0x7b, 0xc3, 0x67, 0x7a,
+  0x31, 0x93, 0x1f, 0x3d, 0x9c, 0x68, 0xbd, 0xed, 0xdb, 0x9d, 0x8a, 0x57, 0xe8, 0xab, 0xb6, 0x87,
+  0x4f, 0x76, 0x45, 0xd5, 0x0a, 0x2c, 0x33, 0xb1, 0x30, 0xf2, 0x45, 0x5a, 0x1f, 0xad, 0x0c, 0x87,
+  0x69, 0x0e, 0xa7, 0x79, 0xc3, 0x3c, 0xcb, 0xd2, 0x83, 0xca, 0x5c, 0x49, 0x06, 0x35, 0xa7, 0x98,
+  0x33, 0xb0, 0x4d, 0xd9, 0xdd, 0xee, 0x03, 0x6e, 0xb2, 0xea, 0x79, 0x6c, 0xbf, 0x57, 0x21, 0x3b,
+  0x77, 0x80, 0xd5, 0xf1, 0xc3, 0x9a, 0x3c, 0xa8, 0x30, 0xa9, 0x8a, 0xff, 0x2d, 0x59, 0x04, 0xce,
+  0xa5, 0xd7, 0x57, 0xd9, 0x1c, 0xe9, 0x74, 0xa6, 0xdc, 0x80, 0x76, 0x95, 0x0a, 0xb6, 0x48, 0xc4,
+  0xfc, 0xa0, 0xbd, 0xc5, 0xb7, 0x70, 0x2c, 0xf5, 0x86, 0x43, 0xbe, 0x33, 0x7f, 0xbd, 0x23, 0xb6,
+  0x77, 0x3d, 0x58, 0xf8, 0xdd, 0x2c, 0x88, 0x56, 0x3e, 0x12, 0x00, 0xa0, 0xf0, 0x13, 0x86, 0x36,
+  0xc9, 0x20, 0x75, 0x6f, 0x1f, 0x7e, 0xfa, 0x74, 0x5e, 0x49, 0x94, 0x2a, 0x70, 0x15, 0x2d, 0x46,
+  0xda, 0xe2, 0x8d, 0xf9, 0x36, 0x49, 0x26, 0x8e, 0x02, 0x28, 0x96, 0xc1, 0xe7, 0x14, 0x01, 0x04,
+  0xcc, 0x34, 0x53, 0xfa, 0x1d, 0x0c, 0xdf, 0xb0, 0xbc, 0xd7, 0x83, 0xad, 0xe2, 0xcd, 0xfc, 0x6c,
+  0x83, 0x08, 0x44, 0x49, 0x09, 0xe5, 0x46, 0x8c, 0xb1, 0x92, 0x38, 0x9c, 0x2f, 0x22, 0x86, 0x92,
+  0x4b, 0xf1, 0xcf, 0x28, 0x14, 0x0f, 0xe5, 0x40, 0x25, 0xd3, 0x4a, 0x15, 0x64, 0xad, 0x8f, 0xc7,
+  0x91, 0xb2, 0xd2, 0xe9, 0x4d, 0xb3, 0xbd, 0x32, 0x65, 0xcb, 0x8c, 0x65, 0x1b, 0x8d, 0xe5, 0x21,
+  0xf5, 0xeb, 0x57, 0x30, 0x3d, 0xd1, 0x01, 0x36, 0x5a, 0x7f, 0x39, 0x23, 0xea, 0x3f, 0x56, 0x30,
+  0x0c, 0x9f, 0x50, 0xd1, 0x37, 0xfa, 0x89, 0xaa, 0x2d, 0x0f, 0xff, 0x6c, 0x42, 0xb2, 0x79, 0x62,
+  0xcd, 0x49, 0xc4, 0x3f, 0xf8, 0xd2, 0x24, 0x0e, 0x76, 0x46, 0x53, 0x3e, 0x0c, 0x0b, 0xde, 0x52,
+  0x90, 0x6c, 0xba, 0x7d, 0x78, 0x16, 0xfa, 0xf0, 0x99, 0x62, 0x4d, 0xff, 0xd3, 0xd9, 0xbb, 0x4e,
+  0xb3, 0xee, 0xcf, 0xb4, 0xe6, 0xe5, 0x38, 0x48, 0x73, 0x47, 0xf4, 0x2f, 0x07, 0x2f, 0xf4, 0x50,
+  0x97, 0x23, 0xb9, 0x1e, 0xd2, 0x63, 0x0a, 0xd1, 0x3c, 0x55, 0x45, 0x37, 0x46, 0xb7, 0x16, 0xec,
+  0x50, 0xae, 0x13, 0xab, 0xe6, 0x2e, 0x48, 0x29, 0x11, 0xb0, 0xd7, 0xd7, 0xa6, 0xe5, 0x9a, 0x06,
+  0xd4, 0x9a, 0xe7, 0x27, 0x4a, 0xb5, 0x1a, 0x67, 0x55, 0xa9, 0x26, 0xd5, 0x78, 0x42, 0xda, 0xd2,
+  0x50, 0xc4, 0x36, 0xb4, 0x95, 0x9e, 0x9a, 0x8b, 0x18, 0xde, 0xc2, 0x79, 0xf4, 0x9c, 0x74, 0x21,
+  0xa7, 0x3b, 0xc7, 0x80, 0x8a, 0x50, 0x35, 0x58, 0x6a, 0xb9, 0x3d, 0xd8, 0x5b, 0xd3, 0x6b, 0xb3,
+  0x04, 0xe1, 0x91, 0xd0, 0xaf, 0x81, 0x7d, 0xbe, 0x4e, 0x9f, 0x9e, 0x88, 0xf4, 0xbd, 0x37, 0x65,
+  0x3a, 0x81, 0x45, 0x3e, 0x0d, 0x04, 0xa6, 0xbc, 0x11, 0x56, 0x0d, 0x6a, 0x4d, 0x32, 0xb3, 0x20,
+  0x38, 0xe5, 0x9c, 0x4d, 0x9d, 0x87, 0xbe, 0x57, 0x66, 0xbc, 0x1c, 0x67, 0xcb, 0xa9, 0x47, 0xa6,
+  0x4c, 0x3d, 0x40, 0xa1, 0x4b, 0xcb, 0x4c, 0xe3, 0xb2, 0xd3, 0xda, 0x79, 0x28, 0x56, 0x5a, 0xba,
+  0xde, 0x6c, 0xba, 0x47, 0x40, 0xed, 0xb5, 0xd0, 0x25, 0x7a, 0x6a, 0x19, 0x71, 0x6e, 0x3b, 0x75,
+  0x11, 0x75, 0x63, 0xe2, 0x91, 0xa0, 0x51, 0x89, 0x1d, 0xb9, 0x6b, 0xa1, 0x2e, 0x41, 0x8e, 0x55,
+  0x3f, 0x55, 0xc2, 0xaf, 0xdd, 0x5c, 0x2e, 0x73, 0x61, 0xb5, 0x6f, 0xdb, 0x87, 0x63, 0xba, 0x63,
+  0x61, 0x13, 0x83, 0x79, 0xd3, 0x1b, 0x15, 0x0d, 0x56, 0x8a, 0x53, 0x1a, 0xdc, 0x9e, 0x33, 0x3d,
+  0xd2, 0x76, 0x99, 0x42, 0x0d, 0x88, 0x4b, 0xa2, 0x98, 0xae, 0x70, 0x28, 0xaa, 0x1e, 0xb4, 0xfb,
+  0xed, 0xc3, 0xe3, 0x85, 0x0c, 0xf9, 0xfe, 0x96, 0x1e, 0xdf, 0x00, 0x18, 0xb4, 0x0f, 0x3f, 0x44,
+  0xe1, 0x15, 0x83, 0xfa, 0xea, 0xaa, 0x11, 0x68, 0x68, 0xb9, 0xbd, 0x46, 0xa0, 0x6d, 0xf4, 0xaf,
+  0x31, 0x96, 0x66, 0x0d, 0x00, 0xaf, 0xb0, 0x8a, 0x4b, 0x44, 0x33, 0x86, 0x9d, 0xf6, 0xe1, 0x39,
+  0x1c, 0xd9, 0xfa, 0xa1, 0x5d, 0x76, 0x21, 0xe3, 0x58, 0xc8, 0x40, 0xc6, 0x31, 0x1c, 0x68, 0xda,
+  0x08, 0xf6, 0x1a, 0xc0, 0x78, 0x00, 0x0e, 0x45, 0x86, 0x92, 0x87, 0x6c, 0x22, 0x92, 0x44, 0xaa,
+  0x28, 0x59, 0x37, 0x2e, 0x78, 0x03, 0x67, 0xc3, 0x57, 0xbe, 0x64, 0x47, 0x09, 0x9f, 0x3e, 0xb0,
+  0xff, 0x5b, 0x80, 0x03, 0xcd, 0xe6, 0x31, 0x70, 0xd2, 0x2c, 0x54, 0x10, 0xfb, 0x64, 0xc1, 0x65,
+  0xc0, 0x43, 0xbf, 0x19, 0x08, 0x44, 0x3f, 0xe1, 0xf2, 0xe6, 0x01, 0x89, 0x0d, 0x40, 0xf0, 0xff,
+  0x29, 0x85, 0x0a, 0x31, 0x6e, 0xe5, 0x30, 0x5b, 0xfa, 0xb0, 0x6b, 0x83, 0x8e, 0xdd, 0xc8, 0xde,
+  0xec, 0x92, 0x3d, 0xa9, 0x3d, 0x06, 0x19, 0x53, 0x2a, 0x5c, 0xa7, 0xac, 0xfc, 0xd8, 0x22, 0x3b,
+  0xe6, 0xe1, 0x4c, 0x04, 0x56, 0x7f, 0xec, 0x79, 0xc8, 0x53, 0x7e, 0x2d, 0x32, 0xbd, 0x77, 0x3b,
+  0x28, 0xee, 0x6b, 0xd1, 0xdc, 0x6c, 0x2b, 0x5b, 0xa2, 0xd5, 0xac, 0xfb, 0x4b, 0xcc, 0xf0, 0x18,
+  0xd4, 0x50, 0x09, 0x66, 0x35, 0xfd, 0x1e, 0xb6, 0x43, 0xf2, 0xdc, 0x87, 0x48, 0xfd, 0xfe, 0x96,
+  0xfe, 0xde, 0xda, 0x97, 0x61, 0xbc, 0x52, 0x4c, 0xad, 0x63, 0xa1, 0xed, 0xb0, 0xdd, 0x6c, 0xa6,
+  0x45, 0xe8, 0x68, 0xd7, 0x9e, 0x5a, 0xdd, 0x66, 0x1f, 0xf1, 0x67, 0xc3, 0x6e, 0x50, 0xaf, 0x3f,
+  0xba, 0x9b, 0x4e, 0xcf, 0xd9, 0x92, 0xdf, 0x06, 0x22, 0xbc, 0x52, 0x0b, 0x30, 0xd0, 0x61, 0x9b,
+  0x81, 0x9f, 0x9f, 0x89, 0x05, 0x64, 0x74, 0x22, 0x39, 0x68, 0x13, 0xeb, 0xcc, 0xe4, 0xf1, 0x4f,
+  0xa5, 0xeb, 0xb3, 0x88, 0x41, 0x76, 0x05, 0x61, 0xe5, 0x23, 0xc2, 0xa8, 0x55, 0xc0, 0x96, 0xa8,
+  0x9e, 0x2d, 0xc4, 0xec, 0x1b, 0x94, 0xf8, 0x6d, 0xcb, 0x37, 0xb1, 0xf1, 0x2a, 0x2c, 0x50, 0x3d,
+  0x65, 0x11, 0x18, 0x0d, 0x3b, 0x8f, 0x9e, 0xb9, 0x08, 0xcc, 0x88, 0x4d, 0x56, 0xe2, 0x79, 0x8b,
+  0xc0, 0x9f, 0xb1, 0x9f, 0x84, 0xff, 0xbc, 0x45, 0xaf, 0x70, 0xa7, 0xc5, 0xea, 0x79, 0x8b, 0xc0,
+  0xef, 0xb1, 0xf7, 0x89, 0x7c, 0xde, 0xa2, 0x5d, 0x94, 0x9e, 0x7d, 0x10, 0x8d, 0x89, 0xe8, 0x5f,
+  0xe7, 0x13, 0x2a, 0x3d, 0xf3, 0x3f, 0xe9, 0x10, 0x20, 0x47, 0x20, 0x0d, 0x44, 0x67, 0xa0, 0x0d,
+  0xf2, 0x31, 0x77, 0x90, 0xce, 0x12, 0x19, 0x83, 0xe3, 0xdb, 0xda, 0x62, 0xe3, 0x45, 0x94, 0x28,
+  0x36, 0x15, 0x22, 0x66, 0xa9, 0x48, 0xae, 0x21, 0xd1, 0x99, 0x27, 0xd1, 0x92, 0xa9, 0x85, 0x60,
+  0xfa, 0x1d, 0x91, 0x2e, 0x0b, 0xa2, 0x28, 0x86, 0x71, 0x28, 0x3c, 0x20, 0xc7, 0x86, 0x20, 0x40,
+  0xd4, 0xb3, 0x04, 0xbc, 0x77, 0xda, 0xc2, 0xa2, 0x57, 0xb1, 0xa3, 0x8f, 0x47, 0x9f, 0xcf, 0x7f,
+  0x1b, 0x5f, 0x7e, 0xb9, 0x38, 0xf9, 0xed, 0x7c, 0xcc, 0x0e, 0xb0, 0xf4, 0xd2, 0xb9, 0x1c, 0xce,
+  0x12, 0xfc, 0x18, 0x73, 0x55, 0x98, 0x09, 0xd1, 0x55, 0x40, 0x7c, 0x88, 0x5c, 0x07, 0x8a, 0x66,
+  0x9a, 0xf2, 0x06, 0x83, 0xc1, 0x70, 0xf8, 0x76, 0xda, 0x9f, 0x0e, 0xbd, 0x1b, 0x7e, 0xed, 0x74,
+  0x30, 0x93, 0xcc, 0x96, 0x78, 0xb8, 0x3b, 0xac, 0x53, 0xc9, 0x4a, 0x50, 0xff, 0xd6, 0x42, 0x87,
+  0x7e, 0x24, 0x41, 0x9c, 0xab, 0x20, 0x80, 0x2c, 0x6e, 0x15, 0xea, 0xb7, 0x2e, 0x30, 0x07, 0x33,
+  0x02, 0x81, 0x14, 0xcb, 0x42, 0x35, 0x5b, 0x25, 0x09, 0xf8, 0x33, 0x5c, 0x06, 0xab, 0x80, 0x3e,
+  0xe0, 0xff, 0x5d, 0x12, 0xdd, 0x00, 0xe3, 0x29, 0x83, 0x3a, 0x1e, 0xeb, 0xf9, 0x55, 0xa8, 0x64,
+  0x40, 0xec, 0xc7, 0xfc, 0x0a, 0xca, 0x7b, 0x9e, 0xc2, 0xff, 0x3e, 0xe3, 0x8c, 0x84, 0xdd, 0x65,
+  0x61, 0xa4, 0x20, 0x0f, 0xb8, 0x62, 0x2a, 0x62, 0x7e, 0x84, 0x70, 0xa1, 0xbd, 0x03, 0x6e, 0xed,
+  0x76, 0xbc, 0x19, 0x57, 0xb3, 0x85, 0x0b, 0xdb, 0x1f, 0x1c, 0xb2, 0xbb, 0x7b, 0xbc, 0xc1, 0x0f,
+  0x04, 0x4f, 0x70, 0x5f, 0x38, 0x3d, 0xb7, 0xc2, 0x40, 0x89, 0xdd, 0x8c, 0xa5, 0x54, 0xa8, 0x0c,
+  0x5c, 0xa3, 0xb1, 0x37, 0xe1, 0x40, 0xa8, 0xdb, 0xe9, 0x56, 0xc4, 0x4e, 0x49, 0x6f, 0x2e, 0xa0,
+  0x8f, 0x90, 0x05, 0xa6, 0x80, 0xe8, 0x97, 0x5f, 0x2d, 0xa9, 0x7d, 0x86, 0x13, 0x4d, 0x51, 0x44,
+  0x46, 0x66, 0x8c, 0x81, 0x04, 0x40, 0xc9, 0xcc, 0x34, 0xbe, 0x4b, 0x14, 0x02, 0xd3, 0xf8, 0x26,
+  0x8d, 0x14, 0x7e, 0x57, 0xab, 0xc2, 0xbf, 0x9f, 0x4e, 0x98, 0x3e, 0x28, 0x16, 0x25, 0x6c, 0x72,
+  0xf9, 0xe9, 0xec, 0xf8, 0x37, 0xb3, 0xf3, 0xcf, 0x17, 0xc7, 0x84, 0x5c, 0x41, 0x20, 0xc5, 0xc6,
+  0xc9, 0x3a, 0x3f, 0x0c, 0x7d, 0xf2, 0x1a, 0x78, 0xfc, 0xe5, 0xdd, 0xf8, 0xf8, 0xf3, 0xd9, 0xbb,
+  0x53, 0x2d, 0x74, 0x7b, 0x6a, 0x72, 0x76, 0x8e, 0xa3, 0x83, 0xf2, 0xe8, 0xc9, 0x87, 0x09, 0x0c,
+  0x0e, 0xcb, 0x83, 0x9f, 0x2e, 0x3f, 0x7e, 0xfc, 0x32, 0x39, 0xbb, 0xbc, 0x40, 0xf5, 0x2a, 0x4f,
+  0x11, 0x35, 0x30, 0xfc, 0xaa, 0x66, 0x98, 0x88, 0x84, 0xb9, 0x9d, 0x0a, 0x4d, 0x17, 0x47, 0x9f,
+  0xc6, 0x1f, 0x2e, 0x71, 0x9f, 0xdd, 0xbd, 0x92, 0x16, 0x5f, 0x7e, 0xfa, 0xed, 0xcb, 0xa7, 0xf1,
+  0xe9, 0xe7, 0x89, 0x4d, 0x57, 0x3e, 0x75, 0x72, 0xfa, 0xf1, 0x74, 0x72, 0x6a, 0x53, 0x97, 0x4f,
+  0x7d, 0x3e, 0x35, 0x5b, 0xe5, 0xd4, 0x41, 0xf6, 0x3e, 0x84, 0x67, 0x97, 0x3c, 0x0d, 0x9d, 0xe2,
+  0x58, 0xa1, 0xd9, 0x98, 0x01, 0x38, 0x48, 0x7f, 0x8c, 0x6d, 0x0f, 0x77, 0xd8, 0x65, 0x4e, 0x1f,
+  0xf5, 0x1e, 0x8e, 0xe3, 0x84, 0xac, 0x8e, 0x29, 0xad, 0xa4, 0x27, 0x60, 0xcd, 0x5e, 0x18, 0xdd,
+  0x80, 0x12, 0xbc, 0x64, 0x54, 0xfe, 0x8e, 0xbf, 0x89, 0x9b, 0xf3, 0xb4, 0xcb, 0xd2, 0x45, 0x74,
+  0x03, 0xb6, 0xa8, 0x2c, 0x53, 0x75, 0x52, 0xf6, 0x65, 0x72, 0xcc, 0xa2, 0xf9, 0x1c, 0xd4, 0xc7,
+  0x43, 0x64, 0x93, 0x7c, 0x0e, 0xdc, 0x45, 0xb0, 0x06, 0xb5, 0x0a, 0xfd, 0x14, 0x94, 0x39, 0x5d,
+  0x87, 0x33, 0x86, 0x1e, 0x26, 0x0a, 0x43, 0x4c, 0x8c, 0x21, 0xbf, 0x02, 0xfb, 0x16, 0x21, 0x93,
+  0xa0, 0x34, 0xba, 0x17, 0x22, 0xe1, 0x4b, 0x94, 0x60, 0x47, 0x5d, 0xf8, 0x1e, 0x9d, 0xb2, 0xb5,
+  0x7d, 0x7e, 0xce, 0xf9, 0xf8, 0x17, 0x35, 0xbb, 0xa4, 0x7d, 0x69, 0xb2, 0x6f, 0xcd, 0x34, 0x58,
+  0x29, 0x92, 0x40, 0x4d, 0x25, 0x57, 0xc4, 0xd1, 0x6c, 0x81, 0x2c, 0xad, 0x32, 0x1c, 0x63, 0x31,
+  0x43, 0xd3, 0x2d, 0x6f, 0x68, 0xc0, 0x58, 0xcf, 0x12, 0xca, 0x5e, 0xab, 0x66, 0x73, 0x1b, 0x0d,
+  0xfb, 0x11, 0x6b, 0xab, 0x7e, 0xc5, 0x02, 0x0b, 0xba, 0x00, 0x83, 0x02, 0xbb, 0xd6, 0x84, 0x90,
+  0x05, 0xe5, 0x04, 0x5a, 0xe3, 0x54, 0x3f, 0xe2, 0x89, 0xc2, 0xa6, 0x0f, 0x1c, 0x4a, 0xf6, 0x64,
+  0x91, 0x93, 0xa9, 0x42, 0x2a, 0xe0, 0x13, 0xfd, 0xdf, 0x39, 0x57, 0x0b, 0x0f, 0x8a, 0xbc, 0x28,
+  0x71, 0x11, 0xd9, 0x16, 0x91, 0xd7, 0xc9, 0xc0, 0x7c, 0xcc, 0xa6, 0xb4, 0x93, 0xc4, 0x4d, 0x5c,
+  0xb3, 0xec, 0xc7, 0x0c, 0xca, 0x8f, 0x66, 0x2b, 0xec, 0x85, 0x7a, 0x57, 0x42, 0x9d, 0xa2, 0xcd,
+  0x85, 0xea, 0xdd, 0xfa, 0xcc, 0x77, 0x4d, 0x67, 0xa4, 0xe3, 0x49, 0x38, 0xcf, 0xe4, 0xc3, 0xe4,
+  0xfc, 0x23, 0x3b, 0xc0, 0xe2, 0x71, 0xe8, 0x22, 0x46, 0x84, 0x06, 0xc5, 0xf8, 0x10, 0xad, 0x92,
+  0xd4, 0xed, 0x20, 0xd1, 0xed, 0x51, 0x1b, 0x7e, 0x56, 0x01, 0xce, 0x65, 0xb8, 0x52, 0xe2, 0x41,
+  0x90, 0x31, 0x11, 0x84, 0x20, 0x46, 0xf4, 0x35, 0x0e, 0x2b, 0x17, 0x5c, 0x97, 0xc8, 0x86, 0x03,
+  0x23, 0x56, 0xff, 0xa6, 0x99, 0x20, 0x21, 0x83, 0x6a, 0x5e, 0x86, 0x82, 0xa5, 0x00, 0x04, 0x6a,
+  0x02, 0xe9, 0x11, 0x13, 0x50, 0xfb, 0xae, 0xc1, 0xab, 0xc6, 0x72, 0x06, 0xba, 0x2d, 0x04, 0xa9,
+  0xb5, 0xb6, 0xd5, 0x1f, 0x41, 0x85, 0xe7, 0x58, 0xa5, 0x30, 0x19, 0x32, 0x91, 0xc6, 0x03, 0x6f,
+  0x16, 0xc7, 0xc5, 0x39, 0x19, 0x1d, 0x9e, 0x64, 0x3e, 0x88, 0x8e, 0xab, 0xe4, 0x91, 0x40, 0x9a,
+  0x3f, 0x89, 0xe9, 0x98, 0x36, 0x73, 0x9d, 0x9b, 0x74, 0xb4, 0xb5, 0xe5, 0x00, 0x6f, 0x37, 0x12,
+  0x6a, 0xb1, 0x1b, 0x08, 0x30, 0xe0, 0xae, 0x01, 0x91, 0xb7, 0x88, 0xe0, 0x04, 0x5e, 0x32, 0x67,
+  0xeb, 0x26, 0x45, 0x5b, 0xcc, 0x51, 0x78, 0x53, 0x28, 0xfc, 0x92, 0xf5, 0x04, 0xf2, 0x07, 0xc0,
+  0xe6, 0xf0, 0x24, 0xe1, 0xeb, 0xe9, 0x6a, 0x3e, 0x17, 0x89, 0x63, 0x43, 0x45, 0x21, 0x84, 0x49,
+  0x74, 0xad, 0x39, 0x65, 0x96, 0xe2, 0x10, 0x63, 0xa8, 0x9c, 0xee, 0x80, 0xed, 0xef, 0x5b, 0xde,
+  0xaf, 0xc3, 0xfe, 0x28, 0x8d, 0x81, 0xef, 0xab, 0x0e, 0xe5, 0x9e, 0xaf, 0x3a, 0x41, 0xae, 0xa7,
+  0x76, 0x90, 0xbc, 0x5e, 0x89, 0x07, 0xb4, 0x7c, 0x17, 0x25, 0xf1, 0x45, 0x86, 0xea, 0xcd, 0x11,
+  0xf2, 0xe0, 0xfe, 0x52, 0xf1, 0xcf, 0x5d, 0x43, 0xe6, 0xaf, 0xfa, 0x90, 0x6c, 0xd6, 0x96, 0x22,
+  0x4d, 0x31, 0x1e, 0xda, 0xdc, 0xc1, 0x91, 0x85, 0xaa, 0x60, 0x11, 0xdf, 0x35, 0x2d, 0x74, 0x97,
+  0x43, 0xbd, 0x75, 0xa3, 0x41, 0x3c, 0xd0, 0x1f, 0x0e, 0x18, 0xd3, 0x1b, 0x09, 0x61, 0x11, 0xdc,
+  0x21, 0xcc, 0x90, 0x3a, 0x21, 0x25, 0x2e, 0x68, 0x04, 0xa2, 0xe0, 0xa9, 0xb0, 0xa4, 0x32, 0x6a,
+  0x15, 0xee, 0xe1, 0x62, 0xb5, 0x9c, 0x8a, 0x24, 0x5f, 0xf5, 0x4e, 0x5e, 0x9d, 0x85, 0x6a, 0xf7,
+  0x95, 0x3b, 0xe8, 0x52, 0x52, 0xd0, 0x81, 0x40, 0x98, 0xcd, 0xc1, 0xc4, 0xf6, 0xd0, 0x7d, 0x9b,
+  0x4d, 0xec, 0xb5, 0xa6, 0x90, 0x0e, 0x7d, 0xdb, 0xb3, 0xb1, 0x83, 0x7c, 0x47, 0x2d, 0xc8, 0x02,
+  0x20, 0x71, 0xbf, 0x88, 0x7c, 0xe1, 0xde, 0xb5, 0xd2, 0x20, 0x52, 0x23, 0x56, 0x26, 0x6a, 0xd0,
+  0xe9, 0xb6, 0xa4, 0x5f, 0x1d, 0x1d, 0xc2, 0xe8, 0x64, 0x64, 0xef, 0x36, 0xd8, 0x75, 0xb7, 0xcd,
+  0x6e, 0x64, 0xca, 0xdd, 0xd6, 0x87, 0xf2, 0x22, 0x00, 0xd8, 0xb1, 0x01, 0x5a, 0xf7, 0xb5, 0x54,
+  0xe5, 0x47, 0x3c, 0x6a, 0x36, 0xf1, 0xa2, 0xa9, 0x5f, 0x32, 0xf3, 0xea, 0x76, 0x99, 0x58, 0xea,
+  0xb6, 0x21, 0xdd, 0x18, 0x55, 0x02, 0x83, 0x2f, 0x66, 0xd2, 0x07, 0xe3, 0x22, 0xff, 0x5f, 0x4e,
+  0xef, 0xba, 0x45, 0x22, 0x44, 0xe1, 0x03, 0xd3, 0x1b, 0xb0, 0x42, 0xd5, 0xb2, 0x52, 0xac, 0xc6,
+  0x7d, 0x48, 0x07, 0x47, 0x2d, 0x4c, 0x26, 0x34, 0xec, 0x29, 0x2a, 0x03, 0x9d, 0x63, 0xed, 0xa2,
+  0x2c, 0x24, 0x9b, 0x25, 0xe3, 0x90, 0xc7, 0x10, 0xe3, 0xaa, 0x0b, 0xee, 0x2b, 0x8a, 0x39, 0xc3,
+  0x8c, 0x7a, 0xc3, 0xe8, 0x2c, 0x6f, 0x54, 0x75, 0x0f, 0x5d, 0x36, 0xd4, 0xbe, 0x14, 0x31, 0x6d,
+  0xfa, 0x0e, 0x2b, 0x42, 0x59, 0x5a, 0x82, 0x57, 0x4a, 0x88, 0x97, 0x82, 0x1a, 0x5e, 0x80, 0x1f,
+  0xb0, 0xa6, 0x73, 0x72, 0xe8, 0x26, 0x0c, 0xfd, 0x0b, 0x7e, 0xf1, 0x50, 0xbb, 0x00, 0xa9, 0x9c,
+  0x33, 0xf7, 0x05, 0xae, 0xd4, 0xca, 0x5e, 0xc6, 0x30, 0xa3, 0xa4, 0xdd, 0x20, 0x71, 0x1d, 0xc8,
+  0xd1, 0xd1, 0xff, 0x20, 0x94, 0x27, 0x11, 0xb0, 0x06, 0xa5, 0x99, 0xa6, 0x0a, 0xe1, 0x82, 0x53,
+  0xaa, 0xe0, 0x14, 0x77, 0x5a, 0x4e, 0xb6, 0xda, 0x52, 0x93, 0xaf, 0xff, 0x87, 0xd7, 0x5c, 0xf8,
+  0xce, 0x9d, 0x48, 0xb8, 0x5a, 0x25, 0xe2, 0x69, 0x97, 0x5d, 0xcf, 0xba, 0xe9, 0x62, 0xd6, 0xdd,
+  0x62, 0xfd, 0xad, 0x97, 0x86, 0xa8, 0x50, 0x11, 0x3f, 0x00, 0xba, 0x58, 0x2d, 0xa5, 0x2f, 0xd5,
+  0x3a, 0x83, 0xd3, 0x74, 0x7c, 0x6d, 0x0e, 0xb0, 0x4e, 0xe5, 0x52, 0xd1, 0xe9, 0x78, 0xa0, 0xa5,
+  0xa0, 0x20, 0xc7, 0x50, 0x15, 0xf9, 0x2e, 0x9d, 0x2c, 0xaa, 0x14, 0x89, 0xfd, 0xbf, 0x56, 0x10,
+  0xcb, 0x74, 0x87, 0x12, 0xc2, 0xbc, 0x53, 0x5c, 0x6a, 0x3b, 0x65, 0xcb, 0x75, 0xf4, 0x9b, 0x1b,
+  0x2c, 0x3f, 0x59, 0xe9, 0xef, 0xd5, 0x63, 0xa8, 0xf2, 0x57, 0x41, 0x44, 0x49, 0x05, 0xdd, 0x06,
+  0x90, 0xa6, 0x7a, 0x13, 0x0c, 0xe0, 0xce, 0xff, 0xfc, 0xf7, 0xb1, 0xf3, 0x10, 0xbe, 0x4c, 0x08,
+  0x8f, 0x20, 0xfb, 0x40, 0xc8, 0xfe, 0xe6, 0x98, 0xb8, 0xfd, 0x5e, 0x26, 0xe0, 0xec, 0xe7, 0x09,
+  0x2a, 0x1d, 0xea, 0x09, 0xc5, 0x6d, 0x63, 0x47, 0x5d, 0xb0, 0x19, 0xea, 0x8c, 0xa0, 0x37, 0x01,
+  0x95, 0xc6, 0x77, 0x15, 0x72, 0x0f, 0x82, 0x09, 0x2b, 0x94, 0x91, 0x53, 0x01, 0xe1, 0x5e, 0x14,
+  0x56, 0x56, 0x63, 0xec, 0x79, 0x48, 0xc9, 0x52, 0xbe, 0x03, 0xf6, 0x68, 0x10, 0xd0, 0x26, 0x96,
+  0x2d, 0x38, 0x64, 0xfd, 0x4e, 0x5d, 0x86, 0xd9, 0x18, 0x28, 0x4c, 0xc2, 0x1e, 0x2f, 0x6b, 0x1c,
+  0xea, 0x76, 0xee, 0x51, 0x9f, 0xed, 0x9b, 0x09, 0x21, 0xa4, 0xc3, 0xb7, 0x73, 0xf8, 0x8f, 0xfd,
+  0x9d, 0x39, 0x3d, 0x30, 0xe3, 0x11, 0x0e, 0x9b, 0xaa, 0x4c, 0x61, 0x95, 0x91, 0xd7, 0x26, 0x28,
+  0xef, 0x63, 0x90, 0xbc, 0xaa, 0x50, 0xf1, 0xc6, 0xe5, 0xea, 0xe5, 0xcb, 0xce, 0xb3, 0xd4, 0xb3,
+  0xa4, 0x68, 0x0e, 0x5e, 0x72, 0x24, 0xcc, 0xc5, 0x3d, 0x25, 0xe5, 0xe7, 0xf0, 0xb1, 0x5f, 0xec,
+  0x07, 0x8f, 0x2f, 0x5f, 0x76, 0x91, 0x9c, 0x97, 0x50, 0x10, 0xe1, 0x01, 0x3c, 0x1a, 0x22, 0xb9,
+  0xaa, 0x8d, 0x91, 0x88, 0x82, 0x0d, 0xea, 0x02, 0x25, 0xcd, 0x0c, 0x1f, 0x8b, 0x96, 0x04, 0xf5,
+  0x6a, 0x23, 0x64, 0xde, 0x1b, 0x09, 0x25, 0x45, 0x05, 0x6b, 0x2f, 0x84, 0xc3, 0xe4, 0x2a, 0x3f,
+  0x26, 0xab, 0xed, 0x50, 0x27, 0xcd, 0xea, 0x2e, 0x50, 0x7f, 0x6b, 0xbe, 0x4b, 0x2b, 0xb3, 0xe2,
+  0xb9, 0x4e, 0x6e, 0x05, 0x6a, 0x12, 0x5c, 0xde, 0x66, 0x48, 0xbd, 0x78, 0x95, 0x2e, 0x5c, 0x88,
+  0xa8, 0x20, 0x37, 0x1d, 0x1f, 0x71, 0x63, 0x14, 0x6c, 0x27, 0xdf, 0xe6, 0x2d, 0x6c, 0x5d, 0x23,
+  0xb3, 0x37, 0xc4, 0x65, 0xa9, 0x76, 0xd7, 0x38, 0x4d, 0x7b, 0xc0, 0xaa, 0xdd, 0x33, 0x21, 0xec,
+  0x99, 0x53, 0xd2, 0x97, 0x39, 0xae, 0x25, 0xa6, 0x93, 0xa3, 0x9f, 0x7f, 0xbb, 0x38, 0x3a, 0x3f,
+  0xc5, 0x5e, 0xcc, 0x2f, 0xce, 0x78, 0x15, 0x3a, 0x50, 0x61, 0x9e, 0x47, 0xf4, 0x31, 0x59, 0x09,
+  0xfc, 0xf8, 0x49, 0xf8, 0xf4, 0xb4, 0x58, 0xe1, 0xc7, 0xfb, 0x44, 0xe2, 0xc7, 0x98, 0x2b, 0xe7,
+  0x57, 0x2b, 0x04, 0x62, 0xe3, 0x92, 0xab, 0x13, 0x88, 0xfa, 0x2e, 0x76, 0x24, 0x91, 0x51, 0x34,
+  0x33, 0xba, 0x53, 0x43, 0xbd, 0xee, 0x00, 0x2d, 0xe0, 0x8f, 0x42, 0xe6, 0x5c, 0x86, 0x50, 0x7f,
+  0xee, 0x95, 0x67, 0x6f, 0x5f, 0xcf, 0x0b, 0x80, 0x53, 0x72, 0x14, 0x30, 0xe7, 0x20, 0xd9, 0x34,
+  0x96, 0x53, 0xe9, 0xcd, 0x65, 0xa0, 0xc0, 0xbc, 0x5d, 0xfc, 0xad, 0xa5, 0x2e, 0x93, 0x54, 0x2b,
+  0x13, 0x9a, 0x1f, 0x4c, 0x6e, 0x2b, 0x3b, 0x1d, 0xef, 0xf7, 0x48, 0x86, 0xae, 0xc3, 0x9c, 0x72,
+  0x99, 0x96, 0x08, 0x70, 0x6e, 0xa9, 0x22, 0x19, 0x8c, 0xc1, 0xe2, 0xad, 0xa4, 0xdb, 0x4c, 0x55,
+  0x93, 0x52, 0x6a, 0x41, 0x61, 0x02, 0xfc, 0x8e, 0x92, 0x78, 0x77, 0x07, 0xcf, 0xc6, 0xc0, 0x42,
+  0x9e, 0x9c, 0xe5, 0xa5, 0xdd, 0xba, 0x84, 0xba, 0x02, 0x06, 0x7a, 0x07, 0x1e, 0xa8, 0x74, 0x3e,
+  0xb9, 0x52, 0x55, 0x72, 0xef, 0x6c, 0xa5, 0xae, 0x1c, 0xca, 0x3c, 0x68, 0x31, 0x67, 0xb5, 0x95,
+  0x2e, 0xfa, 0x52, 0x6d, 0x85, 0x24, 0xa8, 0x5f, 0xcc, 0x10, 0xd8, 0xc3, 0xf6, 0x6e, 0xbf, 0xdf,
+  0x65, 0xc5, 0xf3, 0x6e, 0x1f, 0x0a, 0xab, 0x5d, 0x6b, 0x08, 0x9f, 0x7e, 0x6d, 0x79, 0x4b, 0x1e,
+  0xbb, 0x6e, 0xcc, 0x13, 0x65, 0xf7, 0x1d, 0xac, 0xe2, 0x93, 0xa6, 0x36, 0x5b, 0x10, 0x99, 0x94,
+  0x47, 0x4e, 0x56, 0xa7, 0xad, 0x06, 0xbb, 0x4c, 0xfa, 0x50, 0x9c, 0x6f, 0x0f, 0xb3, 0x3d, 0xe0,
+  0xe1, 0x0d, 0x1d, 0x0f, 0x7d, 0x99, 0x07, 0xfc, 0x4a, 0x7f, 0xd3, 0xf7, 0xb2, 0xba, 0x4d, 0xde,
+  0xd5, 0x4f, 0x05, 0x8f, 0xb5, 0x46, 0x51, 0xb0, 0x78, 0xb7, 0xe1, 0x4b, 0xc8, 0x4c, 0x8d, 0x34,
+  0xbb, 0x2d, 0xec, 0x87, 0x8c, 0x2a, 0x82, 0xda, 0xf0, 0x00, 0x96, 0x83, 0x81, 0x25, 0x48, 0x61,
+  0xad, 0x7b, 0xda, 0x85, 0x49, 0x11, 0xd2, 0xb5, 0xee, 0xa8, 0x5a, 0x8e, 0x10, 0xc0, 0xeb, 0x0e,
+  0x28, 0xde, 0xa0, 0xc3, 0x5e, 0x80, 0x12, 0x77, 0x5b, 0xc4, 0xc8, 0x88, 0x74, 0x68, 0x22, 0x6e,
+  0xd5, 0x09, 0x31, 0x92, 0xb8, 0x1d, 0x4f, 0xb3, 0x54, 0xad, 0xaa, 0x08, 0x9f, 0x3e, 0x65, 0xed,
+  0x51, 0xd9, 0xdb, 0x6e, 0xbd, 0xc1, 0x77, 0x3a, 0xad, 0xfb, 0x92, 0x1e, 0xd4, 0xe6, 0xca, 0x96,
+  0x3a, 0x37, 0xf9, 0xbe, 0x41, 0xc5, 0xf5, 0x51, 0xc7, 0xb4, 0xbc, 0xe5, 0x8e, 0x89, 0x90, 0x38,
+  0x75, 0x50, 0x6d, 0x5a, 0xe1, 0x1e, 0x00, 0x99, 0x67, 0xf4, 0xfa, 0x4c, 0x90, 0x34, 0x5c, 0x52,
+  0x71, 0x3f, 0x07, 0xba, 0x95, 0x93, 0x59, 0xb6, 0x6e, 0x22, 0xa6, 0x26, 0x80, 0x63, 0x7f, 0x94,
+  0x2d, 0x44, 0x22, 0xd8, 0x5a, 0xa8, 0xcc, 0x9d, 0x62, 0x96, 0x89, 0xa5, 0x6f, 0xce, 0x40, 0xaf,
+  0x6c, 0x32, 0x1d, 0x76, 0x78, 0x78, 0x88, 0x3d, 0x23, 0xda, 0x4d, 0x43, 0x83, 0xe4, 0xd9, 0x1f,
+  0x7f, 0x98, 0xb5, 0x87, 0xe4, 0x4b, 0xf4, 0x7f, 0xe5, 0x7d, 0x79, 0x00, 0xb9, 0xb3, 0xbf, 0xce,
+  0x5a, 0x96, 0x16, 0x06, 0x38, 0xbb, 0x01, 0xf2, 0x05, 0x40, 0xe7, 0x32, 0x4d, 0x21, 0xf3, 0x88,
+  0x42, 0xd1, 0xb5, 0xba, 0x65, 0x3a, 0x57, 0x01, 0x1f, 0x43, 0x29, 0x8c, 0xee, 0xea, 0xf2, 0x39,
+  0xfe, 0xe2, 0x4a, 0x89, 0xb8, 0xd6, 0xa6, 0x83, 0xb1, 0x05, 0xa4, 0x59, 0xa4, 0x34, 0xbd, 0xa2,
+  0xbc, 0xbb, 0x45, 0x78, 0xd9, 0x70, 0xea, 0xf4, 0x90, 0x7b, 0x3d, 0x1a, 0x2a, 0xba, 0xbc, 0x98,
+  0xf4, 0x03, 0xf5, 0xd2, 0xaf, 0x3f, 0x32, 0xdd, 0x9d, 0xcc, 0x63, 0x8e, 0x46, 0xd5, 0x10, 0x77,
+  0x76, 0x3b, 0xa5, 0xed, 0x3d, 0xc8, 0x36, 0x15, 0xec, 0xd7, 0x65, 0x53, 0xbd, 0x1d, 0x6e, 0xd5,
+  0x63, 0x53, 0x4f, 0xfa, 0x45, 0xf4, 0x79, 0x62, 0xa0, 0xe1, 0xd4, 0x43, 0xcc, 0x55, 0xb7, 0x50,
+  0x1f, 0x2d, 0x73, 0xab, 0xc0, 0xc4, 0xec, 0x2f, 0x25, 0xc1, 0xe3, 0xab, 0x09, 0x5d, 0xf6, 0x0d,
+  0x2f, 0x1b, 0xe6, 0x42, 0xcd, 0x48, 0xe4, 0xba, 0xe1, 0x2e, 0x15, 0x4b, 0xf1, 0x2c, 0x14, 0xe9,
+  0x8e, 0x4c, 0x41, 0x8f, 0xc0, 0xe0, 0x6e, 0x15, 0x2d, 0x2e, 0x1a, 0xd8, 0x76, 0x47, 0x9b, 0xde,
+  0x18, 0x2b, 0x7a, 0x8d, 0x49, 0xa5, 0xb7, 0xdd, 0xd2, 0xf7, 0x15, 0xae, 0x06, 0x3b, 0xa4, 0x60,
+  0x55, 0x58, 0x12, 0x9d, 0xc4, 0x0d, 0x87, 0x6d, 0x89, 0x10, 0xf7, 0xab, 0xee, 0x70, 0xff, 0x9d,
+  0xa0, 0x0f, 0xbe, 0xbf, 0xa3, 0xcf, 0xfb, 0xaf, 0x5d, 0x7a, 0x47, 0x03, 0x6b, 0x24, 0xf0, 0x24,
+  0x77, 0x2d, 0xe7, 0x68, 0x36, 0x13, 0xb1, 0x72, 0x46, 0xcc, 0x21, 0x85, 0xd3, 0x8d, 0xa3, 0xad,
+  0xdf, 0x53, 0x88, 0xac, 0x58, 0x4f, 0x76, 0x34, 0x29, 0xd8, 0xef, 0xc8, 0xf1, 0xc3, 0x5e, 0x1e,
+  0x02, 0xb8, 0xd9, 0x49, 0x14, 0x91, 0x1d, 0x7f, 0xcd, 0x01, 0x50, 0x60, 0x7f, 0x8d, 0x9b, 0xb7,
+  0x43, 0xb0, 0x4d, 0x62, 0xf8, 0xa2, 0x51, 0x94, 0x81, 0xd6, 0x82, 0xa4, 0xce, 0x00, 0x73, 0x96,
+  0x09, 0xb8, 0x38, 0x2e, 0xf2, 0xdc, 0xc7, 0xd4, 0xcd, 0x4f, 0xd9, 0x12, 0xe8, 0x37, 0xb7, 0x37,
+  0x20, 0x4d, 0x52, 0xf3, 0x24, 0xc1, 0x97, 0x40, 0x38, 0xe9, 0x7e, 0x08, 0x6a, 0xa9, 0xf5, 0x3e,
+  0x5b, 0xff, 0x67, 0xb3, 0x10, 0x24, 0x37, 0x8f, 0x7e, 0xf4, 0x5b, 0x22, 0x9d, 0x0e, 0xab, 0x33,
+  0x23, 0xbb, 0xdb, 0x5a, 0x86, 0x2f, 0x02, 0x43, 0xd1, 0xc9, 0xfb, 0xe1, 0x87, 0xe2, 0xc1, 0x23,
+  0xb3, 0x87, 0xd0, 0x85, 0xfd, 0xd2, 0x83, 0xa2, 0xbd, 0xe7, 0x5d, 0x7e, 0x3a, 0xbd, 0xa8, 0xe4,
+  0x07, 0x36, 0x71, 0xb9, 0x0a, 0x14, 0xd5, 0xe5, 0x03, 0xa5, 0x7c, 0xf5, 0xbd, 0x17, 0x47, 0x7b,
+  0x58, 0xfd, 0x50, 0xca, 0xb0, 0x2d, 0x1b, 0xa3, 0xc8, 0x5b, 0x98, 0xf4, 0xd7, 0xcd, 0x77, 0x74,
+  0xf4, 0xab, 0x61, 0xdf, 0xdf, 0x69, 0x6b, 0x37, 0x91, 0x08, 0xab, 0x03, 0xac, 0x0d, 0x9c, 0xf2,
+  0x7b, 0x47, 0xce, 0x7d, 0xfb, 0xb0, 0x0e, 0x43, 0x38, 0x8f, 0x6a, 0xca, 0xf6, 0xa7, 0xbe, 0x94,
+  0x8a, 0x6f, 0xd1, 0x95, 0xeb, 0xf4, 0x34, 0xe6, 0x61, 0x79, 0x0b, 0x7d, 0xcd, 0x9e, 0x51, 0x89,
+  0x4f, 0xf7, 0x00, 0x0c, 0x60, 0xb5, 0xd0, 0x79, 0x61, 0xdf, 0x08, 0xa1, 0xaf, 0xb4, 0xbf, 0xbf,
+  0xb3, 0x72, 0x4a, 0x8d, 0x9a, 0x32, 0xcb, 0x02, 0xf7, 0x66, 0x4f, 0xa0, 0xf4, 0x9e, 0x55, 0x1d,
+  0xd7, 0xd9, 0x5b, 0xae, 0xd5, 0x5f, 0xbe, 0x62, 0x0f, 0xbc, 0xf5, 0xd5, 0x6e, 0xe5, 0x17, 0xa8,
+  0x2a, 0xba, 0xba, 0x0a, 0x8c, 0xdf, 0xcc, 0xf8, 0x95, 0xfe, 0x7d, 0xe7, 0x49, 0xd2, 0xac, 0x39,
+  0x46, 0x90, 0x44, 0x40, 0x47, 0x89, 0x5f, 0x7a, 0x29, 0x10, 0xba, 0xc0, 0x63, 0xac, 0x08, 0xfc,
+  0xaf, 0xe5, 0xc1, 0x07, 0xcb, 0x50, 0xff, 0x2a, 0x0f, 0x2a, 0x01, 0x12, 0xab, 0x04, 0x96, 0x5a,
+  0x34, 0x5f, 0xb3, 0xc4, 0xd0, 0xdc, 0x52, 0xd1, 0x5b, 0x15, 0xe0, 0x37, 0xc0, 0x59, 0xc3, 0x1a,
+  0xa8, 0xf2, 0xc1, 0x4f, 0x75, 0xc1, 0x63, 0x63, 0xc5, 0xbf, 0xe4, 0xc9, 0xb7, 0x55, 0x6c, 0x19,
+  0x4a, 0xa9, 0xfb, 0x70, 0x14, 0x04, 0xae, 0x63, 0xbf, 0xc8, 0x07, 0xb5, 0x2a, 0xa8, 0xc4, 0x29,
+  0xc7, 0x1b, 0x53, 0x1a, 0xc8, 0x0a, 0x80, 0x3b, 0x9d, 0x79, 0x79, 0x88, 0xfb, 0xd8, 0xfc, 0x06,
+  0xa4, 0x6d, 0x69, 0xbf, 0xc8, 0x5f, 0x3d, 0x82, 0xd8, 0x33, 0x25, 0x62, 0x25, 0x24, 0xc5, 0x91,
+  0x71, 0x37, 0x99, 0x35, 0x42, 0xc4, 0xb4, 0x5c, 0xbe, 0xa3, 0x5d, 0xbe, 0x83, 0x3e, 0x1e, 0x7c,
+  0xca, 0x22, 0x82, 0x64, 0xd0, 0xf9, 0x74, 0x39, 0x9e, 0x38, 0xdd, 0xa7, 0xfa, 0xfc, 0x6e, 0xcb,
+  0x31, 0x84, 0xf5, 0xf0, 0x76, 0xa0, 0x21, 0x2e, 0x74, 0xe9, 0x17, 0xf8, 0x47, 0xec, 0x1f, 0xe3,
+  0xcb, 0x0b, 0x2f, 0xa5, 0x4c, 0x5c, 0xce, 0xd7, 0x86, 0x28, 0x22, 0x1d, 0x04, 0x7a, 0x81, 0x56,
+  0x11, 0x04, 0x6b, 0x8a, 0x93, 0xe6, 0x1e, 0x76, 0x16, 0x2d, 0xc1, 0x7d, 0xe3, 0xab, 0x9e, 0xe8,
+  0xaa, 0xf9, 0xe6, 0xb5, 0x26, 0x79, 0x6f, 0xdd, 0x5b, 0xdc, 0xf0, 0xb7, 0x9a, 0x55, 0x3b, 0xab,
+  0xdb, 0x10, 0x50, 0xf1, 0xe2, 0x40, 0x71, 0x4f, 0xa1, 0xaf, 0x1d, 0x1b, 0x1b, 0x1d, 0x96, 0x6b,
+  0xe8, 0x78, 0xba, 0xa1, 0x86, 0x57, 0x45, 0xfd, 0x7e, 0x3b, 0xcb, 0x3d, 0x75, 0x11, 0xf0, 0x28,
+  0x0a, 0xed, 0x2f, 0x0c, 0x8e, 0x2c, 0x6c, 0xae, 0xcd, 0xdd, 0x61, 0xbe, 0x76, 0x53, 0x73, 0xbe,
+  0xb3, 0xde, 0xea, 0xa4, 0xf7, 0x3a, 0x46, 0xf4, 0x46, 0x07, 0x38, 0x4a, 0x4b, 0x8d, 0x60, 0xb6,
+  0x28, 0x21, 0xff, 0x80, 0x44, 0x10, 0x4b, 0x48, 0x78, 0xd0, 0xbb, 0x65, 0xed, 0x58, 0xe2, 0x15,
+  0x72, 0xcc, 0x17, 0x44, 0x4b, 0x9e, 0x57, 0x1a, 0x25, 0x29, 0xb4, 0xe7, 0x8e, 0xa4, 0x62, 0x0a,
+  0x9a, 0xae, 0x46, 0x7a, 0xff, 0x50, 0x37, 0xa8, 0x46, 0x48, 0x07, 0xac, 0xdd, 0x7e, 0x74, 0x45,
+  0x49, 0x26, 0xd5, 0x25, 0x4f, 0x10, 0x45, 0x83, 0x08, 0x3c, 0x23, 0x21, 0xec, 0x92, 0xf3, 0x20,
+  0x45, 0xfe, 0x1b, 0x5f, 0x46, 0xa9, 0xd1, 0x12, 0xdb, 0x3b, 0x4a, 0xbf, 0x50, 0x15, 0x7d, 0x4f,
+  0x50, 0x49, 0x68, 0xa1, 0xd0, 0xad, 0x4b, 0x67, 0x0f, 0xac, 0x74, 0xf6, 0x85, 0x99, 0x6f, 0x16,
+  0x37, 0x96, 0x9b, 0xba, 0xde, 0x2b, 0x62, 0x8f, 0x11, 0x7f, 0x36, 0x64, 0x9d, 0x45, 0x36, 0xa4,
+  0x0b, 0xd2, 0xbc, 0xae, 0x7b, 0x51, 0x76, 0xcb, 0x76, 0x13, 0xc9, 0xf2, 0x95, 0x48, 0x3f, 0xb1,
+  0xeb, 0x02, 0xe9, 0xe2, 0xd6, 0xf8, 0x9d, 0xb2, 0x9b, 0xd0, 0xe0, 0xff, 0x6f, 0x7e, 0x02, 0xe4,
+  0x81, 0xa4, 0x01, 0x07, 0xe4, 0x2b, 0x9e, 0x6e, 0xed, 0x9a, 0xd9, 0xfc, 0x57, 0x75, 0xb1, 0x02,
+  0xa3, 0x87, 0x33, 0xdf, 0xb0, 0xd9, 0xa4, 0x8e, 0x19, 0x94, 0x47, 0x21, 0xc9, 0x33, 0xaf, 0x35,
+  0x63, 0x1f, 0x91, 0xfe, 0x34, 0x81, 0x53, 0x41, 0x7e, 0x6c, 0xae, 0x60, 0xfe, 0x34, 0x76, 0xfc,
+  0x2b, 0x16, 0x84, 0xdc, 0xdc, 0xcc, 0x9a, 0xe0, 0x56, 0x7f, 0xe9, 0x48, 0xed, 0x5e, 0xba, 0x5e,
+  0x84, 0x7c, 0x19, 0xb6, 0xd0, 0x77, 0x21, 0xa8, 0x87, 0xd9, 0x6f, 0x0f, 0xa7, 0xae, 0x63, 0xb4,
+  0x1a, 0xe1, 0x4b, 0xb0, 0xcd, 0x5b, 0xd3, 0xbb, 0xd5, 0xe6, 0xf5, 0xa8, 0xfd, 0x2d, 0xf3, 0xf7,
+  0x01, 0xb6, 0xf4, 0x1f, 0xe2, 0xf9, 0x5f, 0x2a, 0xc7, 0x6d, 0x52, 0x99, 0x47, 0x00, 0x00,
+};
@@ -2,16 +2,201 @@
 #include <esp_now.h>
 #include <WiFi.h>
 #include <WiFiManager.h>
-#include <WebSocketsServer.h>
 #include <ESPAsyncWebServer.h>
 #include <ESPmDNS.h>
+#include <Preferences.h>
+#include <esp_sntp.h>
+#include <esp_timer.h>
 #include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <rom/crc.h>
+#include <algorithm>
+#include <atomic>
 
-#define MAX_ALARM 5
+#include "dashboard_html_gz.h"
+#include "dashboard_assets.h"
+#include "clock_log.h"
+
+#define MAX_ALARM 256
 #define PIN_POLLUTION 17
 
+// MQ-2 sampling pipeline: 50 Hz -> median-of-5 -> 32-tap moving average
+#define MQ2_SAMPLE_PERIOD_MS 20
+#define MQ2_MEDIAN_WINDOW 5
+#define MQ2_AVERAGE_WINDOW 32
+#define MQ2_ADC_MAX 4095
+#define MQ2_WARMUP_MS 20000
+#define MQ2_CALIBRATION_SAMPLES 256    // averaged Rs in clean air gives R0
+#define MQ2_CLEAN_AIR_RATIO_X100 983   // Rs/R0 in clean air, MQ-2 datasheet
+#define MQ2_PUBLISH_DELTA_PPM 5
+#define MQ2_PUBLISH_DELTA_PCT 5
+#define MQ2_PUBLISH_MAX_INTERVAL_MS 10000
+
+#define UTC_OFFSET_SEC 25200           // WIB (UTC+7), default until one is saved in NVS
+#define UTC_OFFSET_MIN_SEC -43200
+#define UTC_OFFSET_MAX_SEC 50400
+#define TIME_VALID_EPOCH 1600000000    // anything earlier means NTP has not synced yet
+#define TIME_DRIFT_CHECK_MS 10000
+#define TIME_DRIFT_THRESHOLD_MS 250
+#define NTP_SERVER_1 "id.pool.ntp.org"
+#define NTP_SERVER_2 "time.google.com"
+#define NTP_SERVER_3 "pool.ntp.org"
+#define NTP_SYNC_INTERVAL_MS 3600000
+#define NTP_STALE_MS (3 * NTP_SYNC_INTERVAL_MS)  // missed this many syncs, report stale
+
+#define SECONDS_PER_DAY 86400
+#define ALARM_TIME_INVALID UINT32_MAX
+#define ALARM_GRACE_SEC 60             // how late an already handled second may still ring
+#define ALARM_RECHECK_MS 60000         // longest scheduler sleep, bounds alarmCheckedThrough staleness
+#define ALARM_STEP_MAX_SEC 3600        // clock steps up to this size resume from alarmCheckedThrough
+#define ALARM_NONE 0xffff              // free list terminator
+#define ALARM_ENABLED 0x01             // AlarmItem.flags
+#define ALARM_DAYS_ALL 0x7f            // bit 0 = Sunday .. bit 6 = Saturday
+#define ALARM_LABEL_MAX_LEN 32         // same as the dashboard input maxlength
+#define ALARM_LABELS 192               // distinct labels, identical labels share one
+#define ALARM_LABEL_ARENA 4096         // bytes shared by all distinct labels
+#define ALARM_NO_LABEL 0xff
+#define ALARM_FIRE_BATCH 8             // alarms published per scheduler pass
+#define ALARM_PAGE_DEFAULT 32          // GET /alarm page size
+#define ALARM_PAGE_MAX 64
+#define ALARM_JOURNAL_LEN 16           // revisions a reconnecting client can catch up on
+
+// ESP-NOW sensor frame, must match esp2.cpp
+#define SENSOR_FRAME_VERSION 2
+#define SENSOR_FRAME_MAX_SAMPLES 8
+#define SENSOR_SEQ_REORDER_WINDOW 16   // older seq within this window = duplicate
+#define MAX_SENSOR_NODES 32
+#define SENSOR_NODE_TIMEOUT_MS 600000  // nodes silent this long are evicted
+#define ESPNOW_RX_QUEUE_LEN 16         // power of two
+
+// Telemetry WebSocket (/ws). Every frame is [topic][payload], little-endian.
+// A client sends [TOPIC_SUBSCRIBE, mask] to choose which topics it gets.
+#define TOPIC_SUBSCRIBE 0
+#define TOPIC_TIME 1       // i64 epoch ms, i32 UTC offset seconds
+#define TOPIC_DHT 2        // u8 node slot, u8 sensor id, i16 temperature x10, u16 humidity x10
+#define TOPIC_POLLUTION 3  // u16 MQ-2 reading in ppm (LPG curve)
+#define TOPIC_ALARM 4      // u16 alarm id that is ringing
+#define TOPIC_ALARM_SYNC 5 // u32 revision, u8 op, then for ALARM_OP_UPSERT / ALARM_OP_DELETE
+                           // u16 id, u32 seconds, u8 days, u8 flags, u8 label length, label.
+                           // Client -> device: u32 last revision seen, to catch up.
+#define TOPIC_SNAPSHOT 6   // sent once on connect, not subscribable: i64 epoch ms (0 = not synced),
+                           // i32 UTC offset, u16 ppm (0xffff = none yet), u8 node count, per node
+                           // u8 slot, u8 sensor id, i16 T x10, u16 H x10, then u32 alarm revision,
+                           // u16 alarm count, per alarm the TOPIC_ALARM_SYNC entry from u16 id on.
+#define TOPIC_MASK(topic) (1 << (topic))
+#define TOPIC_MASK_ALL (TOPIC_MASK(TOPIC_TIME) | TOPIC_MASK(TOPIC_DHT) | TOPIC_MASK(TOPIC_POLLUTION) | TOPIC_MASK(TOPIC_ALARM) | TOPIC_MASK(TOPIC_ALARM_SYNC))
+#define MAX_WS_CLIENTS 8
+#define MAX_WS_FRAME 64
+#define SNAPSHOT_ATTEMPTS 3  // sizing races with alarm and node changes, then the clock alone
+
+// Per-client backpressure. Every topic but the TOPIC_ALARM and
+// TOPIC_ALARM_SYNC events carries state, so a slow client is only owed the
+// newest value of each: a publish lands in a latest-value slot per key and
+// sets that key's pending bit on each subscriber, and bits are drained
+// while the client's AsyncWebSocket queue has room. A client that cannot
+// take a frame for WS_STALL_TIMEOUT_MS is disconnected.
+#define TELEMETRY_KEY_TIME 0  // re-encoded when sent, never stale
+#define TELEMETRY_KEY_POLLUTION 1
+#define TELEMETRY_KEY_DHT 2  // + node slot
+#define TELEMETRY_KEYS (TELEMETRY_KEY_DHT + MAX_SENSOR_NODES)
+#define TELEMETRY_LATEST_MAX 16  // largest coalesced frame, topic byte included
+#define WS_SERVICE_INTERVAL_MS 100
+#define WS_STALL_TIMEOUT_MS 15000
+#define TELEMETRY_QUEUE_LEN 16  // TOPIC_ALARM and TOPIC_ALARM_SYNC frames waiting for taskTelemetry
+
+// Task layout. WiFi, lwIP and AsyncTCP run on PRO_CPU, so taskTelemetry,
+// the one task that writes to clients, joins them there. Sensing,
+// scheduling and aggregation share APP_CPU and reach the network only
+// through telemetryPublish(), which hands over and returns.
+// Priorities are deadline-monotonic: each task's deadline is how late its
+// work may run before it is wrong or lost, see deadlinePriority().
+#define CORE_NET 0
+#define CORE_APP 1
+#define DEADLINE_AIR_POLLUTION_MS MQ2_SAMPLE_PERIOD_MS  // a late sample skews the median
+#define DEADLINE_SENSOR_CONSUMER_MS 50     // ESPNOW_RX_QUEUE_LEN frames of headroom in a burst
+#define DEADLINE_TELEMETRY_MS WS_SERVICE_INTERVAL_MS
+#define DEADLINE_ALARM_SCHEDULER_MS 1000   // alarms have one-second resolution
+#define DEADLINE_UPDATE_TIME_MS TIME_DRIFT_CHECK_MS
+#define DEADLINE_STORAGE_MS 60000          // RAM holds the truth, flash may lag
+
+// Section timers for GET /metrics, in CPU cycles. HTTP paths are timed
+// around the request handler, POST paths around the body parser as well.
+// ws_publish is only the hand-off to taskTelemetry, ws_send the pass in
+// which taskTelemetry writes to the clients.
+#define METRIC_ESPNOW_RECV 0
+#define METRIC_WS_PUBLISH 1
+#define METRIC_HTTP_DASHBOARD 2
+#define METRIC_HTTP_ALARM_GET 3
+#define METRIC_HTTP_ALARM_POST 4
+#define METRIC_HTTP_DELETE 5
+#define METRIC_HTTP_NODES 6
+#define METRIC_HTTP_CLIENTS 7
+#define METRIC_HTTP_HISTORY 8
+#define METRIC_HTTP_METRICS 9
+#define METRIC_HTTP_TIME_GET 10
+#define METRIC_HTTP_TIME_POST 11
+#define METRIC_HTTP_ASSET 12
+#define METRIC_HTTP_LOGS 13
+#define METRIC_WS_SEND 14
+#define METRIC_TIMERS 15
+
+// POST bodies are reassembled into a fixed pool of slots, one per request
+// in flight, and parsed in place; no heap is touched per request.
+#define BODY_SLOTS 4
+#define BODY_MAX 512          // larger bodies get 413
+#define BODY_JSON_CAPACITY 384
+
+#define ALARM_OP_UPSERT 1
+#define ALARM_OP_DELETE 2
+#define ALARM_OP_RESYNC 3  // too far behind, reload GET /alarm
+
+// Time-series history, three resolutions per metric. Each tier is a ring
+// of fixed 6-byte records, so the whole store is
+// HISTORY_METRICS * HISTORY_RECORDS_PER_METRIC * 6 bytes (~48 KB).
+//
+// T and H are one series each for all sensor nodes: a bucket averages
+// every sample received in it and its min/max span the nodes. One series
+// per node would cost 2 * HISTORY_RECORDS_PER_METRIC * 6 bytes (~32 KB)
+// for each of up to MAX_SENSOR_NODES nodes, while the per-node readings
+// are already live in /nodes and TOPIC_DHT.
+#define HISTORY_METRIC_T 0    // temperature x10, all nodes merged
+#define HISTORY_METRIC_H 1    // humidity x10, all nodes merged
+#define HISTORY_METRIC_PPM 2  // MQ-2 ppm
+#define HISTORY_METRICS 3
+#define HISTORY_TIERS 3
+#define HISTORY_TIER_1S_LEN 600    // 1 s buckets, last 10 minutes
+#define HISTORY_TIER_1M_LEN 1440   // 1 min buckets, last day
+#define HISTORY_TIER_15M_LEN 672   // 15 min buckets, last week
+#define HISTORY_RECORDS_PER_METRIC (HISTORY_TIER_1S_LEN + HISTORY_TIER_1M_LEN + HISTORY_TIER_15M_LEN)
+#define HISTORY_PERSIST_TIER 2     // 15 min buckets are logged to flash and survive reboots
+#define HISTORY_PERSIST_QUEUE 16   // closed buckets waiting for taskStorage
+#define HISTORY_GAP INT16_MIN      // record delta for a bucket without samples
+#define HISTORY_VALUE_MIN -16384   // samples are clamped to this range, so every
+#define HISTORY_VALUE_MAX 16383    // delta and min/max distance fits a record exactly
+#define HISTORY_JSON_BATCH 16      // points decoded per lock hold
+#define HISTORY_JSON_POINT_MAX 52  // ",[4294967295,-2147483648,...]" plus terminator
+
+// Append-only storage log on LittleFS. Fixed-size CRC-checked records;
+// the index file lets boot seek straight to live alarms and the tail.
+#define LOG_PATH "/log.bin"
+#define LOG_COMPACT_PATH "/log.new"
+#define LOG_INDEX_PATH "/log.idx"
+#define LOG_INDEX_TMP_PATH "/log.idx.new"
+#define LOG_RECORD_SIZE 128
+#define LOG_MAGIC 0x4c47
+#define LOG_ALARM 1            // alarm slot set
+#define LOG_ALARM_DELETE 2     // alarm slot cleared
+#define LOG_HISTORY 3          // batch of closed history buckets
+#define LOG_HISTORY_BATCH 10   // buckets per history record
+#define LOG_NO_RECORD UINT32_MAX
+#define LOG_INDEX_INTERVAL 16  // appends between index rewrites, bounds the tail scan
+#define LOG_COMPACT_BYTES 65536
+
+// Worst case for one rendered alarm: every label byte escaped as \u00XX
+#define ALARM_JSON_RECORD_MAX (96 + 6 * ALARM_LABEL_MAX_LEN)
+
 /* ===== Constant Definitions ==== */
-const String COUNTRY_CODES[13] = {
+const char* const COUNTRY_CODES[13] = {
   "cn",  // China
   "hk",  // Hong Kong
   "id",  // Indonesia
@@ -27,16 +212,299 @@ const String COUNTRY_CODES[13] = {
   "vn",  // Vietnam
 };
 
-typedef struct SensorData {
-  float T;
-  float H;
-} SensorData;
-
+typedef struct __attribute__((packed)) SensorSample {
+  uint16_t dt;  // offset from frame timestamp, x100 ms
+  int16_t T;    // x10
+  uint16_t H;   // x10
+} SensorSample;
+
+typedef struct __attribute__((packed)) SensorFrame {
+  uint8_t version;
+  uint8_t sensorId;
+  uint16_t boot;       // random per sensor power-on, seq restarts at 0 with a new one
+  uint16_t seq;
+  uint32_t timestamp;  // sender millis() of the first sample
+  uint8_t count;
+  SensorSample samples[SENSOR_FRAME_MAX_SAMPLES];
+} SensorFrame;
+
+#define SENSOR_FRAME_HEADER_LEN offsetof(SensorFrame, samples)
+
+// Channel discovery, first byte never collides with SENSOR_FRAME_VERSION
+#define ESPNOW_MSG_PROBE 0xF0
+#define ESPNOW_MSG_ACK 0xF1
+
+typedef struct __attribute__((packed)) DiscoveryFrame {
+  uint8_t type;       // ESPNOW_MSG_PROBE / ESPNOW_MSG_ACK
+  uint8_t channel;    // channel the probe was sent on, echoed in the ACK
+  uint8_t target[6];  // ACK: MAC of the probing sensor
+} DiscoveryFrame;
+
+typedef struct SensorNode {
+  uint8_t mac[6];
+  uint8_t sensorId;
+  int8_t rssi;
+  SensorSample latest;
+  uint32_t lastSeenMs;
+  uint16_t boot;
+  uint16_t lastSeq;
+  uint32_t framesReceived;
+  uint32_t framesLost;
+  uint32_t restarts;
+} SensorNode;
+
+// Raw ESP-NOW frame as copied out of the WiFi task
+typedef struct EspNowRxFrame {
+  uint8_t mac[6];
+  int8_t rssi;
+  int len;  // length as received, may exceed sizeof(data)
+  uint8_t data[sizeof(SensorFrame)];
+} EspNowRxFrame;
+
+typedef struct WsSubscriber {
+  uint32_t clientId;        // 0 = free slot
+  uint8_t topics;           // TOPIC_MASK bits
+  uint64_t pending;         // TELEMETRY_KEY bits the client has not been sent yet
+  uint32_t stalledSinceMs;  // 0 = keeping up
+  uint32_t sent;
+  uint32_t coalesced;       // values replaced before they went out
+  uint32_t dropped;         // TOPIC_ALARM_SYNC frames refused by a full queue
+} WsSubscriber;
+
+// A frame that cannot be coalesced, on its way to taskTelemetry
+typedef struct TelemetryFrame {
+  uint8_t length;  // topic byte included
+  uint8_t data[MAX_WS_FRAME];
+} TelemetryFrame;
+
+typedef struct RequestBody {
+  AsyncWebServerRequest* owner;  // NULL = free slot
+  size_t length;
+  int result;                    // body handler outcome, read by the request handler
+  char data[BODY_MAX + 1];       // +1 for the terminator
+} RequestBody;
+
+// Cycle counts are per core, so a section whose task migrates midway can
+// show up as one outlier in max, never in a crash
+typedef struct MetricTimer {
+  uint32_t count;
+  uint32_t maxCycles;
+  uint64_t totalCycles;
+} MetricTimer;
+
+static_assert(TELEMETRY_KEYS <= 64, "pending keys must fit WsSubscriber::pending");
+
+// One alarm table slot. The slot number is the alarm id.
 typedef struct AlarmItem {
-  int8_t index;
-  char label[100];
-  char time[10];
+  uint32_t seconds;  // time as seconds since local midnight, ALARM_TIME_INVALID = free slot
+  uint16_t next;     // free list link while the slot is free
+  uint8_t label;     // alarmLabels entry, ALARM_NO_LABEL = none
+  uint8_t days;      // weekdays it repeats on, 0 = rings once
+  uint8_t flags;     // ALARM_ENABLED
 } AlarmItem;
+
+// Interned label, the text lives in alarmLabelArena
+typedef struct AlarmLabel {
+  uint16_t offset;
+  uint8_t length;
+  uint16_t refs;  // alarms using it, 0 = free entry
+} AlarmLabel;
+
+// An alarm with its label copied out, as the API and the storage log see it
+typedef struct __attribute__((packed)) AlarmEntry {
+  uint32_t seconds;
+  uint8_t days;
+  uint8_t flags;
+  char label[ALARM_LABEL_MAX_LEN + 1];
+} AlarmEntry;
+
+// Scheduler pass result for one due alarm
+typedef struct AlarmFired {
+  uint16_t slot;
+  bool ring;          // false for a second handled before and now more than ALARM_GRACE_SEC ago
+  uint32_t revision;  // non-zero when firing changed the alarm (one-shot disabled)
+} AlarmFired;
+
+// Resumable GET /logs state, one per request
+typedef struct LogStreamWriter {
+  uint32_t cursor;   // next ring position to read
+  uint32_t skipped;  // overwritten while streaming
+  size_t length;
+  size_t sent;
+  char line[LOG_FORMATTED_MAX];
+} LogStreamWriter;
+
+// Resumable GET /alarm serializer state, one per request
+typedef struct AlarmJsonWriter {
+  int next;         // next alarm slot to look at, MAX_ALARM = closing, beyond = done
+  int remaining;    // alarms left on this page
+  uint32_t revision;  // alarmRevision when the listing started
+  bool first;
+  size_t length;    // bytes pending in record
+  size_t sent;      // bytes of record already handed out
+  char record[ALARM_JSON_RECORD_MAX];
+} AlarmJsonWriter;
+
+// Delta-encoded history bucket. avg is the running sum of deltas from the
+// tier base; min and max are stored as distances from avg.
+typedef struct __attribute__((packed)) HistoryRecord {
+  int16_t delta;   // avg change from the previous data record, HISTORY_GAP = empty
+  uint16_t below;  // avg - min
+  uint16_t above;  // max - avg
+} HistoryRecord;
+
+typedef struct HistoryTier {
+  uint32_t step;  // bucket width, seconds
+  uint16_t capacity;
+  HistoryRecord* records;
+  uint32_t seq;          // records ever pushed, the newest is seq - 1
+  uint16_t count;        // records held, the oldest is seq - count
+  uint16_t dataCount;    // held records that are not gaps
+  int32_t base;          // avg before the oldest record
+  int32_t last;          // avg of the newest data record
+  uint32_t lastStart;    // bucket start of the newest record
+  uint32_t openStart;    // bucket still collecting samples
+  uint16_t openCount;    // 0 = no open bucket
+  int32_t openMin;
+  int32_t openMax;
+  int32_t openSum;
+} HistoryTier;
+
+typedef struct HistoryPoint {
+  uint32_t time;
+  int32_t min;
+  int32_t avg;
+  int32_t max;
+} HistoryPoint;
+
+// Resumable GET /history serializer state, one per request. The cursor
+// carries its own running avg, so resuming never re-walks the ring.
+typedef struct HistoryJsonWriter {
+  uint8_t metric;
+  uint8_t tier;
+  uint32_t from;
+  uint32_t to;
+  bool started;
+  bool done;        // ring and open bucket decoded
+  bool closed;      // closing "]}" queued
+  bool comma;       // a point has been rendered
+  uint32_t cursor;  // seq of the next record to decode
+  int32_t value;    // avg before cursor
+  size_t length;
+  size_t sent;
+  char record[HISTORY_JSON_BATCH * HISTORY_JSON_POINT_MAX];
+} HistoryJsonWriter;
+
+typedef struct __attribute__((packed)) LogAlarm {
+  uint16_t slot;
+  AlarmEntry entry;
+} LogAlarm;
+
+typedef struct __attribute__((packed)) LogHistoryBucket {
+  uint32_t start;
+  uint8_t metric;
+  int16_t min;
+  int16_t avg;
+  int16_t max;
+} LogHistoryBucket;
+
+typedef struct __attribute__((packed)) LogRecord {
+  uint16_t magic;  // LOG_MAGIC, anything else is erased or torn flash
+  uint8_t type;    // LOG_ALARM / LOG_ALARM_DELETE / LOG_HISTORY
+  uint8_t count;   // LOG_HISTORY: buckets used
+  uint32_t seq;
+  union {
+    LogAlarm alarm;
+    LogHistoryBucket buckets[LOG_HISTORY_BATCH];
+    uint8_t payload[LOG_RECORD_SIZE - 12];
+  };
+  uint32_t crc;  // crc32 of everything above
+} LogRecord;
+
+static_assert(sizeof(LogRecord) == LOG_RECORD_SIZE, "LogRecord must stay one fixed-size record");
+
+// Checkpoint of the log, rewritten every LOG_INDEX_INTERVAL appends
+typedef struct LogIndex {
+  uint32_t length;         // bytes of log covered by this index
+  uint32_t seq;            // next record seq
+  uint32_t historyOffset;  // first record worth replaying for history
+  uint32_t alarmOffset[MAX_ALARM];  // latest LOG_ALARM per slot, LOG_NO_RECORD = empty
+  uint32_t crc;
+} LogIndex;
+
+// MQ-2 LPG sensitivity curve, { Rs/R0 x256, ppm }, log-spaced from the
+// datasheet fit ppm = 10^((log10(Rs/R0) - 1.31) / -0.47)
+const uint16_t MQ2_PPM_CURVE[][2] = {
+  { 64, 11701 }, { 82, 6934 }, { 105, 4109 }, { 134, 2435 },
+  { 171, 1443 }, { 219, 855 }, { 280, 507 }, { 358, 300 },
+  { 458, 178 }, { 585, 105 }, { 749, 62 }, { 957, 37 },
+  { 1224, 22 }, { 1565, 13 }, { 2002, 8 }, { 2560, 5 },
+};
+
+// Median of the last N samples. N is tiny, so sorting a copy on the
+// stack is cheaper than maintaining an ordered structure.
+template <size_t N>
+class MedianFilter {
+public:
+  uint16_t push(uint16_t value) {
+    window[pos] = value;
+    pos = (pos + 1) % N;
+    if (count < N) count++;
+
+    uint16_t sorted[N];
+    for (size_t i = 0; i < count; i++) {
+      size_t j = i;
+      for (; j > 0 && sorted[j - 1] > window[i]; j--) sorted[j] = sorted[j - 1];
+      sorted[j] = window[i];
+    }
+    return sorted[count / 2];
+  }
+
+private:
+  uint16_t window[N] = { 0 };
+  size_t pos = 0;
+  size_t count = 0;
+};
+
+// Running mean over the last N samples, N a power of two
+template <size_t N>
+class MovingAverage {
+  static_assert((N & (N - 1)) == 0, "MovingAverage window must be a power of two");
+
+public:
+  uint16_t push(uint16_t value) {
+    sum += value;
+    sum -= window[pos];
+    window[pos] = value;
+    pos = (pos + 1) & (N - 1);
+    if (count < N) count++;
+
+    return sum / count;
+  }
+
+private:
+  uint16_t window[N] = { 0 };
+  uint32_t sum = 0;
+  size_t pos = 0;
+  size_t count = 0;
+};
+
+const char* const HISTORY_METRIC_NAMES[HISTORY_METRICS] = { "T", "H", "ppm" };
+const uint8_t HISTORY_METRIC_SCALE[HISTORY_METRICS] = { 10, 10, 1 };
+const uint32_t HISTORY_TIER_STEP[HISTORY_TIERS] = { 1, 60, 900 };
+const uint16_t HISTORY_TIER_LEN[HISTORY_TIERS] = { HISTORY_TIER_1S_LEN, HISTORY_TIER_1M_LEN, HISTORY_TIER_15M_LEN };
+
+// Shorter deadline, higher priority. All of these stay below the WiFi and
+// lwIP tasks, which keep the radio alive for everyone.
+constexpr UBaseType_t deadlinePriority(uint32_t deadlineMs) {
+  return deadlineMs <= 20 ? 5 : deadlineMs <= 100 ? 4 : deadlineMs <= 1000 ? 3 : deadlineMs <= 10000 ? 2 : 1;
+}
+
+const char* const METRIC_TIMER_NAMES[METRIC_TIMERS] = {
+  "espnow_recv", "ws_publish", "GET /", "GET /alarm", "POST /alarm", "POST /delete",
+  "GET /nodes", "GET /clients", "GET /history", "GET /metrics",
+  "GET /time", "POST /time", "GET /a/", "GET /logs", "ws_send"
+};
 /* ===== Constant Definitions ==== */
 
 
@@ -44,19 +512,121 @@ typedef struct AlarmItem {
 // FreeRTOS
 void taskUpdateTime(void* parameters);
 void taskAirPollutionSensor(void* parameters);
+void taskAlarmScheduler(void* parameters);
+void taskSensorConsumer(void* parameters);
+void taskTelemetry(void* parameters);
+
+// MQ-2
+uint32_t mq2ResistanceQ8(uint16_t raw);
+uint16_t mq2Ppm(uint32_t ratioQ8);
+
+// Clock
+void clockInit();
+void onTimeSync(struct timeval* tv);
+size_t encodeTimeSync(uint8_t* payload);
+int64_t clockTargetUs();
+const char* clockStatus();
+
+// Alarm Table
+void alarmInit();
+void alarmBuildFreeList();
+int alarmAlloc();
+void alarmFree(int slot);
+bool alarmSet(int slot, const AlarmEntry& entry);
+void alarmClear(int slot);
+bool alarmGet(int slot, AlarmEntry& entry);
+int alarmNextUsed(int from);
+int alarmLabelIntern(const char* label, size_t length);
+void alarmLabelRelease(uint8_t label);
+void alarmLabelCompact();
+
+// Alarm Scheduler
+uint32_t parseAlarmTime(const char* time);
+time_t alarmNextFire(uint32_t seconds, uint8_t days, time_t now);
+void alarmHeapPush(uint16_t slot);
+uint16_t alarmHeapPop();
+void alarmScheduleAll(time_t now);
+int alarmFireDue(time_t now, AlarmFired* fired, int maxFired);
+
+// Alarm Sync
+uint32_t alarmJournal(uint16_t slot);
+size_t encodeAlarmEvent(uint8_t* payload, uint32_t revision, int slot);
+size_t encodeAlarmEntry(uint8_t* out, int slot);
+void alarmPublish(uint32_t revision, int slot);
+void alarmCatchUp(AsyncWebSocketClient* client, uint32_t lastRevision);
+
+// History
+void historyInit();
+void historyAdd(uint8_t metric, uint32_t time, int32_t value);
+void historyPush(HistoryTier* tier, uint32_t start, bool hasData, int32_t avg, int32_t min, int32_t max);
+void historyAppend(HistoryTier* tier, uint32_t start, bool hasData, int32_t avg, int32_t min, int32_t max);
+void historyRestore(const LogHistoryBucket& bucket);
+int historyDecode(HistoryJsonWriter& writer, HistoryPoint* points, int maxPoints);
+size_t fillHistoryJson(HistoryJsonWriter& writer, uint8_t* buffer, size_t maxLen);
+
+// Storage
+void taskStorage(void* parameters);
+void storageInit();
+void storageReplay();
+bool storageReadRecord(File& file, uint32_t offset, LogRecord& record);
+void storageApply(const LogRecord& record, uint32_t offset);
+uint32_t storageAppend(LogRecord& record);
+void storageWriteIndex();
+void storageFlushAlarms();
+void storageCollectHistory();
+void storageCompact();
+void storageAlarmChanged(int slot);
+void storageAlarmDirty(int slot);
 
 // ESP-NOW
 void OnDataRecv(const esp_now_recv_info_t* info, const uint8_t* incomingData, int len);
+int handleSensorFrame(const EspNowRxFrame* rx);
+void replyProbe(const EspNowRxFrame* rx);
+uint64_t macKey(const uint8_t* mac);
+int sensorNodeSlot(uint64_t key, uint32_t now);
+void sensorNodeEvictStale(uint32_t now);
 
 // Web Server
-void webSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length);
+void onTelemetryEvent(AsyncWebSocket* ws, AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len);
+bool telemetrySend(AsyncWebSocketClient* client, uint8_t topic, const uint8_t* payload, size_t len);
+void telemetryPublish(uint8_t topic, const uint8_t* payload, size_t len);
+int telemetryKey(uint8_t topic, const uint8_t* payload, size_t len);
+void telemetryFlush(AsyncWebSocketClient* client);
+void telemetryService();
+void telemetryBroadcast(const TelemetryFrame& frame);
+WsSubscriber* wsSubscriberFind(uint32_t clientId);
+void telemetrySnapshot(AsyncWebSocketClient* client);
+bool encodeSnapshot(uint8_t* frame, size_t& length);
 
 void webGetAlarm();
+void webGetNodes();
+void webGetClients();
+void webGetMetrics();
+void webGetTime();
+void webSetTime();
+void webGetLogs();
+size_t fillLogStream(LogStreamWriter& writer, uint8_t* buffer, size_t maxLen);
+void parseSetTime(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t total);
+void webGetHistory();
+size_t jsonEscape(char* out, const char* in, size_t inMax);
+size_t renderAlarmJson(char* out, int slot, bool first);
+size_t fillAlarmJson(AlarmJsonWriter& writer, uint8_t* buffer, size_t maxLen);
 void webAddAlarm();
 void webDeleteAlarm();
 void parseNewAlarm(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t total);
 void parseDeleteAlarm(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t total);
+RequestBody* bodyAppend(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t total);
+RequestBody* bodyFind(AsyncWebServerRequest* req);
+int bodyTake(AsyncWebServerRequest* req);
+void bodyRelease(AsyncWebServerRequest* req);
+const char* bodyError(int result, const char* fallback);
 void webDashboard();
+void webAssets();
+
+// Metrics
+void metricTimerRecord(int timer, uint32_t startCycles);
+ArRequestHandlerFunction metricTimed(int timer, ArRequestHandlerFunction handler);
+ArBodyHandlerFunction metricTimedBody(int timer, ArBodyHandlerFunction handler);
 
 void startWebServer();
 /* ===== Function Definitions ==== */
@@ -66,20 +636,96 @@ void startWebServer();
 // FreeRTOS TaskHandle
 TaskHandle_t taskHandleUpdateTime;
 TaskHandle_t taskHandleAirPollutionSensor;
+TaskHandle_t taskHandleAlarmScheduler;
+TaskHandle_t taskHandleSensorConsumer;
+TaskHandle_t taskHandleStorage = NULL;
+TaskHandle_t taskHandleTelemetry = NULL;
+QueueHandle_t telemetryQueue = NULL;
 
-String currentCC = COUNTRY_CODES[2];  // Indonesia
-const char ntpServer[] = "id.pool.ntp.org";
+const char* currentCC = COUNTRY_CODES[2];  // Indonesia
+Preferences prefs;
 
-String currentTime;
-AlarmItem alarmLists[MAX_ALARM];
-int alarmIndex = 0;
+std::atomic<int32_t> clockUtcOffset(UTC_OFFSET_SEC);  // saved in NVS "clock"/"utcOffset"
+uint32_t clockSyncs = 0;
+int64_t clockLastSyncMonoUs = 0;          // esp_timer at the last SNTP reply, 0 = never
+std::atomic<bool> clockStepped(false);    // SNTP set the clock instead of slewing it
 
-SensorData sensorData;
+// Alarm table, free slots are chained through AlarmItem.next
+AlarmItem alarmLists[MAX_ALARM];
+uint16_t alarmFreeHead = ALARM_NONE;
+int alarmCount = 0;
+AlarmLabel alarmLabels[ALARM_LABELS];
+char alarmLabelArena[ALARM_LABEL_ARENA];
+uint16_t alarmLabelArenaUsed = 0;
+portMUX_TYPE alarmMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Every alarm change bumps the revision and records the slot at
+// alarmJournalSlots[revision % ALARM_JOURNAL_LEN]. Random start so that
+// revisions from before a reboot never look recent.
+uint32_t alarmRevision = 0;
+uint16_t alarmJournalSlots[ALARM_JOURNAL_LEN];
+
+// Min-heap of enabled alarmLists slots ordered by their next fire time
+uint16_t alarmHeap[MAX_ALARM];
+int alarmHeapSize = 0;
+time_t alarmFireAt[MAX_ALARM];
+time_t alarmCheckedThrough = 0;  // last second alarmFireDue has handled
+
+// Sensor node registry. Keys are packed MACs (0 = free slot), kept apart
+// from the node state so a lookup only walks 8 bytes per node.
+uint64_t sensorNodeKeys[MAX_SENSOR_NODES];
+SensorNode sensorNodes[MAX_SENSOR_NODES];
+portMUX_TYPE sensorNodesMux = portMUX_INITIALIZER_UNLOCKED;
+uint32_t sensorFramesRejected = 0;
+uint32_t sensorNodesEvicted = 0;
+
+// Lock-free SPSC ring: OnDataRecv (WiFi task) produces, taskSensorConsumer
+// consumes. Head and tail only ever grow, the slot is index & (len - 1).
+EspNowRxFrame espNowRxRing[ESPNOW_RX_QUEUE_LEN];
+std::atomic<uint32_t> espNowRxHead(0);
+std::atomic<uint32_t> espNowRxTail(0);
+uint32_t espNowRxOverflows = 0;
+uint32_t espNowRxMaxDepth = 0;
+
+HistoryRecord historyRecords[HISTORY_METRICS][HISTORY_RECORDS_PER_METRIC];
+HistoryTier historyTiers[HISTORY_METRICS][HISTORY_TIERS];
+portMUX_TYPE historyMux = portMUX_INITIALIZER_UNLOCKED;
+LogHistoryBucket historyPersistQueue[HISTORY_PERSIST_QUEUE];
+int historyPersistCount = 0;
+uint32_t historyPersistDropped = 0;
+
+// Storage log, only touched by taskStorage once setup() is done
+File logFile;
+LogIndex logIndex;
+uint32_t logAppendsSinceIndex = 0;
+bool logNeedsCompaction = false;
+bool logCompacting = false;  // appends go to LOG_COMPACT_PATH, the index on flash still describes LOG_PATH
+LogRecord logHistoryBatch;  // history buckets not yet appended
+uint32_t logRecordsReplayed = 0;
+uint32_t logRecordsCorrupt = 0;
+uint32_t logCompactions = 0;
+uint32_t storageAlarmDirtyBits[(MAX_ALARM + 31) / 32];  // bit per alarmLists slot, under alarmMux
+
+uint8_t discoveryAddress[] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+uint32_t discoveryProbesAnswered = 0;
 
-WebSocketsServer webSocketTime = WebSocketsServer(81);
-WebSocketsServer webSocketDht = WebSocketsServer(82);
-WebSocketsServer webSocketPollution = WebSocketsServer(83);
 AsyncWebServer server(80);
+AsyncWebSocket telemetry("/ws");
+
+WsSubscriber wsSubscribers[MAX_WS_CLIENTS];
+portMUX_TYPE wsSubscribersMux = portMUX_INITIALIZER_UNLOCKED;
+uint8_t telemetryLatest[TELEMETRY_KEYS][TELEMETRY_LATEST_MAX];  // under wsSubscribersMux
+uint8_t telemetryLatestLen[TELEMETRY_KEYS];
+uint32_t wsCoalesced = 0;  // totals across every client, including gone ones
+uint32_t wsDropped = 0;
+uint32_t wsStalledDisconnects = 0;
+
+RequestBody requestBodies[BODY_SLOTS];
+portMUX_TYPE requestBodiesMux = portMUX_INITIALIZER_UNLOCKED;
+uint32_t requestBodiesRejected = 0;  // no free slot or too large
+
+MetricTimer metricTimers[METRIC_TIMERS];
+portMUX_TYPE metricsMux = portMUX_INITIALIZER_UNLOCKED;
 /* ===== Variable Declarations ==== */
 
 
@@ -87,19 +733,19 @@ AsyncWebServer server(80);
 void setup() {
   /* Starting Serial Monitor */
   Serial.begin(115200);
+  logBegin();
   delay(1000);
 
-  for (int i = 0; i < MAX_ALARM; i++) {
-    AlarmItem* tmp = (AlarmItem*)malloc(sizeof(AlarmItem));
-
-    tmp->index = -1;
-    stpcpy(tmp->label, "");
-    stpcpy(tmp->time, "");
+  // Before any producer can publish
+  telemetryQueue = xQueueCreate(TELEMETRY_QUEUE_LEN, sizeof(TelemetryFrame));
 
-    alarmLists[i] = *tmp;
+  alarmRevision = esp_random();
+  alarmInit();
+  historyInit();
 
-    free(tmp);
-  }
+  // Before any task runs, so the scheduler starts with the saved alarms
+  storageInit();
+  alarmBuildFreeList();
 
   /* ====== Wifi Setup ====== */
   WiFi.mode(WIFI_STA);              // Stationary mode
@@ -115,790 +761,2419 @@ void setup() {
   // Kalo gabisa akses, pastikan menggunakan DNS
   // Cloudflare 1.1.1.1 pada jaringan
   if (!MDNS.begin("smartclock18")) {
-    Serial.println("Error setting up MDNS responder!");
+    LOG_ERROR("Error setting up MDNS responder!");
     while (1) {
       delay(500);
     }
   }
-  Serial.println("Access the dashboard via: http://smartclock18.local");
+  LOG_INFO("Access the dashboard via: http://smartclock18.local");
   /* ====== DNS Setup ====== */
 
 
   /* Config NTP Server for clock */
-  configTime(25200, 0, ntpServer);
-  xTaskCreate(taskUpdateTime, "Task Update Time", 2048, NULL, 1, &taskHandleUpdateTime);
+  xTaskCreatePinnedToCore(taskUpdateTime, "Task Update Time", 2048, NULL,
+                          deadlinePriority(DEADLINE_UPDATE_TIME_MS), &taskHandleUpdateTime, CORE_APP);
+  xTaskCreatePinnedToCore(taskAlarmScheduler, "Task Alarm Scheduler", 2048, NULL,
+                          deadlinePriority(DEADLINE_ALARM_SCHEDULER_MS), &taskHandleAlarmScheduler, CORE_APP);
+  clockInit();
 
   /* Config MQ-2 */
   pinMode(PIN_POLLUTION, INPUT);
   analogSetAttenuation(ADC_11db);
-  Serial.println("Warming up Sensor");
-  xTaskCreate(taskAirPollutionSensor, "Task Update Time", 2048, NULL, 1, &taskHandleAirPollutionSensor);
+  LOG_INFO("Warming up Sensor");
+  xTaskCreatePinnedToCore(taskAirPollutionSensor, "Task Air Pollution", 2048, NULL,
+                          deadlinePriority(DEADLINE_AIR_POLLUTION_MS), &taskHandleAirPollutionSensor, CORE_APP);
 
   /* ====== ESP-NOW Setup ====== */
   if (esp_now_init() != ESP_OK) {
-    Serial.println("Error initializing ESP-NOW");
+    LOG_ERROR("Error initializing ESP-NOW");
     return;
   }
+  // Broadcast peer for discovery ACKs. One shared peer instead of one per
+  // sensor keeps us clear of the ESP-NOW peer table limit.
+  esp_now_peer_info_t peerInfo;
+  memset(&peerInfo, 0, sizeof(peerInfo));
+  memcpy(peerInfo.peer_addr, discoveryAddress, 6);
+  peerInfo.channel = 0;
+  peerInfo.encrypt = false;
+  if (esp_now_add_peer(&peerInfo) != ESP_OK) {
+    LOG_ERROR("Error adding ESP-NOW discovery peer");
+  }
+
   // Register callback function to receive ESP-NOW data
+  xTaskCreatePinnedToCore(taskSensorConsumer, "Task Sensor Consumer", 4096, NULL,
+                          deadlinePriority(DEADLINE_SENSOR_CONSUMER_MS), &taskHandleSensorConsumer, CORE_APP);
   esp_now_register_recv_cb(esp_now_recv_cb_t(OnDataRecv));
-  Serial.println("ESP NOW Initialized!");
+  LOG_INFO("ESP NOW Initialized!");
   /* ====== ESP-NOW Setup ====== */
 
 
-  /* ====== WebSocket Setup ====== */
-  webSocketTime.begin();
-  webSocketDht.begin();
-  webSocketPollution.begin();
-
   startWebServer();
 }
 
 void loop() {
-  webSocketTime.loop();
-  webSocketDht.loop();
-  webSocketPollution.loop();
+  // Everything runs in the pinned tasks, the Arduino loop task only costs
+  // its stack
+  vTaskDelete(NULL);
 }
 
 void taskUpdateTime(void* parameters) {
+  // Clients tick the clock themselves, this task only resyncs them when
+  // the target time drifts from esp_timer, i.e. when SNTP lands a new
+  // correction or the UTC offset changes. A slew in progress does not move
+  // the target, so clients keep a constant tick rate through it.
+  int64_t timeSyncWallUs = 0;  // wall clock and esp_timer at the last sync sent
+  int64_t timeSyncMonoUs = 0;
+
   while (1) {
-    struct tm timeinfo;
-    if (!getLocalTime(&timeinfo)) {
-      Serial.println("Failed to obtain time");
-      return;
+    bool forced = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TIME_DRIFT_CHECK_MS)) > 0;
+
+    int64_t wallUs = clockTargetUs();
+    if (wallUs < TIME_VALID_EPOCH * 1000000LL) {
+      LOG_DEBUG("Waiting for NTP time");
+      continue;
     }
 
-    char buffer[50];
-    strftime(buffer, sizeof(buffer), "%H:%M:%S", &timeinfo);
+    int64_t monoUs = esp_timer_get_time();
+    int64_t driftUs = wallUs - (timeSyncWallUs + (monoUs - timeSyncMonoUs));
+
+    if (!forced && timeSyncWallUs != 0 && llabs(driftUs) < TIME_DRIFT_THRESHOLD_MS * 1000LL) continue;
+
+    timeSyncWallUs = wallUs;
+    timeSyncMonoUs = monoUs;
+
+    uint8_t payload[12];
+    telemetryPublish(TOPIC_TIME, payload, encodeTimeSync(payload));
+  }
+
+  vTaskDelete(NULL);
+}
+
+void clockInit() {
+  prefs.begin("clock", true);
+  int32_t offset = prefs.getInt("utcOffset", UTC_OFFSET_SEC);
+  prefs.end();
+  if (offset >= UTC_OFFSET_MIN_SEC && offset <= UTC_OFFSET_MAX_SEC) clockUtcOffset = offset;
+
+  // Smooth mode slews small corrections with adjtime() instead of stepping
+  // the clock, SNTP only steps it when it is far off (first sync included)
+  sntp_set_sync_mode(SNTP_SYNC_MODE_SMOOTH);
+  sntp_set_sync_interval(NTP_SYNC_INTERVAL_MS);
+  sntp_set_time_sync_notification_cb(onTimeSync);
+  configTime(clockUtcOffset, 0, NTP_SERVER_1, NTP_SERVER_2, NTP_SERVER_3);
+}
+
+// Runs in the lwIP task
+void onTimeSync(struct timeval* tv) {
+  clockSyncs++;
+  clockLastSyncMonoUs = esp_timer_get_time();
+  if (sntp_get_sync_status() != SNTP_SYNC_STATUS_IN_PROGRESS) clockStepped = true;
+
+  xTaskNotifyGive(taskHandleUpdateTime);
+  xTaskNotifyGive(taskHandleAlarmScheduler);
+}
+
+// What the wall clock will read once an adjtime() slew in progress is done
+int64_t clockTargetUs() {
+  struct timeval tv;
+  struct timeval pending = { 0, 0 };
+  gettimeofday(&tv, NULL);
+  adjtime(NULL, &pending);
+  return ((int64_t)tv.tv_sec + pending.tv_sec) * 1000000 + tv.tv_usec + pending.tv_usec;
+}
+
+const char* clockStatus() {
+  if (time(NULL) < TIME_VALID_EPOCH) return "waiting";
+  if (clockLastSyncMonoUs == 0) return "unsynced";  // clock survived a reset, SNTP has not answered yet
+  if (sntp_get_sync_status() == SNTP_SYNC_STATUS_IN_PROGRESS) return "slewing";
+  if (esp_timer_get_time() - clockLastSyncMonoUs > NTP_STALE_MS * 1000LL) return "stale";
+  return "synced";
+}
+
+size_t encodeTimeSync(uint8_t* payload) {
+  int64_t epochMs = clockTargetUs() / 1000;
+  int32_t offset = clockUtcOffset;
+
+  // ESP32 is little-endian, same as the wire format
+  memcpy(payload, &epochMs, sizeof(epochMs));
+  memcpy(payload + 8, &offset, sizeof(offset));
+  return 12;
+}
+
+void taskAlarmScheduler(void* parameters) {
+  // Sleeps on the tick count, which NTP never moves, until the earliest
+  // alarm is due. Alarm edits and NTP corrections notify the task, which
+  // then rebuilds the heap. Slewed corrections only shift a wakeup by the
+  // slew so far; when SNTP steps the clock the heap is rebuilt from the
+  // last second already handled, so a step forward fires what it jumped
+  // over and a step back does not ring anything twice.
+  bool rebuild = true;
 
-    currentTime = String(buffer);
+  while (1) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+
+    TickType_t wait = pdMS_TO_TICKS(ALARM_RECHECK_MS);
+    AlarmFired fired[ALARM_FIRE_BATCH];
+    int firedCount = 0;
+    bool stepped = clockStepped.exchange(false);
+
+    if (tv.tv_sec >= TIME_VALID_EPOCH) {
+      portENTER_CRITICAL(&alarmMux);
+      if (rebuild) {
+        time_t from = tv.tv_sec;
+        if (stepped && alarmCheckedThrough != 0 && llabs(from - alarmCheckedThrough) <= ALARM_STEP_MAX_SEC) from = alarmCheckedThrough + 1;
+        alarmScheduleAll(from);
+      }
+      firedCount = alarmFireDue(tv.tv_sec, fired, ALARM_FIRE_BATCH);
+
+      // A full batch may have left more due alarms behind, come back at once
+      if (firedCount == ALARM_FIRE_BATCH) {
+        wait = 0;
+      } else if (alarmHeapSize > 0) {
+        int64_t ms = (int64_t)(alarmFireAt[alarmHeap[0]] - tv.tv_sec) * 1000 - tv.tv_usec / 1000;
+        if (ms < ALARM_RECHECK_MS) wait = pdMS_TO_TICKS(ms > 0 ? ms : 1);
+      }
+      portEXIT_CRITICAL(&alarmMux);
+    }
 
-    webSocketTime.broadcastTXT(currentTime);
+    bool changed = false;
+    for (int i = 0; i < firedCount; i++) {
+      if (fired[i].ring) {
+        uint8_t payload[2] = { (uint8_t)fired[i].slot, (uint8_t)(fired[i].slot >> 8) };
+        telemetryPublish(TOPIC_ALARM, payload, sizeof(payload));
+      }
+      if (fired[i].revision != 0) {
+        alarmPublish(fired[i].revision, fired[i].slot);
+        changed = true;
+      }
+    }
+    // One-shot alarms disabled themselves, save that
+    if (changed && taskHandleStorage != NULL) xTaskNotifyGive(taskHandleStorage);
 
-    vTaskDelay(1000 / portTICK_PERIOD_MS);
+    rebuild = ulTaskNotifyTake(pdTRUE, wait) > 0;
   }
 
   vTaskDelete(NULL);
 }
 
 void taskAirPollutionSensor(void* parameters) {
+  MedianFilter<MQ2_MEDIAN_WINDOW> median;
+  MovingAverage<MQ2_AVERAGE_WINDOW> average;
+
+  uint32_t r0Q8 = 0;  // R0 / RL, x256
+  uint32_t calibrationSum = 0;
+  uint16_t calibrationCount = 0;
+
+  uint16_t lastPpm = 0;
+  bool published = false;
+  TickType_t lastPublish = 0;
+
+  TickType_t wake = xTaskGetTickCount();
+  TickType_t start = wake;
+
   while (1) {
-    int gasValue = analogRead(PIN_POLLUTION);
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(MQ2_SAMPLE_PERIOD_MS));
+
+    uint16_t raw = average.push(median.push(analogRead(PIN_POLLUTION)));
+    uint32_t rsQ8 = mq2ResistanceQ8(raw);
+
+    // After warm-up, assume clean air and derive R0 from the mean Rs
+    if (r0Q8 == 0) {
+      if (wake - start < pdMS_TO_TICKS(MQ2_WARMUP_MS)) continue;
+
+      calibrationSum += rsQ8;
+      if (++calibrationCount < MQ2_CALIBRATION_SAMPLES) continue;
 
-    String value = std::to_string(gasValue).c_str();
+      r0Q8 = max(calibrationSum / calibrationCount * 100 / MQ2_CLEAN_AIR_RATIO_X100, (uint32_t)1);
+      LOG_INFO("MQ-2 calibrated");
+      continue;
+    }
+
+    uint16_t ppm = mq2Ppm((rsQ8 << 8) / r0Q8);
+    historyAdd(HISTORY_METRIC_PPM, time(NULL), ppm);
+
+    // Publish only on a meaningful change, or as a keepalive
+    uint16_t delta = ppm > lastPpm ? ppm - lastPpm : lastPpm - ppm;
+    uint16_t threshold = max((uint16_t)MQ2_PUBLISH_DELTA_PPM, (uint16_t)(lastPpm * MQ2_PUBLISH_DELTA_PCT / 100));
+    if (published && delta < threshold && wake - lastPublish < pdMS_TO_TICKS(MQ2_PUBLISH_MAX_INTERVAL_MS)) continue;
+
+    uint8_t payload[2] = { (uint8_t)ppm, (uint8_t)(ppm >> 8) };
+    telemetryPublish(TOPIC_POLLUTION, payload, sizeof(payload));
 
-    webSocketPollution.broadcastTXT(value);
-    vTaskDelay(300 / portTICK_PERIOD_MS);
+    lastPpm = ppm;
+    lastPublish = wake;
+    published = true;
   }
 
   vTaskDelete(NULL);
 }
 
-void webDashboard() {
-  server.on("/", HTTP_GET, [](AsyncWebServerRequest* request) {
-    request->send_P(200, "text/html", R"rawliteral(
-      <!DOCTYPE html>
-      <html lang="id">
-
-      <head>
-        <meta charset="UTF-8">
-        <meta name="viewport" content="width=device-width, initial-scale=1.0">
-
-        <title>SmartClock</title>
-
-        <link href="https://fonts.googleapis.com/css2?family=Inter:wght@400;500;600;700&display=swap" rel="stylesheet">
-        <link href="https://cdnjs.cloudflare.com/ajax/libs/font-awesome/6.0.0/css/all.min.css" rel="stylesheet">
-
-        <style>
-          :root {
-            --color-lightest: #D3F1DF;
-            --color-light: #85A98F;
-            --color-medium: #5A6C57;
-            --color-dark: #525B44;
-            --font-family: 'Inter', sans-serif;
-          }
-
-          * {
-            margin: 0;
-            padding: 0;
-            box-sizing: border-box;
-            font-family: var(--font-family);
-            /* border: black solid 1px; */
-          }
-
-          *::selection {
-            background-color: var(--color-dark);
-            color: var(--color-lightest);
-          }
-
-          body {
-            background-color: var(--color-lightest);
-            color: var(--color-dark);
-            line-height: 1.6;
-          }
-
-          .button {
-            padding: 0.5rem 1rem;
-            border: none;
-            border-radius: 0.5rem;
-            font-weight: 500;
-            cursor: pointer;
-            transition: all 0.3s ease;
-            border: var(--color-dark) solid 2px;
-          }
-
-          .button-outline {
-            background-color: var(--color-lightest);
-            color: var(--color-dark);
-            border: var(--color-dark) solid 2px;
-          }
-
-          .button-outline:hover {
-            background-color: var(--color-medium);
-            color: white;
-          }
-
-          .modal {
-            display: none;
-            position: fixed;
-            top: 0;
-            left: 0;
-            width: 100%;
-            height: 100%;
-            background-color: rgba(0, 0, 0, 0.5);
-          }
-
-          .modal-content {
-            background-color: white;
-            padding: 2rem;
-            border-radius: 1rem;
-            width: 90%;
-            max-width: 500px;
-            position: absolute;
-            top: 50%;
-            left: 50%;
-            transform: translate(-50%, -50%);
-          }
-
-          .modal-title {
-            font-size: 1.5rem;
-            font-weight: 600;
-            margin-bottom: 1.5rem;
-            color: var(--color-dark);
-          }
-
-          .form-group {
-            margin-bottom: 1rem;
-          }
-
-          .form-group label {
-            display: block;
-            margin-bottom: 0.5rem;
-            color: var(--color-medium);
-          }
-
-          .form-control {
-            width: 100%;
-            padding: 0.5rem;
-            border: 1px solid var(--color-light);
-            border-radius: 0.5rem;
-            font-size: 1rem;
-          }
-
-          .modal-footer {
-            display: flex;
-            justify-content: flex-end;
-            gap: 1rem;
-            margin-top: 1.5rem;
-          }
-
-          @media (max-width: 768px) {
-            .grid {
-              grid-template-columns: 1fr;
-            }
-          }
-        </style>
-      </head>
-
-      <body>
-        <style id="navbar-style">
-          .navbar {
-            width: 100%;
-            background-color: var(--color-light);
-            padding: 1rem 2rem;
-            border-bottom: var(--color-dark) solid 2px;
-          }
-
-          .navbar-content {
-            max-width: 1200px;
-            margin: 0 auto;
-            display: flex;
-            justify-content: space-between;
-            align-items: center;
-          }
-
-          .navbar-logo {
-            font-size: 2rem;
-            font-weight: 700;
-            letter-spacing: -3.5px;
-            color: white;
-            background-color: var(--color-medium);
-            padding: 2px 10px;
-            border-radius: 4px;
-          }
-
-          .navbar-buttons {
-            display: flex;
-            gap: 1rem;
-          }
-
-          .navbar-button {
-            padding: 0.5rem 1rem;
-            border-radius: 0.5rem;
-            font-weight: bold;
-            font-size: 1rem;
-            cursor: pointer;
-            transition: all 0.3s ease;
-          }
-        </style>
-        <nav class="navbar">
-          <div class="navbar-content">
-            <div class="navbar-logo">SmartClock</div>
-            <div class="navbar-buttons">
-              <!-- <button class="navbar-button button-outline" onclick="modalOpen('timezone-modal')">Timezone</button> -->
-              <button class="navbar-button button-outline" onclick="modalOpen('alarm-modal')">New Alarm</button>
-            </div>
-          </div>
-        </nav>
-
-        <style id="container style">
-          .container {
-            width: 100%;
-            max-width: 1200px;
-            display: flex;
-            flex-direction: column;
-            flex-wrap: wrap;
-            align-items: center;
-            justify-content: center;
-            gap: 12px;
-            margin: 0 auto;
-            overflow: hidden;
-          }
-
-          .sub-container {
-            display: flex;
-            justify-content: center;
-            gap: 12px;
-            width: 100%;
-            overflow: hidden;
-          }
-
-          .card {
-            background-color: var(--color-light);
-            display: flex;
-            flex-direction: column;
-            flex: 1;
-            width: 100%;
-            max-height: 600px;
-            padding: 12px 24px;
-            border-radius: 6px;
-            border: var(--color-dark) solid 2px;
-          }
-
-          .card-title {
-            color: var(--color-dark);
-            background-color: var(--color-lightest);
-            width: fit-content;
-            letter-spacing: -1px;
-            margin: 0 0 12px 0;
-            border-radius: 4px;
-            padding: 0 6px;
-            border: var(--color-dark) solid 2px;
-          }
-        </style>
-        <div class="container">
-          <div class="sub-container" style="margin-top: 2rem;">
-            <div id="Sensor" class="card">
-              <h2 class="card-title">Kondisi Ruangan</h2>
-
-              <style id="environment-style">
-                .environment-card {
-                  display: flex;
-                  justify-content: space-between;
-                  flex-wrap: wrap;
-                  gap: 12px;
-                  width: 100%;
-                  height: 100%;
-                }
-
-                .env-metric {
-                  display: flex;
-                  flex: 1;
-                  flex-direction: column;
-                  align-items: center;
-                  width: 100%;
-                  background: var(--color-lightest);
-                  padding: 1.5rem;
-                  border-radius: 0.75rem;
-                  text-align: center;
-                  transition: transform 0.2s;
-                  border: var(--color-dark) solid 2px;
-                }
-
-                .env-metric:hover {
-                  transform: translateY(-4px);
-                  box-shadow: 0 0 4px var(--color-dark);
-                }
-
-                .metric-header {
-                  display: flex;
-                  align-items: center;
-                  gap: 12px;
-                  margin-bottom: 8px;
-                }
-
-                .env-icon {
-                  color: var(--color-medium);
-                  font-size: 2rem;
-                }
-
-                .env-label {
-                  font-size: 1.5rem;
-                  font-weight: bold;
-                  color: var(--color-medium);
-                }
-
-                .env-value-container {
-                  width: 100%;
-                  height: 100%;
-                  display: flex;
-                  align-items: center;
-                  justify-content: center;
-                }
-
-                .env-value {
-                  color: var(--color-dark);
-                  background-color: white;
-                  font-size: 2rem;
-                  font-weight: 900;
-                  padding: 42px 32px;
-                  border: var(--color-dark) solid 2px;
-                  border-radius: 100%;
-                }
-              </style>
-              <div class="environment-card">
-                <div class="env-metric">
-                  <div class="metric-header">
-                    <i class="fas fa-temperature-high env-icon"></i>
-                    <div class="env-label">Suhu</div>
-                  </div>
-
-                  <div class="env-value-container">
-                    <p class="env-value" id="temperature">
-                      28°C
-                    </p>
-                  </div>
-                </div>
-
-                <div class="env-metric">
-                  <div class="metric-header">
-                    <i class="fas fa-tint env-icon"></i>
-                    <div class="env-label">Kelembaban</div>
-                  </div>
-
-                  <div class="env-value-container">
-                    <p class="env-value" id="humidity">
-                      65%
-                    </p>
-                  </div>
-                </div>
-
-                <div class="env-metric">
-                  <div class="metric-header">
-                    <i class="fas fa-cloud env-icon"></i>
-                    <div class="env-label">PPM</div>
-                  </div>
-
-                  <div class="env-value-container">
-                    <p class="env-value" id="pollution" style="min-width: 150px;">
-                      234
-                    </p>
-                  </div>
-                </div>
-              </div>
-            </div>
-
-            <div id="Clock" class="card">
-              <style id="clock-style">
-                .timezone-container {
-                  display: flex;
-                  align-items: start;
-                  justify-content: space-between;
-                  gap: 12px;
-                }
-
-                .clock-timezone {
-                  font-weight: 300;
-                  font-size: 1.5rem;
-                  padding: 0 12px;
-                }
-
-                .clock {
-                  display: flex;
-                  align-items: center;
-                  justify-content: center;
-                  padding: 12px 0;
-                  font-weight: bold;
-                  font-size: 2.5rem;
-                  color: var(--color-medium);
-                  background-color: white;
-                  border-radius: 12px;
-                  border: var(--color-dark) solid 2px;
-                }
-              </style>
-
-              <div class="timezone-container">
-                <h2 class="card-title">Jam</h2>
-
-                <div class="clock-timezone card-title" id="clock-timezone">Indonesia (WIB)</div>
-              </div>
-
-              <div class="clock" id="clock">
-                13:23:22
-              </div>
-
-              <style id="alarm-style">
-                .alarms-list {
-                  margin-top: 1rem;
-                  border-top: 2px solid var(--color-lightest);
-                  padding-top: 1rem;
-                  overflow: hidden;
-                }
-
-                .alarm-item {
-                  display: flex;
-                  justify-content: space-between;
-                  align-items: center;
-                  padding: 0.75rem;
-                  background: var(--color-lightest);
-                  border-radius: 0.5rem;
-                  margin-bottom: 0.5rem;
-                  border: var(--color-dark) solid 2px;
-                }
-
-                .alarm-info {
-                  display: flex;
-                  align-items: center;
-                  gap: 0.75rem;
-                }
-
-                .alarm-time {
-                  font-weight: 600;
-                  color: var(--color-dark);
-                }
-
-                .alarm-label {
-                  color: var(--color-medium);
-                }
-
-                .alarm-actions {
-                  display: flex;
-                  gap: 0.5rem;
-                }
-
-                .alarms-container {
-                  height: 100%;
-                  overflow-y: auto;
-                  padding-bottom: 56px;
-                }
-              </style>
-              <div class="alarms-list">
-                <h2 class="card-title">Active Alarms</h2>
-
-                <div id="alarms-container" class="alarms-container">
-                </div>
-              </div>
-            </div>
-          </div>
-        </div>
-
-        <div id="timezone-modal" class="modal">
-          <div class="modal-content">
-            <h2 class="modal-title">Select Timezone</h2>
-            <div class="form-group">
-              <select class="form-control" id="timezone-select">
-                <option value="0">China</option>
-                <option value="1">Hong Kong</option>
-                <option value="2">Indonesia</option>
-                <option value="3">Japan</option>
-                <option value="4">Korea</option>
-                <option value="5">Malaysia</option>
-                <option value="6">Philippines</option>
-                <option value="7">Palestinian Territory</option>
-                <option value="8">Saudi Arabia</option>
-                <option value="9">Singapore</option>
-                <option value="10">Thailand</option>
-                <option value="11">Taiwan</option>
-                <option value="12">Vietnam</option>
-              </select>
-            </div>
-            <div class="modal-footer">
-              <button class="button button-outline" onclick="modalClose('timezone-modal')">Cancel</button>
-              <button class="button button-outline" onclick="saveTimezone()">Save</button>
-            </div>
-          </div>
-        </div>
-
-        <div id="alarm-modal" class="modal">
-          <div class="modal-content">
-            <h2 class="modal-title">Create New Alarm</h2>
-            <div class="form-group">
-              <label>Time</label>
-              <input type="time" class="form-control" id="alarm-time">
-            </div>
-            <div class="form-group">
-              <label>Label</label>
-              <input type="text" class="form-control" id="alarm-label" maxlength="32" placeholder="Alarm label">
-            </div>
-            <div class="modal-footer">
-              <button class="button button-outline" onclick="modalClose('alarm-modal')">Cancel</button>
-              <button class="button button-outline" onclick="addAlarm()">Create</button>
-            </div>
-          </div>
-        </div>
-
-        
-        <div id="player" style="display: none;"></div>
-        
-        <script src="https://www.youtube.com/iframe_api"></script>
-        <script>
-          <!-- Audio -->
-          let player;
-          let isReady = false;
-          
-          // Initialize YouTube player
-          function onYouTubeIframeAPIReady() {
-              player = new YT.Player('player', {
-                  height: '0',
-                  width: '0',
-                  videoId: 'rUkzZTGE6jI', // Replace with your desired YouTube video ID
-                  playerVars: {
-                      'autoplay': 0,
-                      'controls': 0
-                  },
-                  events: {
-                      'onReady': onPlayerReady
-                  }
-              });
-          }
-          
-          // When player is ready
-          function onPlayerReady(event) {
-            isReady = true;
-          }
-
-          <!-- Main -->
-          let alarmLists = [];
-
-          let webSocketTime = new WebSocket('ws://' + window.location.hostname + ':81/');
-          let webSocketDht = new WebSocket('ws://' + window.location.hostname + ':82/');
-          let webSocketMQ = new WebSocket('ws://' + window.location.hostname + ':83/');
-          webSocketTime.onmessage = function (event) {
-            document.getElementById("clock").innerHTML = event.data;
-
-            if (!player) return;
-            for (let i = 0; i < alarmLists.length; i++) {
-              if (alarmLists[i].time == event.data) player.playVideo();
-            }
-          }
-
-          webSocketDht.onmessage = function (event) {
-            let data = JSON.parse(event.data);
-
-            document.getElementById("temperature").innerHTML = data.T + "°C";
-            document.getElementById("humidity").innerHTML = data.H + "%";
-          }
-
-          webSocketMQ.onmessage = function (event) {
-            document.getElementById("pollution").innerHTML = event.data;
-          }
-
-          async function getAlarm() {
-            const res = await fetch(`http://${window.location.hostname}/alarm`, {
-                headers: {
-                  'Accept': 'application/json',
-                  'Content-Type': 'application/json'
-                }
-              });
-            
-            let data = await res.json();
-
-            alarmLists = data.alarms;
-
-            const container = document.getElementById('alarms-container');
-            container.innerHTML = data.alarms.map((alarm, index) => alarm.id == -1 ? "" : `
-                  <div class="alarm-item">
-                      <div class="alarm-info">
-                          <i class="fas fa-clock"></i>
-                          <span class="alarm-time">${alarm.time}</span>
-                          <span class="alarm-label">${alarm.label}</span>
-                      </div>
-                      <div class="alarm-actions">
-                          <i class="fas fa-trash" style="cursor: pointer; color: var(--color-medium);"
-                            onclick="deleteAlarm(${alarm.id})"></i>
-                      </div>
-                  </div>
-              `).join('');
-          }
-
-          async function addAlarm() {
-            const time = document.getElementById("alarm-time").value + ":00";
-            const label = document.getElementById("alarm-label").value;
-
-            if (!time || !label) return;
-
-            await fetch(`http://${window.location.hostname}/alarm`, {
-              method: 'POST',
-              headers: {
-                'Accept': 'application/json',
-                'Content-Type': 'application/json'
-              },
-              body: JSON.stringify({ time, label })
-            });
-
-            await getAlarm();
-
-            document.getElementById("alarm-time").value = "";
-            document.getElementById("alarm-label").value = "";
-            modalClose('alarm-modal');
-          }
-
-          const deleteAlarm = async (index) => {
-            await fetch(`http://${window.location.hostname}/delete`, {
-              method: 'POST',
-              headers: {
-                'Accept': 'application/json',
-                'Content-Type': 'application/json'
-              },
-              body: JSON.stringify({ index })
-            });
-
-            await getAlarm();
-          }
-
-          getAlarm();
-
-          const modalOpen = (modalId) => {
-            document.getElementById(modalId).style.display = 'block';
-          }
-
-          const modalClose = (modalId) => {
-            document.getElementById(modalId).style.display = 'none';
-          }
-
-          window.onclick = function (event) {
-            if (event.target.classList.contains('modal')) {
-              event.target.style.display = 'none';
-            }
-          }
-        </script>
-      </body>
-
-      </html>
-    )rawliteral");
-    });
+// Rs / RL x256 from the divider: Vout = Vc * RL / (Rs + RL)
+uint32_t mq2ResistanceQ8(uint16_t raw) {
+  raw = constrain(raw, (uint16_t)1, (uint16_t)MQ2_ADC_MAX);
+  return ((uint32_t)(MQ2_ADC_MAX - raw) << 8) / raw;
 }
 
-void webGetAlarm() {
-  server.on("/alarm", HTTP_GET, [](AsyncWebServerRequest* request) {
-    String json = "{";
-    json += "\"alarms\": [";
-    for (int i = 0; i < MAX_ALARM; i++) {
-      json += "{\"id\":\"" + String(alarmLists[i].index) + "\"";
-      json += ",\"time\":\"" + String(alarmLists[i].time) + "\"";
-      json += ",\"label\":\"" + String(alarmLists[i].label) + "\"}";
-      if (i < MAX_ALARM - 1) json += ",";
+// Rs/R0 x256 to ppm, linear between curve points, clamped at both ends
+uint16_t mq2Ppm(uint32_t ratioQ8) {
+  const size_t points = sizeof(MQ2_PPM_CURVE) / sizeof(MQ2_PPM_CURVE[0]);
+
+  if (ratioQ8 <= MQ2_PPM_CURVE[0][0]) return MQ2_PPM_CURVE[0][1];
+  for (size_t i = 1; i < points; i++) {
+    if (ratioQ8 > MQ2_PPM_CURVE[i][0]) continue;
+
+    uint32_t x0 = MQ2_PPM_CURVE[i - 1][0], y0 = MQ2_PPM_CURVE[i - 1][1];
+    uint32_t x1 = MQ2_PPM_CURVE[i][0], y1 = MQ2_PPM_CURVE[i][1];
+    return y0 - (y0 - y1) * (ratioQ8 - x0) / (x1 - x0);
+  }
+  return MQ2_PPM_CURVE[points - 1][1];
+}
+
+uint32_t parseAlarmTime(const char* time) {
+  int h, m, sec = 0;
+  if (sscanf(time, "%d:%d:%d", &h, &m, &sec) < 2) return ALARM_TIME_INVALID;
+  if (h < 0 || h > 23 || m < 0 || m > 59 || sec < 0 || sec > 59) return ALARM_TIME_INVALID;
+
+  return h * 3600 + m * 60 + sec;
+}
+
+// First epoch second >= now whose local time of day equals seconds,
+// on one of days (any day when days is 0)
+time_t alarmNextFire(uint32_t seconds, uint8_t days, time_t now) {
+  int32_t offset = clockUtcOffset;
+  time_t local = now + offset;
+  time_t fireAt = local - local % SECONDS_PER_DAY + seconds - offset;
+  if (fireAt < now) fireAt += SECONDS_PER_DAY;
+  if (days == 0) return fireAt;
+
+  // 1970-01-01 was a Thursday
+  for (int i = 0; i < 7; i++, fireAt += SECONDS_PER_DAY) {
+    int weekday = ((fireAt + offset) / SECONDS_PER_DAY + 4) % 7;
+    if (days & (1 << weekday)) break;
+  }
+  return fireAt;
+}
+
+void alarmHeapPush(uint16_t slot) {
+  int i = alarmHeapSize++;
+  while (i > 0) {
+    int parent = (i - 1) / 2;
+    if (alarmFireAt[alarmHeap[parent]] <= alarmFireAt[slot]) break;
+    alarmHeap[i] = alarmHeap[parent];
+    i = parent;
+  }
+  alarmHeap[i] = slot;
+}
+
+uint16_t alarmHeapPop() {
+  uint16_t top = alarmHeap[0];
+  uint16_t last = alarmHeap[--alarmHeapSize];
+
+  int i = 0;
+  while (1) {
+    int child = 2 * i + 1;
+    if (child >= alarmHeapSize) break;
+    if (child + 1 < alarmHeapSize && alarmFireAt[alarmHeap[child + 1]] < alarmFireAt[alarmHeap[child]]) child++;
+    if (alarmFireAt[last] <= alarmFireAt[alarmHeap[child]]) break;
+    alarmHeap[i] = alarmHeap[child];
+    i = child;
+  }
+  if (alarmHeapSize > 0) alarmHeap[i] = last;
+
+  return top;
+}
+
+// Caller holds alarmMux
+void alarmScheduleAll(time_t now) {
+  alarmHeapSize = 0;
+  for (int i = 0; i < MAX_ALARM; i++) {
+    const AlarmItem* alarm = &alarmLists[i];
+    if (alarm->seconds == ALARM_TIME_INVALID || !(alarm->flags & ALARM_ENABLED)) continue;
+
+    alarmFireAt[i] = alarmNextFire(alarm->seconds, alarm->days, now);
+    alarmHeapPush(i);
+  }
+}
+
+// Pops up to maxFired alarms due at now. Repeating alarms are
+// rescheduled, one-shot alarms are disabled. Alarms after
+// alarmCheckedThrough ring however late they are, which covers the ones
+// a forward clock step jumped over. Caller holds alarmMux.
+int alarmFireDue(time_t now, AlarmFired* fired, int maxFired) {
+  int count = 0;
+  time_t checked = alarmCheckedThrough;
+
+  while (count < maxFired && alarmHeapSize > 0 && alarmFireAt[alarmHeap[0]] <= now) {
+    uint16_t slot = alarmHeapPop();
+    AlarmItem* alarm = &alarmLists[slot];
+    AlarmFired* result = &fired[count++];
+    result->slot = slot;
+    result->ring = alarmFireAt[slot] > checked || now - alarmFireAt[slot] <= ALARM_GRACE_SEC;
+    result->revision = 0;
+
+    if (alarm->days == 0) {
+      alarm->flags &= ~ALARM_ENABLED;
+      storageAlarmDirty(slot);
+      result->revision = alarmJournal(slot);
+      continue;
     }
-    json += "]}";
 
-    request->send(200, "application/json", json);
-    });
+    alarmFireAt[slot] = alarmNextFire(alarm->seconds, alarm->days, now + 1);
+    alarmHeapPush(slot);
+  }
+
+  if (count < maxFired && now > alarmCheckedThrough) alarmCheckedThrough = now;
+  return count;
 }
 
-void webAddAlarm() {
-  server.on("/alarm", HTTP_POST, [](AsyncWebServerRequest* request) {
-    request->send(200, "application/json", "Success!");
-    },
-    nullptr, parseNewAlarm);
+// Records a change to slot and returns its revision. Caller holds alarmMux.
+uint32_t alarmJournal(uint16_t slot) {
+  // 0 marks "no change" in AlarmFired, never hand it out
+  if (++alarmRevision == 0) alarmRevision++;
+  alarmJournalSlots[alarmRevision % ALARM_JOURNAL_LEN] = slot;
+  return alarmRevision;
 }
 
-void webDeleteAlarm() {
-  server.on("/delete", HTTP_POST, [](AsyncWebServerRequest* request) {
-    request->send(200, "application/json", "Success!");
-    },
-    nullptr, parseDeleteAlarm);
+// TOPIC_ALARM_SYNC payload carrying the current state of slot
+size_t encodeAlarmEvent(uint8_t* payload, uint32_t revision, int slot) {
+  memcpy(payload, &revision, 4);
+  payload[5] = (uint8_t)slot;
+  payload[6] = (uint8_t)(slot >> 8);
+
+  portENTER_CRITICAL(&alarmMux);
+  bool used = alarmLists[slot].seconds != ALARM_TIME_INVALID;
+  size_t length = used ? 5 + encodeAlarmEntry(payload + 5, slot) : 7;
+  portEXIT_CRITICAL(&alarmMux);
+
+  payload[4] = used ? ALARM_OP_UPSERT : ALARM_OP_DELETE;
+  return length;
 }
 
-void parseNewAlarm(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t total) {
-  if (alarmIndex >= MAX_ALARM) {
-    req->send_P(403, "application/json", "Max Alarm Reached!");
+// u16 id, u32 seconds, u8 days, u8 flags, u8 label length, label; at most
+// 9 + ALARM_LABEL_MAX_LEN bytes. Caller holds alarmMux, slot is in use.
+size_t encodeAlarmEntry(uint8_t* out, int slot) {
+  const AlarmItem* alarm = &alarmLists[slot];
+  size_t length = alarm->label != ALARM_NO_LABEL ? alarmLabels[alarm->label].length : 0;
+
+  out[0] = (uint8_t)slot;
+  out[1] = (uint8_t)(slot >> 8);
+  memcpy(out + 2, &alarm->seconds, 4);
+  out[6] = alarm->days;
+  out[7] = alarm->flags;
+  out[8] = length;
+  if (length > 0) memcpy(out + 9, alarmLabelArena + alarmLabels[alarm->label].offset, length);
+  return 9 + length;
+}
+
+void alarmPublish(uint32_t revision, int slot) {
+  uint8_t payload[MAX_WS_FRAME - 1];
+  telemetryPublish(TOPIC_ALARM_SYNC, payload, encodeAlarmEvent(payload, revision, slot));
+}
+
+// Replays the journal after lastRevision to one client. Events carry the
+// slot's current state, so replaying one that was already seen is harmless.
+void alarmCatchUp(AsyncWebSocketClient* client, uint32_t lastRevision) {
+  uint16_t slots[ALARM_JOURNAL_LEN];
+
+  portENTER_CRITICAL(&alarmMux);
+  uint32_t current = alarmRevision;
+  uint32_t behind = current - lastRevision;
+  if (behind < ALARM_JOURNAL_LEN) {
+    for (uint32_t i = 0; i < behind; i++) slots[i] = alarmJournalSlots[(lastRevision + 1 + i) % ALARM_JOURNAL_LEN];
+  }
+  portEXIT_CRITICAL(&alarmMux);
+
+  uint8_t payload[MAX_WS_FRAME - 1];
+  if (behind >= ALARM_JOURNAL_LEN) {
+    memcpy(payload, &current, 4);
+    payload[4] = ALARM_OP_RESYNC;
+    telemetrySend(client, TOPIC_ALARM_SYNC, payload, 5);
+    return;
+  }
+
+  for (uint32_t i = 0; i < behind; i++) {
+    // A refused event leaves a gap the client will ask about again
+    if (!telemetrySend(client, TOPIC_ALARM_SYNC, payload, encodeAlarmEvent(payload, lastRevision + 1 + i, slots[i]))) break;
   }
+}
 
+void alarmInit() {
   for (int i = 0; i < MAX_ALARM; i++) {
-    if (alarmLists[i].index == -1) {
-      alarmIndex = i;
+    alarmLists[i].seconds = ALARM_TIME_INVALID;
+    alarmLists[i].label = ALARM_NO_LABEL;
+  }
+  alarmBuildFreeList();
+}
+
+// Chains every free slot, lowest id first. Only needed after slots were
+// set directly, as the storage replay does.
+void alarmBuildFreeList() {
+  portENTER_CRITICAL(&alarmMux);
+  alarmFreeHead = ALARM_NONE;
+  alarmCount = 0;
+  for (int i = MAX_ALARM - 1; i >= 0; i--) {
+    if (alarmLists[i].seconds != ALARM_TIME_INVALID) {
+      alarmCount++;
+      continue;
+    }
+    alarmLists[i].next = alarmFreeHead;
+    alarmFreeHead = i;
+  }
+  portEXIT_CRITICAL(&alarmMux);
+}
+
+// Returns a free slot or -1 when the table is full. Caller holds alarmMux.
+int alarmAlloc() {
+  if (alarmFreeHead == ALARM_NONE) return -1;
+
+  int slot = alarmFreeHead;
+  alarmFreeHead = alarmLists[slot].next;
+  alarmCount++;
+  return slot;
+}
+
+// Caller holds alarmMux, the slot must already be cleared
+void alarmFree(int slot) {
+  alarmLists[slot].next = alarmFreeHead;
+  alarmFreeHead = slot;
+  alarmCount--;
+}
+
+// Stores entry in slot, replacing what was there. Fails, leaving the slot
+// as it was, when the label arena is full. Caller holds alarmMux.
+bool alarmSet(int slot, const AlarmEntry& entry) {
+  AlarmItem* alarm = &alarmLists[slot];
+
+  size_t length = strnlen(entry.label, ALARM_LABEL_MAX_LEN);
+  int label = length > 0 ? alarmLabelIntern(entry.label, length) : ALARM_NO_LABEL;
+  if (label < 0) return false;
+
+  if (alarm->seconds != ALARM_TIME_INVALID && alarm->label != ALARM_NO_LABEL) alarmLabelRelease(alarm->label);
+  alarm->seconds = entry.seconds;
+  alarm->label = label;
+  alarm->days = entry.days & ALARM_DAYS_ALL;
+  alarm->flags = entry.flags;
+  return true;
+}
+
+// Caller holds alarmMux
+void alarmClear(int slot) {
+  AlarmItem* alarm = &alarmLists[slot];
+  if (alarm->seconds == ALARM_TIME_INVALID) return;
+
+  if (alarm->label != ALARM_NO_LABEL) alarmLabelRelease(alarm->label);
+  alarm->seconds = ALARM_TIME_INVALID;
+  alarm->label = ALARM_NO_LABEL;
+}
+
+// Copies slot out with its label. Returns false for a free slot.
+bool alarmGet(int slot, AlarmEntry& entry) {
+  portENTER_CRITICAL(&alarmMux);
+  const AlarmItem* alarm = &alarmLists[slot];
+  bool used = alarm->seconds != ALARM_TIME_INVALID;
+  if (used) {
+    entry.seconds = alarm->seconds;
+    entry.days = alarm->days;
+    entry.flags = alarm->flags;
+
+    size_t length = 0;
+    if (alarm->label != ALARM_NO_LABEL) {
+      length = alarmLabels[alarm->label].length;
+      memcpy(entry.label, alarmLabelArena + alarmLabels[alarm->label].offset, length);
+    }
+    entry.label[length] = '\0';
+  }
+  portEXIT_CRITICAL(&alarmMux);
+
+  return used;
+}
+
+// First used slot >= from, or -1
+int alarmNextUsed(int from) {
+  int slot = -1;
+
+  portENTER_CRITICAL(&alarmMux);
+  for (int i = max(from, 0); i < MAX_ALARM; i++) {
+    if (alarmLists[i].seconds != ALARM_TIME_INVALID) {
+      slot = i;
       break;
     }
   }
+  portEXIT_CRITICAL(&alarmMux);
 
-  AlarmItem* newAlarm = NULL;
-  DynamicJsonDocument body(1024);
+  return slot;
+}
 
-  deserializeJson(body, data, len);
+// Returns the label entry holding this text, adding one if needed, with
+// its reference count raised. -1 when out of entries or arena space.
+// Caller holds alarmMux.
+int alarmLabelIntern(const char* label, size_t length) {
+  int freeEntry = -1;
+
+  for (int i = 0; i < ALARM_LABELS; i++) {
+    AlarmLabel* entry = &alarmLabels[i];
+    if (entry->refs == 0) {
+      if (freeEntry < 0) freeEntry = i;
+      continue;
+    }
+    if (entry->length == length && memcmp(alarmLabelArena + entry->offset, label, length) == 0) {
+      entry->refs++;
+      return i;
+    }
+  }
+  if (freeEntry < 0) return -1;
 
-  newAlarm = (AlarmItem*)pvPortMalloc(sizeof(AlarmItem));
+  if (alarmLabelArenaUsed + length > ALARM_LABEL_ARENA) alarmLabelCompact();
+  if (alarmLabelArenaUsed + length > ALARM_LABEL_ARENA) return -1;
 
-  strcpy(newAlarm->label, body["label"]);
-  strcpy(newAlarm->time, body["time"]);
-  newAlarm->index = alarmIndex;
+  AlarmLabel* entry = &alarmLabels[freeEntry];
+  entry->offset = alarmLabelArenaUsed;
+  entry->length = length;
+  entry->refs = 1;
+  memcpy(alarmLabelArena + entry->offset, label, length);
+  alarmLabelArenaUsed += length;
 
-  alarmLists[alarmIndex] = (*newAlarm);
+  return freeEntry;
 }
 
-void parseDeleteAlarm(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t total) {
-  DynamicJsonDocument body(1024);
+// Caller holds alarmMux
+void alarmLabelRelease(uint8_t label) {
+  if (alarmLabels[label].refs > 0) alarmLabels[label].refs--;
+}
 
-  deserializeJson(body, data, len);
+// Slides live labels down over the space of released ones, lowest offset
+// first so a move never overwrites a label still to be moved. The live
+// entries are gathered and sorted once, O(n log n) under the lock.
+// Caller holds alarmMux.
+void alarmLabelCompact() {
+  uint8_t live[ALARM_LABELS];
+  int count = 0;
+  for (int i = 0; i < ALARM_LABELS; i++) {
+    if (alarmLabels[i].refs > 0) live[count++] = i;
+  }
+  std::sort(live, live + count, [](uint8_t a, uint8_t b) { return alarmLabels[a].offset < alarmLabels[b].offset; });
+
+  uint16_t used = 0;
+  for (int i = 0; i < count; i++) {
+    AlarmLabel* entry = &alarmLabels[live[i]];
+    memmove(alarmLabelArena + used, alarmLabelArena + entry->offset, entry->length);
+    entry->offset = used;
+    used += entry->length;
+  }
 
-  int idx = body["index"];
+  alarmLabelArenaUsed = used;
+}
 
-  alarmLists[idx].index = -1;
-  // alarmLists[idx].label = "";
-  // alarmLists[idx].time = "";
+void historyInit() {
+  for (int m = 0; m < HISTORY_METRICS; m++) {
+    HistoryRecord* records = historyRecords[m];
+    for (int t = 0; t < HISTORY_TIERS; t++) {
+      HistoryTier* tier = &historyTiers[m][t];
+      memset(tier, 0, sizeof(HistoryTier));
+      tier->step = HISTORY_TIER_STEP[t];
+      tier->capacity = HISTORY_TIER_LEN[t];
+      tier->records = records;
+      records += tier->capacity;
+    }
+  }
 }
 
-void startWebServer() {
-  // DefaultHeaders::Instance().addHeader("Access-Control-Allow-Origin", "*");
+// Folds one sample into the open bucket of every tier. Samples older than
+// the open bucket (late frames, clock stepped back) land in it as well.
+void historyAdd(uint8_t metric, uint32_t time, int32_t value) {
+  if (time < TIME_VALID_EPOCH) return;
+  value = constrain(value, HISTORY_VALUE_MIN, HISTORY_VALUE_MAX);
+
+  bool persist = false;
+  portENTER_CRITICAL(&historyMux);
+  for (int t = 0; t < HISTORY_TIERS; t++) {
+    HistoryTier* tier = &historyTiers[metric][t];
+    uint32_t start = time - time % tier->step;
+
+    if (tier->openCount > 0 && start > tier->openStart) {
+      int32_t avg = tier->openSum / tier->openCount;
+      historyPush(tier, tier->openStart, true, avg, tier->openMin, tier->openMax);
+      tier->openCount = 0;
+
+      if (t == HISTORY_PERSIST_TIER) {
+        if (historyPersistCount < HISTORY_PERSIST_QUEUE) {
+          historyPersistQueue[historyPersistCount++] = {
+            tier->openStart, metric, (int16_t)tier->openMin, (int16_t)avg, (int16_t)tier->openMax
+          };
+          persist = true;
+        } else {
+          historyPersistDropped++;
+        }
+      }
+    }
 
-  webDashboard();
-  webGetAlarm();
-  webAddAlarm();
-  webDeleteAlarm();
+    if (tier->openCount == 0) {
+      tier->openStart = start;
+      tier->openMin = value;
+      tier->openMax = value;
+      tier->openSum = 0;
+    }
+    tier->openMin = min(tier->openMin, value);
+    tier->openMax = max(tier->openMax, value);
+    tier->openSum += value;
+    tier->openCount++;
+  }
+  portEXIT_CRITICAL(&historyMux);
 
-  // Start the server
-  Serial.println("Starting the web server...");
-  server.begin();
-  Serial.println("Web server started.");
+  if (persist && taskHandleStorage != NULL) xTaskNotifyGive(taskHandleStorage);
 }
 
-void OnDataRecv(const esp_now_recv_info_t* info, const uint8_t* incomingData, int len) {
-  memcpy(&sensorData, incomingData, sizeof(sensorData));
+// Appends one closed bucket, preceded by gap records for any buckets
+// skipped since the last one. Caller holds historyMux.
+void historyPush(HistoryTier* tier, uint32_t start, bool hasData, int32_t avg, int32_t min, int32_t max) {
+  // Keep buckets contiguous so a record's time follows from its seq.
+  // At most one ring's worth of gaps, anything older is overwritten anyway.
+  if (tier->seq > 0 && start > tier->lastStart + tier->step) {
+    uint32_t missing = (start - tier->lastStart) / tier->step - 1;
+    if (missing > tier->capacity) missing = tier->capacity;
+    for (uint32_t n = missing; n > 0; n--) {
+      historyAppend(tier, start - n * tier->step, false, 0, 0, 0);
+    }
+  }
+
+  historyAppend(tier, start, hasData, avg, min, max);
+}
+
+// Caller holds historyMux
+void historyAppend(HistoryTier* tier, uint32_t start, bool hasData, int32_t avg, int32_t min, int32_t max) {
+  if (tier->count == tier->capacity) {
+    const HistoryRecord* oldest = &tier->records[(tier->seq - tier->count) % tier->capacity];
+    if (oldest->delta != HISTORY_GAP) {
+      tier->base += oldest->delta;
+      tier->dataCount--;
+    }
+    tier->count--;
+  }
+
+  HistoryRecord* record = &tier->records[tier->seq % tier->capacity];
+  if (hasData) {
+    // Nothing left to decode against, restart the chain at this value
+    if (tier->dataCount == 0) {
+      tier->base = avg;
+      tier->last = avg;
+    }
+
+    // Values are within HISTORY_VALUE_MIN..MAX, so all three fit exactly
+    record->delta = avg - tier->last;
+    record->below = avg - min;
+    record->above = max - avg;
+    tier->last = avg;
+    tier->dataCount++;
+  } else {
+    record->delta = HISTORY_GAP;
+    record->below = 0;
+    record->above = 0;
+  }
+
+  tier->seq++;
+  tier->count++;
+  tier->lastStart = start;
+}
+
+// Replays one logged bucket into the persisted tier. Buckets the tier
+// already holds are skipped, which makes replaying a batch twice harmless.
+void historyRestore(const LogHistoryBucket& bucket) {
+  if (bucket.metric >= HISTORY_METRICS) return;
+
+  portENTER_CRITICAL(&historyMux);
+  HistoryTier* tier = &historyTiers[bucket.metric][HISTORY_PERSIST_TIER];
+  if (tier->seq == 0 || bucket.start > tier->lastStart) {
+    historyPush(tier, bucket.start, true, bucket.avg, bucket.min, bucket.max);
+  }
+  portEXIT_CRITICAL(&historyMux);
+}
+
+void taskStorage(void* parameters) {
+  // Flash writes are slow and block, so they all happen here instead of
+  // in the web handlers or the sensor tasks that produce the changes
+  while (1) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    storageFlushAlarms();
+    storageCollectHistory();
+
+    if (logNeedsCompaction || logIndex.length + logAppendsSinceIndex * LOG_RECORD_SIZE > LOG_COMPACT_BYTES) {
+      storageCompact();
+    }
+  }
+
+  vTaskDelete(NULL);
+}
+
+void storageInit() {
+  memset(&logHistoryBatch, 0, sizeof(logHistoryBatch));
+
+  if (!LittleFS.begin(true)) {
+    LOG_ERROR("Error mounting LittleFS, alarms will not be saved");
+    return;
+  }
+
+  storageReplay();
+  LOG_INFO("Storage log replayed, %lu records, %lu corrupt",
+           (unsigned long)logRecordsReplayed, (unsigned long)logRecordsCorrupt);
+
+  // A torn tail can't be appended after, rewrite the log from RAM first
+  if (logNeedsCompaction) {
+    storageCompact();
+  } else {
+    logFile = LittleFS.open(LOG_PATH, "a");
+  }
+
+  xTaskCreatePinnedToCore(taskStorage, "Task Storage", 4096, NULL,
+                          deadlinePriority(DEADLINE_STORAGE_MS), &taskHandleStorage, CORE_APP);
+}
+
+// Rebuilds alarms and the persisted history tier from the log. With a
+// valid index only the indexed alarm records, the history range and the
+// tail written after the index are read.
+void storageReplay() {
+  logIndex.length = 0;
+  logIndex.seq = 0;
+  logIndex.historyOffset = 0;
+  for (int i = 0; i < MAX_ALARM; i++) logIndex.alarmOffset[i] = LOG_NO_RECORD;
+
+  File file = LittleFS.open(LOG_PATH, "r");
+  if (!file) return;
+  uint32_t size = file.size();
+
+  LogRecord record;
+  LogIndex index;
+  File indexFile = LittleFS.open(LOG_INDEX_PATH, "r");
+  bool indexed = indexFile && indexFile.read((uint8_t*)&index, sizeof(index)) == sizeof(index)
+                 && index.crc == crc32_le(0, (const uint8_t*)&index, offsetof(LogIndex, crc))
+                 && index.length <= size && index.length % LOG_RECORD_SIZE == 0;
+  if (indexFile) indexFile.close();
+
+  uint32_t offset = 0;
+  if (indexed) {
+    logIndex = index;
+    for (int i = 0; i < MAX_ALARM; i++) {
+      if (index.alarmOffset[i] == LOG_NO_RECORD) continue;
+      if (storageReadRecord(file, index.alarmOffset[i], record) && record.type == LOG_ALARM) {
+        storageApply(record, index.alarmOffset[i]);
+      } else {
+        logIndex.alarmOffset[i] = LOG_NO_RECORD;
+        logRecordsCorrupt++;
+      }
+    }
+
+    for (offset = index.historyOffset; offset < index.length; offset += LOG_RECORD_SIZE) {
+      if (!storageReadRecord(file, offset, record)) {
+        logRecordsCorrupt++;
+        continue;
+      }
+      if (record.type == LOG_HISTORY) storageApply(record, offset);
+    }
+    offset = index.length;
+  }
+
+  // Tail after the index (or everything without one), up to the first bad record
+  for (; offset + LOG_RECORD_SIZE <= size; offset += LOG_RECORD_SIZE) {
+    if (!storageReadRecord(file, offset, record)) {
+      logRecordsCorrupt++;
+      break;
+    }
+    storageApply(record, offset);
+    logIndex.seq = record.seq + 1;
+  }
+  if (offset != size) logNeedsCompaction = true;
+
+  // Appends continue after the replayed prefix
+  logAppendsSinceIndex = (offset - logIndex.length) / LOG_RECORD_SIZE;
+  file.close();
+}
+
+bool storageReadRecord(File& file, uint32_t offset, LogRecord& record) {
+  if (!file.seek(offset) || file.read((uint8_t*)&record, sizeof(record)) != sizeof(record)) return false;
+  if (record.magic != LOG_MAGIC) return false;
+  if (record.crc != crc32_le(0, (const uint8_t*)&record, offsetof(LogRecord, crc))) return false;
+  if (record.type == LOG_HISTORY && record.count > LOG_HISTORY_BATCH) return false;
+  return true;
+}
+
+void storageApply(const LogRecord& record, uint32_t offset) {
+  logRecordsReplayed++;
+
+  if (record.type == LOG_ALARM || record.type == LOG_ALARM_DELETE) {
+    int slot = record.alarm.slot;
+    if (slot >= MAX_ALARM) return;
+
+    // Slots are set directly here, setup() rebuilds the free list after
+    portENTER_CRITICAL(&alarmMux);
+    bool stored = record.type == LOG_ALARM && record.alarm.entry.seconds < SECONDS_PER_DAY
+                  && alarmSet(slot, record.alarm.entry);
+    if (!stored) alarmClear(slot);
+    portEXIT_CRITICAL(&alarmMux);
+
+    logIndex.alarmOffset[slot] = stored ? offset : LOG_NO_RECORD;
+  } else if (record.type == LOG_HISTORY) {
+    for (int i = 0; i < record.count; i++) historyRestore(record.buckets[i]);
+  }
+}
+
+// Returns the offset the record was written at, or LOG_NO_RECORD
+uint32_t storageAppend(LogRecord& record) {
+  if (!logFile) return LOG_NO_RECORD;
+
+  uint32_t offset = logIndex.length + logAppendsSinceIndex * LOG_RECORD_SIZE;
+  record.magic = LOG_MAGIC;
+  record.seq = logIndex.seq++;
+  record.crc = crc32_le(0, (const uint8_t*)&record, offsetof(LogRecord, crc));
+
+  if (logFile.write((const uint8_t*)&record, sizeof(record)) != sizeof(record)) {
+    // Whatever part did land is a torn record, compact it away
+    logNeedsCompaction = true;
+    return LOG_NO_RECORD;
+  }
+  logFile.flush();
+
+  // Before the index below can be written with it
+  if (record.type == LOG_ALARM || record.type == LOG_ALARM_DELETE) {
+    logIndex.alarmOffset[record.alarm.slot] = record.type == LOG_ALARM ? offset : LOG_NO_RECORD;
+  }
+
+  if (++logAppendsSinceIndex >= LOG_INDEX_INTERVAL && !logCompacting) storageWriteIndex();
+  return offset;
+}
+
+// Written to a temporary file and renamed, so a power cut leaves either
+// the old or the new index, never half of one
+void storageWriteIndex() {
+  logIndex.length += logAppendsSinceIndex * LOG_RECORD_SIZE;
+  logAppendsSinceIndex = 0;
+  logIndex.crc = crc32_le(0, (const uint8_t*)&logIndex, offsetof(LogIndex, crc));
 
-  // Serial.printf("T: %.2f C\n", sensorData.T);
-  // Serial.printf("H: %.2f %\n", sensorData.H);
+  File file = LittleFS.open(LOG_INDEX_TMP_PATH, "w");
+  if (!file) return;
+  bool written = file.write((const uint8_t*)&logIndex, sizeof(logIndex)) == sizeof(logIndex);
+  file.close();
 
-  String json = "{";
-  json += "\"T\":\"" + String((int)sensorData.T) + "\"";
-  json += ",\"H\":\"" + String((int)sensorData.H) + "\"}";
+  if (written) LittleFS.rename(LOG_INDEX_TMP_PATH, LOG_INDEX_PATH);
+}
+
+void storageFlushAlarms() {
+  uint32_t dirty[(MAX_ALARM + 31) / 32];
+  portENTER_CRITICAL(&alarmMux);
+  memcpy(dirty, storageAlarmDirtyBits, sizeof(dirty));
+  memset(storageAlarmDirtyBits, 0, sizeof(storageAlarmDirtyBits));
+  portEXIT_CRITICAL(&alarmMux);
+
+  for (int slot = 0; slot < MAX_ALARM; slot++) {
+    if (!(dirty[slot / 32] & (1UL << (slot % 32)))) continue;
+
+    LogRecord record;
+    memset(&record, 0, sizeof(record));
+    record.type = alarmGet(slot, record.alarm.entry) ? LOG_ALARM : LOG_ALARM_DELETE;
+    record.alarm.slot = slot;
+    storageAppend(record);
+  }
+}
+
+// Moves closed buckets into the pending batch and appends it once full,
+// so the log grows by one record per LOG_HISTORY_BATCH buckets
+void storageCollectHistory() {
+  LogHistoryBucket buckets[HISTORY_PERSIST_QUEUE];
+
+  portENTER_CRITICAL(&historyMux);
+  int count = historyPersistCount;
+  memcpy(buckets, historyPersistQueue, count * sizeof(LogHistoryBucket));
+  historyPersistCount = 0;
+  portEXIT_CRITICAL(&historyMux);
+
+  for (int i = 0; i < count; i++) {
+    logHistoryBatch.buckets[logHistoryBatch.count++] = buckets[i];
+    if (logHistoryBatch.count < LOG_HISTORY_BATCH) continue;
+
+    logHistoryBatch.type = LOG_HISTORY;
+    storageAppend(logHistoryBatch);
+    memset(&logHistoryBatch, 0, sizeof(logHistoryBatch));
+  }
+}
+
+// Rewrites the log with only live state: one record per alarm, then the
+// persisted history tier as read back from RAM. Superseded alarm records,
+// expired history and any torn tail are dropped. The index is written once,
+// after the new log replaced the old one; if any write fails the old log
+// and its index stay as they were.
+void storageCompact() {
+  if (logFile) logFile.close();
+
+  LogIndex previousIndex = logIndex;
+  uint32_t previousAppends = logAppendsSinceIndex;
+  logIndex.length = 0;
+  logIndex.historyOffset = 0;
+  logAppendsSinceIndex = 0;
+  for (int i = 0; i < MAX_ALARM; i++) logIndex.alarmOffset[i] = LOG_NO_RECORD;
+
+  logFile = LittleFS.open(LOG_COMPACT_PATH, "w");
+  logCompacting = true;
+  bool written = (bool)logFile;
+
+  // Alarm records first, the boot replay reads them by offset
+  portENTER_CRITICAL(&alarmMux);
+  memset(storageAlarmDirtyBits, 0, sizeof(storageAlarmDirtyBits));
+  portEXIT_CRITICAL(&alarmMux);
+
+  for (int slot = 0; slot < MAX_ALARM; slot++) {
+    LogRecord record;
+    memset(&record, 0, sizeof(record));
+    if (!alarmGet(slot, record.alarm.entry)) continue;
+
+    record.type = LOG_ALARM;
+    record.alarm.slot = slot;
+    written = written && storageAppend(record) != LOG_NO_RECORD;
+  }
+  logIndex.historyOffset = logFile.position();
+
+  // Everything queued or batched is already in the RAM tier
+  portENTER_CRITICAL(&historyMux);
+  historyPersistCount = 0;
+  portEXIT_CRITICAL(&historyMux);
+  memset(&logHistoryBatch, 0, sizeof(logHistoryBatch));
+
+  for (int m = 0; m < HISTORY_METRICS; m++) {
+    HistoryJsonWriter writer;
+    writer.metric = m;
+    writer.tier = HISTORY_PERSIST_TIER;
+    writer.from = 0;
+    writer.started = false;
+    writer.done = false;
+
+    // Stop before the open bucket, it is logged once it closes
+    portENTER_CRITICAL(&historyMux);
+    writer.to = historyTiers[m][HISTORY_PERSIST_TIER].lastStart;
+    portEXIT_CRITICAL(&historyMux);
+
+    HistoryPoint points[HISTORY_JSON_BATCH];
+    int count;
+    while ((count = historyDecode(writer, points, HISTORY_JSON_BATCH)) > 0) {
+      for (int i = 0; i < count; i++) {
+        logHistoryBatch.buckets[logHistoryBatch.count++] = {
+          points[i].time, (uint8_t)m, (int16_t)points[i].min, (int16_t)points[i].avg, (int16_t)points[i].max
+        };
+        if (logHistoryBatch.count < LOG_HISTORY_BATCH) continue;
+
+        logHistoryBatch.type = LOG_HISTORY;
+        written = written && storageAppend(logHistoryBatch) != LOG_NO_RECORD;
+        memset(&logHistoryBatch, 0, sizeof(logHistoryBatch));
+      }
+    }
+  }
+  if (logFile) logFile.close();
+  logCompacting = false;
+
+  // Drop the index first: a power cut before it is rewritten means a full
+  // scan of the new log, never stale offsets into it
+  if (written && LittleFS.exists(LOG_INDEX_PATH)) written = LittleFS.remove(LOG_INDEX_PATH);
+  if (!written || !LittleFS.rename(LOG_COMPACT_PATH, LOG_PATH)) {
+    LOG_ERROR("Error compacting the storage log");
+    LittleFS.remove(LOG_COMPACT_PATH);
+    logIndex = previousIndex;
+    logAppendsSinceIndex = previousAppends;
+    logNeedsCompaction = true;
+    logFile = LittleFS.open(LOG_PATH, "a");
+    return;
+  }
+  logFile = LittleFS.open(LOG_PATH, "a");
+  storageWriteIndex();
+
+  logNeedsCompaction = false;
+  logCompactions++;
+}
+
+// Called by the alarm handlers after a slot changed. Takes alarmMux.
+void storageAlarmChanged(int slot) {
+  if (slot < 0 || slot >= MAX_ALARM) return;
+
+  portENTER_CRITICAL(&alarmMux);
+  storageAlarmDirty(slot);
+  portEXIT_CRITICAL(&alarmMux);
+
+  if (taskHandleStorage != NULL) xTaskNotifyGive(taskHandleStorage);
+}
+
+// Caller holds alarmMux and notifies taskStorage afterwards
+void storageAlarmDirty(int slot) {
+  storageAlarmDirtyBits[slot / 32] |= 1UL << (slot % 32);
+}
+
+void webDashboard() {
+  // Page is pre-minified and gzipped by tools/build_dashboard.py.
+  // Browsers revalidate with If-None-Match and get an empty 304 back
+  // as long as the firmware (and so the ETag) has not changed.
+  server.on("/", HTTP_GET, metricTimed(METRIC_HTTP_DASHBOARD, [](AsyncWebServerRequest* request) {
+    if (request->hasHeader("If-None-Match")) {
+      const String& etags = request->header("If-None-Match");
+      if (etags == "*" || etags.indexOf(DASHBOARD_HTML_GZ_ETAG) >= 0) {
+        AsyncWebServerResponse* response = request->beginResponse(304);
+        response->addHeader("ETag", DASHBOARD_HTML_GZ_ETAG);
+        response->addHeader("Cache-Control", "no-cache");
+        request->send(response);
+        return;
+      }
+    }
+
+    AsyncWebServerResponse* response = request->beginResponse_P(
+      200, "text/html", DASHBOARD_HTML_GZ, DASHBOARD_HTML_GZ_LEN);
+    response->addHeader("Content-Encoding", "gzip");
+    response->addHeader("ETag", DASHBOARD_HTML_GZ_ETAG);
+    response->addHeader("Cache-Control", "no-cache");
+    request->send(response);
+    }));
+}
+
+void webAssets() {
+  // Content-hashed, gzipped files from the LittleFS image (data/a/, see
+  // tools/build_dashboard.py). A URL never changes content, so browsers
+  // keep them for a year without revalidating.
+  for (size_t i = 0; i < DASHBOARD_ASSET_COUNT; i++) {
+    const DashboardAsset* asset = &DASHBOARD_ASSETS[i];
+    server.on(asset->url, HTTP_GET, metricTimed(METRIC_HTTP_ASSET, [asset](AsyncWebServerRequest* request) {
+      if (!LittleFS.exists(asset->path)) {
+        request->send(404, "text/plain", "Asset missing, upload the LittleFS image");
+        return;
+      }
+
+      AsyncWebServerResponse* response = request->beginResponse(LittleFS, asset->path, asset->contentType);
+      response->addHeader("Content-Encoding", "gzip");
+      response->addHeader("Cache-Control", "public, max-age=31536000, immutable");
+      request->send(response);
+      }));
+  }
+}
 
-  webSocketDht.broadcastTXT(json);
+void webGetAlarm() {
+  // GET /alarm?start=<id>&limit=<n>, one page of alarms with id >= start.
+  // "next" is the start of the following page, -1 after the last one.
+  // "revision" is where TOPIC_ALARM_SYNC events pick up from.
+  // Streamed as a chunked response straight into the TCP buffer,
+  // one alarm at a time, without building the body on the heap
+  server.on("/alarm", HTTP_GET, metricTimed(METRIC_HTTP_ALARM_GET, [](AsyncWebServerRequest* request) {
+    int start = request->hasParam("start") ? atoi(request->getParam("start")->value().c_str()) : 0;
+    int limit = request->hasParam("limit") ? atoi(request->getParam("limit")->value().c_str()) : ALARM_PAGE_DEFAULT;
+
+    AlarmJsonWriter writer;
+    writer.next = constrain(start, 0, MAX_ALARM);
+    writer.remaining = constrain(limit, 1, ALARM_PAGE_MAX);
+    writer.first = true;
+    portENTER_CRITICAL(&alarmMux);
+    writer.revision = alarmRevision;
+    portEXIT_CRITICAL(&alarmMux);
+    writer.length = strlcpy(writer.record, "{\"alarms\":[", sizeof(writer.record));
+    writer.sent = 0;
+
+    request->send(request->beginChunkedResponse("application/json",
+      [writer](uint8_t* buffer, size_t maxLen, size_t index) mutable -> size_t {
+        return fillAlarmJson(writer, buffer, maxLen);
+      }));
+    }));
+}
+
+size_t jsonEscape(char* out, const char* in, size_t inMax) {
+  static const char hex[] = "0123456789abcdef";
+  char* p = out;
+
+  for (size_t i = 0; i < inMax && in[i] != '\0'; i++) {
+    uint8_t c = in[i];
+    if (c == '"' || c == '\\') {
+      *p++ = '\\';
+      *p++ = c;
+    } else if (c < 0x20) {
+      memcpy(p, "\\u00", 4);
+      p[4] = hex[c >> 4];
+      p[5] = hex[c & 0xf];
+      p += 6;
+    } else {
+      *p++ = c;
+    }
+  }
+
+  return p - out;
+}
+
+// Renders one alarm object into out (at least ALARM_JSON_RECORD_MAX bytes),
+// prefixed with a comma unless first. Returns 0 for a free slot.
+size_t renderAlarmJson(char* out, int slot, bool first) {
+  AlarmEntry alarm;
+  if (!alarmGet(slot, alarm)) return 0;
+
+  char* p = out;
+  p += sprintf(p, "%s{\"id\":%d,\"time\":\"%02lu:%02lu:%02lu\",\"days\":%u,\"enabled\":%s,\"label\":\"",
+               first ? "" : ",", slot, (unsigned long)(alarm.seconds / 3600), (unsigned long)(alarm.seconds / 60 % 60),
+               (unsigned long)(alarm.seconds % 60), alarm.days, (alarm.flags & ALARM_ENABLED) ? "true" : "false");
+  p += jsonEscape(p, alarm.label, sizeof(alarm.label));
+  p += sprintf(p, "\"}");
+
+  return p - out;
+}
+
+// Chunk filler for GET /alarm. Records are rendered in place when the
+// chunk has room, otherwise into writer.record and drained over calls.
+size_t fillAlarmJson(AlarmJsonWriter& writer, uint8_t* buffer, size_t maxLen) {
+  size_t written = 0;
+
+  while (written < maxLen) {
+    if (writer.sent < writer.length) {
+      size_t n = min(writer.length - writer.sent, maxLen - written);
+      memcpy(buffer + written, writer.record + writer.sent, n);
+      writer.sent += n;
+      written += n;
+      continue;
+    }
+
+    if (writer.next > MAX_ALARM) break;
+
+    bool inPlace = maxLen - written >= ALARM_JSON_RECORD_MAX;
+    char* out = inPlace ? (char*)buffer + written : writer.record;
+    size_t n;
+    if (writer.next < MAX_ALARM && writer.remaining > 0) {
+      n = renderAlarmJson(out, writer.next, writer.first);
+      writer.next++;
+      if (n == 0) continue;
+      writer.first = false;
+      writer.remaining--;
+    } else {
+      n = sprintf(out, "],\"count\":%d,\"next\":%d,\"revision\":%lu}", alarmCount, alarmNextUsed(writer.next),
+                  (unsigned long)writer.revision);
+      writer.next = MAX_ALARM + 1;
+    }
+
+    if (inPlace) {
+      written += n;
+    } else {
+      writer.length = n;
+      writer.sent = 0;
+    }
+  }
+
+  return written;
+}
+
+void webGetNodes() {
+  server.on("/nodes", HTTP_GET, metricTimed(METRIC_HTTP_NODES, [](AsyncWebServerRequest* request) {
+    uint32_t now = millis();
+
+    portENTER_CRITICAL(&sensorNodesMux);
+    sensorNodeEvictStale(now);
+    portEXIT_CRITICAL(&sensorNodesMux);
+
+    AsyncResponseStream* response = request->beginResponseStream("application/json");
+    response->print("{\"nodes\":[");
+
+    bool first = true;
+    for (int i = 0; i < MAX_SENSOR_NODES; i++) {
+      SensorNode node;
+      portENTER_CRITICAL(&sensorNodesMux);
+      bool active = sensorNodeKeys[i] != 0;
+      if (active) node = sensorNodes[i];
+      portEXIT_CRITICAL(&sensorNodesMux);
+
+      if (!active) continue;
+
+      response->printf("%s{\"slot\":%d,\"mac\":\"%02x:%02x:%02x:%02x:%02x:%02x\",\"id\":%u,"
+                       "\"T\":%.1f,\"H\":%.1f,\"rssi\":%d,\"age\":%lu,\"received\":%lu,\"lost\":%lu,\"restarts\":%lu}",
+                       first ? "" : ",", i,
+                       node.mac[0], node.mac[1], node.mac[2], node.mac[3], node.mac[4], node.mac[5],
+                       node.sensorId, node.latest.T / 10.0, node.latest.H / 10.0, node.rssi,
+                       (unsigned long)(now - node.lastSeenMs),
+                       (unsigned long)node.framesReceived, (unsigned long)node.framesLost,
+                       (unsigned long)node.restarts);
+      first = false;
+    }
+
+    response->print("]}");
+    request->send(response);
+    }));
+}
+
+void webGetClients() {
+  // GET /clients: per-client send backlog. pending counts values owed to
+  // the client, queue the frames already handed to AsyncWebSocket.
+  server.on("/clients", HTTP_GET, metricTimed(METRIC_HTTP_CLIENTS, [](AsyncWebServerRequest* request) {
+    WsSubscriber subs[MAX_WS_CLIENTS];
+    uint32_t now = millis();
+
+    portENTER_CRITICAL(&wsSubscribersMux);
+    memcpy(subs, wsSubscribers, sizeof(subs));
+    uint32_t coalesced = wsCoalesced;
+    uint32_t dropped = wsDropped;
+    uint32_t stalledDisconnects = wsStalledDisconnects;
+    portEXIT_CRITICAL(&wsSubscribersMux);
+
+    AsyncResponseStream* response = request->beginResponseStream("application/json");
+    response->print("{\"clients\":[");
+
+    bool first = true;
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+      if (subs[i].clientId == 0) continue;
+      AsyncWebSocketClient* client = telemetry.client(subs[i].clientId);
+
+      response->printf("%s{\"id\":%lu,\"topics\":%u,\"queue\":%u,\"pending\":%d,\"sent\":%lu,"
+                       "\"coalesced\":%lu,\"dropped\":%lu,\"stalled\":%lu}",
+                       first ? "" : ",", (unsigned long)subs[i].clientId, subs[i].topics,
+                       client != NULL ? (unsigned)client->queueLen() : 0, __builtin_popcountll(subs[i].pending),
+                       (unsigned long)subs[i].sent, (unsigned long)subs[i].coalesced, (unsigned long)subs[i].dropped,
+                       (unsigned long)(subs[i].stalledSinceMs == 0 ? 0 : now - subs[i].stalledSinceMs));
+      first = false;
+    }
+
+    response->printf("],\"coalesced\":%lu,\"dropped\":%lu,\"stalledDisconnects\":%lu}",
+                     (unsigned long)coalesced, (unsigned long)dropped, (unsigned long)stalledDisconnects);
+    request->send(response);
+    }));
+}
+
+void webGetMetrics() {
+  // GET /metrics in Prometheus text format. Counters only ever grow, so
+  // rates (ESP-NOW frames/s, drops/s) come from rate() on the scraper.
+  server.on("/metrics", HTTP_GET, metricTimed(METRIC_HTTP_METRICS, [](AsyncWebServerRequest* request) {
+    AsyncResponseStream* response = request->beginResponseStream("text/plain; version=0.0.4");
+
+    const struct {
+      const char* name;
+      TaskHandle_t handle;
+    } tasks[] = {
+      { "update_time", taskHandleUpdateTime },
+      { "air_pollution", taskHandleAirPollutionSensor },
+      { "alarm_scheduler", taskHandleAlarmScheduler },
+      { "sensor_consumer", taskHandleSensorConsumer },
+      { "storage", taskHandleStorage },
+      { "telemetry", taskHandleTelemetry },
+      { "log_drain", logTaskHandle },
+    };
+    response->print("# HELP clock_task_stack_free_min_bytes Lowest free stack seen per task.\n"
+                    "# TYPE clock_task_stack_free_min_bytes gauge\n");
+    for (size_t i = 0; i < sizeof(tasks) / sizeof(tasks[0]); i++) {
+      // A NULL handle would report the caller's own stack
+      if (tasks[i].handle == NULL) continue;
+      response->printf("clock_task_stack_free_min_bytes{task=\"%s\"} %u\n",
+                       tasks[i].name, (unsigned)uxTaskGetStackHighWaterMark(tasks[i].handle));
+    }
+
+    response->printf("# HELP clock_heap_free_bytes Free heap.\n"
+                     "# TYPE clock_heap_free_bytes gauge\n"
+                     "clock_heap_free_bytes %lu\n"
+                     "# HELP clock_heap_free_min_bytes Lowest free heap since boot.\n"
+                     "# TYPE clock_heap_free_min_bytes gauge\n"
+                     "clock_heap_free_min_bytes %lu\n"
+                     "# HELP clock_heap_largest_free_block_bytes Largest single allocation possible, fragmentation shows as a gap to free.\n"
+                     "# TYPE clock_heap_largest_free_block_bytes gauge\n"
+                     "clock_heap_largest_free_block_bytes %lu\n",
+                     (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMinFreeHeap(),
+                     (unsigned long)ESP.getMaxAllocHeap());
+
+    portENTER_CRITICAL(&wsSubscribersMux);
+    uint32_t coalesced = wsCoalesced;
+    uint32_t dropped = wsDropped;
+    uint32_t stalledDisconnects = wsStalledDisconnects;
+    int subscribers = 0;
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+      if (wsSubscribers[i].clientId != 0) subscribers++;
+    }
+    portEXIT_CRITICAL(&wsSubscribersMux);
+
+    response->printf("# HELP clock_ws_clients Connected telemetry WebSocket clients.\n"
+                     "# TYPE clock_ws_clients gauge\n"
+                     "clock_ws_clients %d\n"
+                     "# HELP clock_ws_coalesced_total Updates replaced by a newer value before they were sent.\n"
+                     "# TYPE clock_ws_coalesced_total counter\n"
+                     "clock_ws_coalesced_total %lu\n"
+                     "# HELP clock_ws_dropped_total Frames refused by a full client or telemetry queue.\n"
+                     "# TYPE clock_ws_dropped_total counter\n"
+                     "clock_ws_dropped_total %lu\n"
+                     "# HELP clock_ws_stalled_disconnects_total Clients closed for not draining their queue.\n"
+                     "# TYPE clock_ws_stalled_disconnects_total counter\n"
+                     "clock_ws_stalled_disconnects_total %lu\n",
+                     subscribers, (unsigned long)coalesced, (unsigned long)dropped, (unsigned long)stalledDisconnects);
+
+    portENTER_CRITICAL(&sensorNodesMux);
+    uint32_t rejected = sensorFramesRejected;
+    uint32_t evicted = sensorNodesEvicted;
+    uint32_t lost = 0;
+    int nodes = 0;
+    for (int i = 0; i < MAX_SENSOR_NODES; i++) {
+      if (sensorNodeKeys[i] == 0) continue;
+      lost += sensorNodes[i].framesLost;
+      nodes++;
+    }
+    portEXIT_CRITICAL(&sensorNodesMux);
+
+    response->printf("# HELP clock_espnow_frames_total ESP-NOW frames by what happened to them.\n"
+                     "# TYPE clock_espnow_frames_total counter\n"
+                     "clock_espnow_frames_total{result=\"queued\"} %lu\n"
+                     "clock_espnow_frames_total{result=\"overflow\"} %lu\n"
+                     "clock_espnow_frames_total{result=\"rejected\"} %lu\n"
+                     "# HELP clock_espnow_frames_lost_total Sequence gaps summed over the current nodes.\n"
+                     "# TYPE clock_espnow_frames_lost_total counter\n"
+                     "clock_espnow_frames_lost_total %lu\n"
+                     "# HELP clock_espnow_queue_max_depth Deepest the receive ring has been.\n"
+                     "# TYPE clock_espnow_queue_max_depth gauge\n"
+                     "clock_espnow_queue_max_depth %lu\n"
+                     "# HELP clock_sensor_nodes Sensor nodes heard from recently.\n"
+                     "# TYPE clock_sensor_nodes gauge\n"
+                     "clock_sensor_nodes %d\n"
+                     "# HELP clock_sensor_nodes_evicted_total Nodes dropped after going silent.\n"
+                     "# TYPE clock_sensor_nodes_evicted_total counter\n"
+                     "clock_sensor_nodes_evicted_total %lu\n",
+                     (unsigned long)espNowRxHead.load(std::memory_order_relaxed), (unsigned long)espNowRxOverflows,
+                     (unsigned long)rejected, (unsigned long)lost, (unsigned long)espNowRxMaxDepth,
+                     nodes, (unsigned long)evicted);
+
+    response->printf("# HELP clock_http_bodies_rejected_total POST bodies refused for size or a full slot pool.\n"
+                     "# TYPE clock_http_bodies_rejected_total counter\n"
+                     "clock_http_bodies_rejected_total %lu\n",
+                     (unsigned long)requestBodiesRejected);
+
+    response->printf("# HELP clock_log_records_dropped_total Log lines overwritten before the UART drained them.\n"
+                     "# TYPE clock_log_records_dropped_total counter\n"
+                     "clock_log_records_dropped_total %lu\n",
+                     (unsigned long)logDropped.load(std::memory_order_relaxed));
+
+    const char* status = clockStatus();
+    response->printf("# HELP clock_time_synced 1 while SNTP has answered within the last few intervals.\n"
+                     "# TYPE clock_time_synced gauge\n"
+                     "clock_time_synced %d\n"
+                     "# HELP clock_time_syncs_total SNTP replies applied.\n"
+                     "# TYPE clock_time_syncs_total counter\n"
+                     "clock_time_syncs_total %lu\n",
+                     strcmp(status, "synced") == 0 || strcmp(status, "slewing") == 0,
+                     (unsigned long)clockSyncs);
+
+    MetricTimer timers[METRIC_TIMERS];
+    portENTER_CRITICAL(&metricsMux);
+    memcpy(timers, metricTimers, sizeof(timers));
+    portEXIT_CRITICAL(&metricsMux);
+
+    double cyclesPerSecond = getCpuFreqMHz() * 1e6;
+    response->print("# HELP clock_section_seconds Time spent in instrumented sections.\n"
+                    "# TYPE clock_section_seconds summary\n");
+    for (int i = 0; i < METRIC_TIMERS; i++) {
+      response->printf("clock_section_seconds_sum{section=\"%s\"} %.6f\n"
+                       "clock_section_seconds_count{section=\"%s\"} %lu\n",
+                       METRIC_TIMER_NAMES[i], timers[i].totalCycles / cyclesPerSecond,
+                       METRIC_TIMER_NAMES[i], (unsigned long)timers[i].count);
+    }
+    response->print("# HELP clock_section_seconds_max Longest single run of each section.\n"
+                    "# TYPE clock_section_seconds_max gauge\n");
+    for (int i = 0; i < METRIC_TIMERS; i++) {
+      response->printf("clock_section_seconds_max{section=\"%s\"} %.6f\n",
+                       METRIC_TIMER_NAMES[i], timers[i].maxCycles / cyclesPerSecond);
+    }
+
+    request->send(response);
+    }));
+}
+
+void webGetTime() {
+  // GET /time: the clock the dashboards are ticking and how it was set
+  server.on("/time", HTTP_GET, metricTimed(METRIC_HTTP_TIME_GET, [](AsyncWebServerRequest* request) {
+    struct timeval pending = { 0, 0 };
+    adjtime(NULL, &pending);
+    int64_t sinceSyncMs = clockLastSyncMonoUs == 0 ? -1 : (esp_timer_get_time() - clockLastSyncMonoUs) / 1000;
+
+    char body[256];
+    snprintf(body, sizeof(body),
+             "{\"now\":%lld,\"offset\":%ld,\"status\":\"%s\",\"syncs\":%lu,\"sinceSync\":%lld,\"slew\":%lld,"
+             "\"servers\":[\"" NTP_SERVER_1 "\",\"" NTP_SERVER_2 "\",\"" NTP_SERVER_3 "\"]}",
+             (long long)(clockTargetUs() / 1000), (long)clockUtcOffset, clockStatus(), (unsigned long)clockSyncs,
+             (long long)sinceSyncMs, (long long)pending.tv_sec * 1000 + pending.tv_usec / 1000);
+    request->send(200, "application/json", body);
+    }));
+}
+
+void webSetTime() {
+  // POST /time {"offset": seconds east of UTC}, saved across reboots
+  server.on("/time", HTTP_POST, metricTimed(METRIC_HTTP_TIME_POST, [](AsyncWebServerRequest* request) {
+    int result = bodyTake(request);
+    if (result < 0) {
+      request->send(-result, "application/json", bodyError(result, "{\"error\":\"invalid offset\"}"));
+      return;
+    }
+
+    request->send(200, "application/json", "{}");
+    }),
+    nullptr, metricTimedBody(METRIC_HTTP_TIME_POST, parseSetTime));
+}
+
+void webGetLogs() {
+  // GET /logs, the log lines still in the ring as plain text, oldest
+  // first. Reads with its own cursor, so the UART drain is not disturbed.
+  server.on("/logs", HTTP_GET, metricTimed(METRIC_HTTP_LOGS, [](AsyncWebServerRequest* request) {
+    LogStreamWriter writer;
+    writer.cursor = logOldest();
+    writer.skipped = 0;
+    writer.length = 0;
+    writer.sent = 0;
+
+    request->send(request->beginChunkedResponse("text/plain",
+      [writer](uint8_t* buffer, size_t maxLen, size_t index) mutable -> size_t {
+        return fillLogStream(writer, buffer, maxLen);
+      }));
+    }));
+}
+
+// Ends once it catches up with the writers, lines logged after that are
+// left for the next request
+size_t fillLogStream(LogStreamWriter& writer, uint8_t* buffer, size_t maxLen) {
+  size_t written = 0;
+  LogLine record;
+
+  while (written < maxLen) {
+    if (writer.sent < writer.length) {
+      size_t n = min(writer.length - writer.sent, maxLen - written);
+      memcpy(buffer + written, writer.line + writer.sent, n);
+      writer.sent += n;
+      written += n;
+      continue;
+    }
+
+    if (!logRead(writer.cursor, record, &writer.skipped)) break;
+
+    bool inPlace = maxLen - written >= LOG_FORMATTED_MAX;
+    char* out = inPlace ? (char*)buffer + written : writer.line;
+    size_t n = logFormat(record, out, LOG_FORMATTED_MAX);
+    if (inPlace) {
+      written += n;
+    } else {
+      writer.length = n;
+      writer.sent = 0;
+    }
+  }
+
+  return written;
+}
+
+void webGetHistory() {
+  // GET /history?metric=T|H|ppm&from=<epoch>&to=<epoch>&step=<seconds>
+  // Picks the finest tier at least step wide that still reaches back to
+  // from, and streams its buckets as [time, min, avg, max].
+  server.on("/history", HTTP_GET, metricTimed(METRIC_HTTP_HISTORY, [](AsyncWebServerRequest* request) {
+    int metric = -1;
+    if (request->hasParam("metric")) {
+      for (int m = 0; m < HISTORY_METRICS; m++) {
+        if (strcmp(request->getParam("metric")->value().c_str(), HISTORY_METRIC_NAMES[m]) == 0) metric = m;
+      }
+    }
+    if (metric < 0) {
+      request->send(400, "application/json", "{\"error\":\"unknown metric\"}");
+      return;
+    }
+
+    uint32_t now = time(NULL);
+    uint32_t to = request->hasParam("to") ? strtoul(request->getParam("to")->value().c_str(), NULL, 10) : now;
+    uint32_t from = request->hasParam("from") ? strtoul(request->getParam("from")->value().c_str(), NULL, 10) : to - 600;
+    uint32_t step = request->hasParam("step") ? strtoul(request->getParam("step")->value().c_str(), NULL, 10) : 1;
+
+    int t = 0;
+    while (t < HISTORY_TIERS - 1 && HISTORY_TIER_STEP[t] < step) t++;
+
+    portENTER_CRITICAL(&historyMux);
+    for (; t < HISTORY_TIERS - 1; t++) {
+      const HistoryTier* tier = &historyTiers[metric][t];
+      if (tier->count == tier->capacity && tier->lastStart - (tier->count - 1) * tier->step > from) continue;
+      break;
+    }
+    portEXIT_CRITICAL(&historyMux);
+
+    HistoryJsonWriter writer;
+    writer.metric = metric;
+    writer.tier = t;
+    writer.from = from;
+    writer.to = to;
+    writer.started = false;
+    writer.done = false;
+    writer.closed = false;
+    writer.comma = false;
+    writer.length = snprintf(writer.record, sizeof(writer.record), "{\"metric\":\"%s\",\"scale\":%u,\"step\":%lu,\"points\":[",
+                             HISTORY_METRIC_NAMES[metric], HISTORY_METRIC_SCALE[metric], (unsigned long)HISTORY_TIER_STEP[t]);
+    writer.sent = 0;
+
+    request->send(request->beginChunkedResponse("application/json",
+      [writer](uint8_t* buffer, size_t maxLen, size_t index) mutable -> size_t {
+        return fillHistoryJson(writer, buffer, maxLen);
+      }));
+    }));
+}
+
+// Decodes up to maxPoints buckets in [from, to] past the cursor, then the
+// still-open bucket. Returns the number of points, 0 once exhausted.
+int historyDecode(HistoryJsonWriter& writer, HistoryPoint* points, int maxPoints) {
+  int n = 0;
+  if (writer.done) return 0;
+
+  portENTER_CRITICAL(&historyMux);
+  const HistoryTier* tier = &historyTiers[writer.metric][writer.tier];
+  uint32_t oldest = tier->seq - tier->count;
+
+  // First call, or the ring overtook a slow reader
+  if (!writer.started || writer.cursor < oldest) {
+    writer.started = true;
+    writer.cursor = oldest;
+    writer.value = tier->base;
+  }
+
+  while (n < maxPoints && writer.cursor < tier->seq) {
+    const HistoryRecord* record = &tier->records[writer.cursor % tier->capacity];
+    uint32_t time = tier->lastStart - (tier->seq - 1 - writer.cursor) * tier->step;
+    writer.cursor++;
+
+    if (record->delta == HISTORY_GAP) continue;
+    writer.value += record->delta;
+
+    if (time < writer.from) continue;
+    if (time > writer.to) {
+      writer.cursor = tier->seq;
+      break;
+    }
+    points[n++] = { time, writer.value - record->below, writer.value, writer.value + record->above };
+  }
+
+  if (n < maxPoints && writer.cursor == tier->seq && !writer.done) {
+    writer.done = true;
+    if (tier->openCount > 0 && tier->openStart >= writer.from && tier->openStart <= writer.to) {
+      points[n++] = { tier->openStart, tier->openMin, tier->openSum / tier->openCount, tier->openMax };
+    }
+  }
+  portEXIT_CRITICAL(&historyMux);
+
+  return n;
+}
+
+// Chunk filler for GET /history. Points are decoded in batches under the
+// lock, rendered outside it into writer.record and drained over calls.
+size_t fillHistoryJson(HistoryJsonWriter& writer, uint8_t* buffer, size_t maxLen) {
+  size_t written = 0;
+
+  while (written < maxLen) {
+    if (writer.sent < writer.length) {
+      size_t n = min(writer.length - writer.sent, maxLen - written);
+      memcpy(buffer + written, writer.record + writer.sent, n);
+      writer.sent += n;
+      written += n;
+      continue;
+    }
+
+    if (writer.closed) break;
+
+    HistoryPoint points[HISTORY_JSON_BATCH];
+    int count = historyDecode(writer, points, HISTORY_JSON_BATCH);
+
+    char* p = writer.record;
+    for (int i = 0; i < count; i++) {
+      p += sprintf(p, "%s[%lu,%ld,%ld,%ld]", writer.comma ? "," : "", (unsigned long)points[i].time,
+                   (long)points[i].min, (long)points[i].avg, (long)points[i].max);
+      writer.comma = true;
+    }
+    if (count == 0) {
+      p += sprintf(p, "]}");
+      writer.closed = true;
+    }
+
+    writer.length = p - writer.record;
+    writer.sent = 0;
+  }
+
+  return written;
+}
+
+void webAddAlarm() {
+  // The body handler leaves the alarm id, or a negative HTTP status, in
+  // the request's body slot
+  server.on("/alarm", HTTP_POST, metricTimed(METRIC_HTTP_ALARM_POST, [](AsyncWebServerRequest* request) {
+    int result = bodyTake(request);
+    if (result < 0) {
+      request->send(-result, "application/json",
+                    bodyError(result, result == -507 ? "{\"error\":\"alarm table full\"}" : "{\"error\":\"invalid alarm\"}"));
+      return;
+    }
+
+    char body[24];
+    snprintf(body, sizeof(body), "{\"id\":%d}", result);
+    request->send(200, "application/json", body);
+    }),
+    nullptr, metricTimedBody(METRIC_HTTP_ALARM_POST, parseNewAlarm));
+}
+
+void webDeleteAlarm() {
+  server.on("/delete", HTTP_POST, metricTimed(METRIC_HTTP_DELETE, [](AsyncWebServerRequest* request) {
+    int result = bodyTake(request);
+    if (result < 0) {
+      request->send(-result, "application/json", bodyError(result, "{\"error\":\"no such alarm\"}"));
+      return;
+    }
+
+    request->send(200, "application/json", "{}");
+    }),
+    nullptr, metricTimedBody(METRIC_HTTP_DELETE, parseDeleteAlarm));
+}
+
+void parseSetTime(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t total) {
+  RequestBody* body = bodyAppend(req, data, len, index, total);
+  if (body == NULL) return;
+
+  StaticJsonDocument<BODY_JSON_CAPACITY> json;
+  if (deserializeJson(json, body->data, body->length) || !json["offset"].is<int32_t>()) {
+    body->result = -400;
+    return;
+  }
+
+  int32_t offset = json["offset"];
+  if (offset < UTC_OFFSET_MIN_SEC || offset > UTC_OFFSET_MAX_SEC) {
+    body->result = -400;
+    return;
+  }
+  body->result = 0;
+  if (offset == clockUtcOffset) return;
+
+  clockUtcOffset = offset;
+  prefs.begin("clock", false);
+  prefs.putInt("utcOffset", offset);
+  prefs.end();
+
+  // Local midnight moved: reschedule alarms and resend the offset
+  xTaskNotifyGive(taskHandleAlarmScheduler);
+  xTaskNotifyGive(taskHandleUpdateTime);
+}
+
+// Collects one chunk of a POST body. Returns the slot once the whole body
+// is in and ready to parse, NULL while chunks are still missing or when the
+// body was refused (the slot's result then already holds the status).
+RequestBody* bodyAppend(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t total) {
+  RequestBody* body = bodyFind(req);
+
+  if (index == 0 && body == NULL) {
+    portENTER_CRITICAL(&requestBodiesMux);
+    for (int i = 0; i < BODY_SLOTS; i++) {
+      if (requestBodies[i].owner == NULL) {
+        body = &requestBodies[i];
+        body->owner = req;
+        break;
+      }
+    }
+    if (body == NULL) requestBodiesRejected++;
+    portEXIT_CRITICAL(&requestBodiesMux);
+
+    // No slot: bodyTake() finds none and answers 503
+    if (body == NULL) return NULL;
+
+    body->length = 0;
+    body->result = -400;  // until a handler says otherwise
+    // Frees the slot however the request ends, even if it never completes
+    req->onDisconnect([req]() { bodyRelease(req); });
+
+    if (total > BODY_MAX) {
+      body->result = -413;
+      portENTER_CRITICAL(&requestBodiesMux);
+      requestBodiesRejected++;
+      portEXIT_CRITICAL(&requestBodiesMux);
+    }
+  }
+
+  if (body == NULL || body->result == -413) return NULL;
+  // Chunks arrive in order; anything else means a confused client
+  if (index != body->length || index + len > BODY_MAX) {
+    body->result = -400;
+    return NULL;
+  }
+
+  memcpy(body->data + index, data, len);
+  body->length = index + len;
+  if (body->length < total) return NULL;
+
+  body->data[body->length] = '\0';
+  return body;
+}
+
+RequestBody* bodyFind(AsyncWebServerRequest* req) {
+  RequestBody* body = NULL;
+  portENTER_CRITICAL(&requestBodiesMux);
+  for (int i = 0; i < BODY_SLOTS; i++) {
+    if (requestBodies[i].owner == req) body = &requestBodies[i];
+  }
+  portEXIT_CRITICAL(&requestBodiesMux);
+  return body;
+}
+
+// The body handler's result for req, then frees its slot. -503 when the
+// body never got a slot, -400 when there was no body at all.
+int bodyTake(AsyncWebServerRequest* req) {
+  RequestBody* body = bodyFind(req);
+  if (body == NULL) return req->contentLength() > 0 ? -503 : -400;
+
+  int result = body->result;
+  bodyRelease(req);
+  return result;
+}
+
+void bodyRelease(AsyncWebServerRequest* req) {
+  portENTER_CRITICAL(&requestBodiesMux);
+  for (int i = 0; i < BODY_SLOTS; i++) {
+    if (requestBodies[i].owner == req) requestBodies[i].owner = NULL;
+  }
+  portEXIT_CRITICAL(&requestBodiesMux);
+}
+
+const char* bodyError(int result, const char* fallback) {
+  if (result == -413) return "{\"error\":\"body too large\"}";
+  if (result == -503) return "{\"error\":\"too many requests in flight\"}";
+  return fallback;
+}
+
+// Body {"time":"HH:MM[:SS]","label":"...","days":0-127,"enabled":bool},
+// plus "id" to update an existing alarm instead of adding one
+void parseNewAlarm(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t total) {
+  RequestBody* body = bodyAppend(req, data, len, index, total);
+  if (body == NULL) return;
+
+  // Parsed in place, strings point into body->data
+  StaticJsonDocument<BODY_JSON_CAPACITY> json;
+  if (deserializeJson(json, body->data, body->length)) {
+    body->result = -400;
+    return;
+  }
+
+  const char* time = json["time"] | "";
+  const char* label = json["label"] | "";
+
+  AlarmEntry entry;
+  entry.seconds = parseAlarmTime(time);
+  entry.days = (json["days"] | 0) & ALARM_DAYS_ALL;
+  entry.flags = (json["enabled"] | true) ? ALARM_ENABLED : 0;
+  if (entry.seconds == ALARM_TIME_INVALID || strlen(label) > ALARM_LABEL_MAX_LEN) {
+    body->result = -400;
+    return;
+  }
+  strlcpy(entry.label, label, sizeof(entry.label));
+
+  int id = json["id"] | -1;
+  int result;
+
+  uint32_t revision = 0;
+
+  portENTER_CRITICAL(&alarmMux);
+  if (id >= 0) {
+    // Update in place, only if the alarm still exists
+    bool used = id < MAX_ALARM && alarmLists[id].seconds != ALARM_TIME_INVALID;
+    result = !used ? -404 : alarmSet(id, entry) ? id : -507;
+  } else {
+    result = alarmAlloc();
+    if (result < 0) {
+      result = -507;
+    } else if (!alarmSet(result, entry)) {
+      alarmFree(result);
+      result = -507;
+    }
+  }
+  if (result >= 0) revision = alarmJournal(result);
+  portEXIT_CRITICAL(&alarmMux);
+
+  body->result = result;
+  if (result < 0) return;
+
+  xTaskNotifyGive(taskHandleAlarmScheduler);
+  storageAlarmChanged(result);
+  alarmPublish(revision, result);
+}
+
+// Body {"index":<id>}
+void parseDeleteAlarm(AsyncWebServerRequest* req, uint8_t* data, size_t len, size_t index, size_t total) {
+  RequestBody* body = bodyAppend(req, data, len, index, total);
+  if (body == NULL) return;
+
+  StaticJsonDocument<BODY_JSON_CAPACITY> json;
+  if (deserializeJson(json, body->data, body->length)) {
+    body->result = -400;
+    return;
+  }
+
+  int idx = json["index"] | -1;
+
+  uint32_t revision = 0;
+
+  portENTER_CRITICAL(&alarmMux);
+  bool used = idx >= 0 && idx < MAX_ALARM && alarmLists[idx].seconds != ALARM_TIME_INVALID;
+  if (used) {
+    alarmClear(idx);
+    alarmFree(idx);
+    revision = alarmJournal(idx);
+  }
+  portEXIT_CRITICAL(&alarmMux);
+
+  body->result = used ? idx : -404;
+  if (!used) return;
+
+  xTaskNotifyGive(taskHandleAlarmScheduler);
+  storageAlarmChanged(idx);
+  alarmPublish(revision, idx);
+}
+
+void onTelemetryEvent(AsyncWebSocket* ws, AsyncWebSocketClient* client, AwsEventType type, void* arg, uint8_t* data, size_t len) {
+  if (type == WS_EVT_CONNECT) {
+    // New clients get every topic until they subscribe
+    bool added = false;
+    portENTER_CRITICAL(&wsSubscribersMux);
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+      if (wsSubscribers[i].clientId == 0) {
+        wsSubscribers[i] = WsSubscriber();
+        wsSubscribers[i].clientId = client->id();
+        wsSubscribers[i].topics = TOPIC_MASK_ALL;
+        added = true;
+        break;
+      }
+    }
+    portEXIT_CRITICAL(&wsSubscribersMux);
+
+    if (!added) {
+      client->close();
+      return;
+    }
+
+    telemetrySnapshot(client);
+  } else if (type == WS_EVT_DISCONNECT) {
+    portENTER_CRITICAL(&wsSubscribersMux);
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+      if (wsSubscribers[i].clientId == client->id()) wsSubscribers[i].clientId = 0;
+    }
+    portEXIT_CRITICAL(&wsSubscribersMux);
+  } else if (type == WS_EVT_DATA) {
+    // Only single-frame binary messages are expected from the dashboard
+    AwsFrameInfo* info = (AwsFrameInfo*)arg;
+    if (!info->final || info->index != 0 || info->len != len || info->opcode != WS_BINARY) return;
+    if (len == 2 && data[0] == TOPIC_SUBSCRIBE) {
+      portENTER_CRITICAL(&wsSubscribersMux);
+      for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+        if (wsSubscribers[i].clientId == client->id()) wsSubscribers[i].topics = data[1] & TOPIC_MASK_ALL;
+      }
+      portEXIT_CRITICAL(&wsSubscribersMux);
+    } else if (len == 5 && data[0] == TOPIC_ALARM_SYNC) {
+      uint32_t lastRevision;
+      memcpy(&lastRevision, data + 1, 4);
+      alarmCatchUp(client, lastRevision);
+    }
+  }
+}
+
+// Sends a frame that cannot be coalesced. Refused rather than queued when
+// the client is already backed up.
+bool telemetrySend(AsyncWebSocketClient* client, uint8_t topic, const uint8_t* payload, size_t len) {
+  if (len + 1 > MAX_WS_FRAME) return false;
+
+  if (!client->canSend()) {
+    portENTER_CRITICAL(&wsSubscribersMux);
+    WsSubscriber* sub = wsSubscriberFind(client->id());
+    if (sub != NULL) sub->dropped++;
+    wsDropped++;
+    portEXIT_CRITICAL(&wsSubscribersMux);
+    return false;
+  }
+
+  uint8_t frame[MAX_WS_FRAME];
+  frame[0] = topic;
+  memcpy(frame + 1, payload, len);
+  client->binary(frame, len + 1);
+  return true;
+}
+
+void telemetryPublish(uint8_t topic, const uint8_t* payload, size_t len) {
+  if (len + 1 > MAX_WS_FRAME) return;
+  uint32_t started = ESP.getCycleCount();
+
+  int key = telemetryKey(topic, payload, len);
+  if (key >= 0 && len + 1 > TELEMETRY_LATEST_MAX) return;
+
+  // Never sends from here: producers run on the other core, taskTelemetry
+  // picks the value or frame up as soon as it is notified
+  if (key >= 0) {
+    portENTER_CRITICAL(&wsSubscribersMux);
+    telemetryLatest[key][0] = topic;
+    memcpy(telemetryLatest[key] + 1, payload, len);
+    telemetryLatestLen[key] = len + 1;
+    for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+      WsSubscriber& sub = wsSubscribers[i];
+      if (sub.clientId == 0 || !(sub.topics & TOPIC_MASK(topic))) continue;
+      uint64_t bit = 1ULL << key;
+      if (sub.pending & bit) {
+        sub.coalesced++;
+        wsCoalesced++;
+      }
+      sub.pending |= bit;
+    }
+    portEXIT_CRITICAL(&wsSubscribersMux);
+  } else {
+    TelemetryFrame frame;
+    frame.length = len + 1;
+    frame.data[0] = topic;
+    memcpy(frame.data + 1, payload, len);
+    if (telemetryQueue == NULL || xQueueSend(telemetryQueue, &frame, 0) != pdTRUE) {
+      // Clients notice the revision gap and resync
+      portENTER_CRITICAL(&wsSubscribersMux);
+      wsDropped++;
+      portEXIT_CRITICAL(&wsSubscribersMux);
+    }
+  }
+
+  if (taskHandleTelemetry != NULL) xTaskNotifyGive(taskHandleTelemetry);
+  metricTimerRecord(METRIC_WS_PUBLISH, started);
+}
+
+void taskTelemetry(void* parameters) {
+  // Besides the AsyncTCP callbacks (connect snapshot, catch-up), the only
+  // writer to WebSocket clients. Woken by every publish; the timeout
+  // retries clients that were backed up and reaps dead or stalled ones.
+  while (1) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(WS_SERVICE_INTERVAL_MS));
+    uint32_t started = ESP.getCycleCount();
+
+    TelemetryFrame frame;
+    while (xQueueReceive(telemetryQueue, &frame, 0) == pdTRUE) telemetryBroadcast(frame);
+
+    telemetryService();
+    telemetry.cleanupClients(MAX_WS_CLIENTS);
+    metricTimerRecord(METRIC_WS_SEND, started);
+  }
+
+  vTaskDelete(NULL);
+}
+
+void telemetryBroadcast(const TelemetryFrame& frame) {
+  // Snapshot the recipients so no network call happens under the lock
+  uint32_t recipients[MAX_WS_CLIENTS];
+  int count = 0;
+  portENTER_CRITICAL(&wsSubscribersMux);
+  for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+    WsSubscriber& sub = wsSubscribers[i];
+    if (sub.clientId != 0 && (sub.topics & TOPIC_MASK(frame.data[0]))) recipients[count++] = sub.clientId;
+  }
+  portEXIT_CRITICAL(&wsSubscribersMux);
+
+  for (int i = 0; i < count; i++) {
+    AsyncWebSocketClient* client = telemetry.client(recipients[i]);
+    if (client != NULL) telemetrySend(client, frame.data[0], frame.data + 1, frame.length - 1);
+  }
+}
+
+// Latest-value slot for a topic, -1 for frames that must not be coalesced
+int telemetryKey(uint8_t topic, const uint8_t* payload, size_t len) {
+  switch (topic) {
+    case TOPIC_TIME: return TELEMETRY_KEY_TIME;
+    case TOPIC_POLLUTION: return TELEMETRY_KEY_POLLUTION;
+    case TOPIC_DHT: return len > 0 && payload[0] < MAX_SENSOR_NODES ? TELEMETRY_KEY_DHT + payload[0] : -1;
+    default: return -1;
+  }
+}
+
+// Moves pending values into the client's queue while it has room. Runs in
+// taskTelemetry and the AsyncTCP callbacks: each key is claimed under the
+// lock, so nothing goes twice.
+void telemetryFlush(AsyncWebSocketClient* client) {
+  uint32_t clientId = client->id();
+
+  while (client->canSend()) {
+    uint8_t frame[TELEMETRY_LATEST_MAX];
+    size_t length = 0;
+    int key = -1;
+
+    portENTER_CRITICAL(&wsSubscribersMux);
+    WsSubscriber* sub = wsSubscriberFind(clientId);
+    if (sub != NULL && sub->pending != 0) {
+      key = __builtin_ctzll(sub->pending);
+      sub->pending &= ~(1ULL << key);
+      sub->sent++;
+      length = telemetryLatestLen[key];
+      memcpy(frame, telemetryLatest[key], length);
+    }
+    portEXIT_CRITICAL(&wsSubscribersMux);
+
+    if (key < 0) break;
+    if (key == TELEMETRY_KEY_TIME) {
+      frame[0] = TOPIC_TIME;
+      length = 1 + encodeTimeSync(frame + 1);
+    }
+    client->binary(frame, length);
+  }
+
+  // Stalled means holding values it has no room for, not merely a full queue
+  portENTER_CRITICAL(&wsSubscribersMux);
+  WsSubscriber* sub = wsSubscriberFind(clientId);
+  if (sub != NULL) {
+    if (sub->pending == 0) sub->stalledSinceMs = 0;
+    else if (sub->stalledSinceMs == 0) sub->stalledSinceMs = millis() | 1;
+  }
+  portEXIT_CRITICAL(&wsSubscribersMux);
+}
+
+// Retries clients that still owe values and closes the ones that have
+// not taken a frame for WS_STALL_TIMEOUT_MS.
+void telemetryService() {
+  uint32_t behind[MAX_WS_CLIENTS];
+  uint32_t stalledMs[MAX_WS_CLIENTS];
+  int count = 0;
+  uint32_t now = millis();
+
+  portENTER_CRITICAL(&wsSubscribersMux);
+  for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+    if (wsSubscribers[i].clientId == 0 || wsSubscribers[i].pending == 0) continue;
+    behind[count] = wsSubscribers[i].clientId;
+    stalledMs[count++] = wsSubscribers[i].stalledSinceMs == 0 ? 0 : now - wsSubscribers[i].stalledSinceMs;
+  }
+  portEXIT_CRITICAL(&wsSubscribersMux);
+
+  for (int i = 0; i < count; i++) {
+    AsyncWebSocketClient* client = telemetry.client(behind[i]);
+    if (client == NULL) continue;
+
+    if (stalledMs[i] >= WS_STALL_TIMEOUT_MS && !client->canSend()) {
+      LOG_WARN("Closing stalled WebSocket client %lu", (unsigned long)behind[i]);
+      portENTER_CRITICAL(&wsSubscribersMux);
+      wsStalledDisconnects++;
+      portEXIT_CRITICAL(&wsSubscribersMux);
+      client->close();
+      continue;
+    }
+
+    telemetryFlush(client);
+  }
+}
+
+// Everything the dashboard shows, in one frame, so a fresh page renders
+// without waiting for the next sensor frame or an HTTP round trip. It
+// includes the one-shot clock sync, the dashboard ticks locally from there.
+// The frame is encoded straight into the library's buffer, sized for the
+// nodes and alarms there are now.
+void telemetrySnapshot(AsyncWebSocketClient* client) {
+  size_t length = 0;
+  encodeSnapshot(NULL, length);
+
+  for (int attempt = 0; attempt < SNAPSHOT_ATTEMPTS; attempt++) {
+    AsyncWebSocketMessageBuffer* buffer = client->server()->makeBuffer(length);
+    if (buffer == NULL || buffer->length() != length) {
+      delete buffer;
+      break;
+    }
+    // The library owns the buffer once it is queued
+    if (encodeSnapshot(buffer->get(), length)) {
+      client->binary(buffer);
+      return;
+    }
+    delete buffer;
+  }
+
+  // Fall back to the clock alone, sensors and alarms fill in as they come
+  portENTER_CRITICAL(&wsSubscribersMux);
+  WsSubscriber* sub = wsSubscriberFind(client->id());
+  if (sub != NULL) sub->pending |= 1ULL << TELEMETRY_KEY_TIME;
+  portEXIT_CRITICAL(&wsSubscribersMux);
+  telemetryFlush(client);
+}
+
+// Encodes the TOPIC_SNAPSHOT frame into frame, which holds length bytes,
+// and sets length to what the frame takes. Returns false when that
+// differs from the buffer, a node or alarm changed since it was sized,
+// and the buffer is then only partly written.
+bool encodeSnapshot(uint8_t* frame, size_t& length) {
+  const size_t size = length;
+  uint8_t header[15];
+  header[0] = TOPIC_SNAPSHOT;
+
+  int64_t epochMs = time(NULL) >= TIME_VALID_EPOCH ? clockTargetUs() / 1000 : 0;
+  int32_t offset = clockUtcOffset;
+  memcpy(header + 1, &epochMs, 8);
+  memcpy(header + 9, &offset, 4);
+
+  uint16_t ppm = 0xffff;
+  portENTER_CRITICAL(&wsSubscribersMux);
+  if (telemetryLatestLen[TELEMETRY_KEY_POLLUTION] == 3) memcpy(&ppm, telemetryLatest[TELEMETRY_KEY_POLLUTION] + 1, 2);
+  portEXIT_CRITICAL(&wsSubscribersMux);
+  memcpy(header + 13, &ppm, 2);
+
+  length = sizeof(header);
+  bool fits = length <= size;
+  if (fits) memcpy(frame, header, sizeof(header));
+
+  portENTER_CRITICAL(&sensorNodesMux);
+  sensorNodeEvictStale(millis());
+  uint8_t nodeCount = 0;
+  for (int i = 0; i < MAX_SENSOR_NODES; i++) {
+    if (sensorNodeKeys[i] != 0) nodeCount++;
+  }
+  size_t nodesAt = length;
+  length += 1 + nodeCount * 6;
+  fits = fits && length <= size;
+  if (fits) {
+    frame[nodesAt++] = nodeCount;
+    for (int i = 0; i < MAX_SENSOR_NODES; i++) {
+      if (sensorNodeKeys[i] == 0) continue;
+      frame[nodesAt] = i;
+      frame[nodesAt + 1] = sensorNodes[i].sensorId;
+      memcpy(frame + nodesAt + 2, &sensorNodes[i].latest.T, 2);
+      memcpy(frame + nodesAt + 4, &sensorNodes[i].latest.H, 2);
+      nodesAt += 6;
+    }
+  }
+  portEXIT_CRITICAL(&sensorNodesMux);
+
+  // Revision and list read under one lock, events after it apply on top
+  portENTER_CRITICAL(&alarmMux);
+  uint16_t alarmTotal = 0;
+  size_t alarmsAt = length;
+  length += 6;
+  for (int i = 0; i < MAX_ALARM; i++) {
+    const AlarmItem* alarm = &alarmLists[i];
+    if (alarm->seconds == ALARM_TIME_INVALID) continue;
+    length += 9 + (alarm->label != ALARM_NO_LABEL ? alarmLabels[alarm->label].length : 0);
+    alarmTotal++;
+  }
+  fits = fits && length == size;
+  if (fits) {
+    memcpy(frame + alarmsAt, &alarmRevision, 4);
+    memcpy(frame + alarmsAt + 4, &alarmTotal, 2);
+    alarmsAt += 6;
+    for (int i = 0; i < MAX_ALARM; i++) {
+      if (alarmLists[i].seconds != ALARM_TIME_INVALID) alarmsAt += encodeAlarmEntry(frame + alarmsAt, i);
+    }
+  }
+  portEXIT_CRITICAL(&alarmMux);
+
+  return fits;
+}
+
+// Caller holds wsSubscribersMux
+WsSubscriber* wsSubscriberFind(uint32_t clientId) {
+  for (int i = 0; i < MAX_WS_CLIENTS; i++) {
+    if (wsSubscribers[i].clientId == clientId) return &wsSubscribers[i];
+  }
+  return NULL;
+}
+
+void metricTimerRecord(int timer, uint32_t startCycles) {
+  uint32_t cycles = ESP.getCycleCount() - startCycles;
+
+  portENTER_CRITICAL(&metricsMux);
+  MetricTimer& t = metricTimers[timer];
+  t.count++;
+  t.totalCycles += cycles;
+  if (cycles > t.maxCycles) t.maxCycles = cycles;
+  portEXIT_CRITICAL(&metricsMux);
+}
+
+ArRequestHandlerFunction metricTimed(int timer, ArRequestHandlerFunction handler) {
+  return [timer, handler](AsyncWebServerRequest* request) {
+    uint32_t started = ESP.getCycleCount();
+    handler(request);
+    metricTimerRecord(timer, started);
+  };
+}
+
+ArBodyHandlerFunction metricTimedBody(int timer, ArBodyHandlerFunction handler) {
+  return [timer, handler](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+    uint32_t started = ESP.getCycleCount();
+    handler(request, data, len, index, total);
+    metricTimerRecord(timer, started);
+  };
+}
+
+void startWebServer() {
+  // DefaultHeaders::Instance().addHeader("Access-Control-Allow-Origin", "*");
+
+  telemetry.onEvent(onTelemetryEvent);
+  server.addHandler(&telemetry);
+  xTaskCreatePinnedToCore(taskTelemetry, "Task Telemetry", 4096, NULL,
+                          deadlinePriority(DEADLINE_TELEMETRY_MS), &taskHandleTelemetry, CORE_NET);
+
+  webDashboard();
+  webAssets();
+  webGetAlarm();
+  webGetNodes();
+  webGetClients();
+  webGetMetrics();
+  webGetTime();
+  webSetTime();
+  webGetLogs();
+  webGetHistory();
+  webAddAlarm();
+  webDeleteAlarm();
+
+  // Start the server
+  LOG_INFO("Starting the web server...");
+  server.begin();
+  LOG_INFO("Web server started.");
+}
+
+// Runs in the WiFi task: copy the frame into the ring and get out
+void OnDataRecv(const esp_now_recv_info_t* info, const uint8_t* incomingData, int len) {
+  uint32_t started = ESP.getCycleCount();
+  uint32_t head = espNowRxHead.load(std::memory_order_relaxed);
+  uint32_t depth = head - espNowRxTail.load(std::memory_order_acquire);
+  if (depth >= ESPNOW_RX_QUEUE_LEN) {
+    espNowRxOverflows++;
+    metricTimerRecord(METRIC_ESPNOW_RECV, started);
+    return;
+  }
+  if (depth + 1 > espNowRxMaxDepth) espNowRxMaxDepth = depth + 1;
+
+  EspNowRxFrame* rx = &espNowRxRing[head & (ESPNOW_RX_QUEUE_LEN - 1)];
+  memcpy(rx->mac, info->src_addr, 6);
+  rx->rssi = info->rx_ctrl->rssi;
+  rx->len = len;
+  memcpy(rx->data, incomingData, min((size_t)len, sizeof(rx->data)));
+
+  espNowRxHead.store(head + 1, std::memory_order_release);
+  xTaskNotifyGive(taskHandleSensorConsumer);
+  metricTimerRecord(METRIC_ESPNOW_RECV, started);
+}
+
+void taskSensorConsumer(void* parameters) {
+  while (1) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    // Drain everything queued so far, then publish each node once
+    bool dirty[MAX_SENSOR_NODES] = { false };
+    uint32_t tail = espNowRxTail.load(std::memory_order_relaxed);
+    uint32_t head = espNowRxHead.load(std::memory_order_acquire);
+
+    for (; tail != head; tail++) {
+      const EspNowRxFrame* rx = &espNowRxRing[tail & (ESPNOW_RX_QUEUE_LEN - 1)];
+
+      if (rx->len == sizeof(DiscoveryFrame) && rx->data[0] == ESPNOW_MSG_PROBE) {
+        replyProbe(rx);
+      } else {
+        int slot = handleSensorFrame(rx);
+        if (slot >= 0) dirty[slot] = true;
+      }
+
+      espNowRxTail.store(tail + 1, std::memory_order_release);
+    }
+
+    for (int i = 0; i < MAX_SENSOR_NODES; i++) {
+      if (!dirty[i]) continue;
+
+      portENTER_CRITICAL(&sensorNodesMux);
+      uint8_t sensorId = sensorNodes[i].sensorId;
+      SensorSample latest = sensorNodes[i].latest;
+      portEXIT_CRITICAL(&sensorNodesMux);
+
+      uint8_t payload[6] = { (uint8_t)i, sensorId,
+                             (uint8_t)latest.T, (uint8_t)(latest.T >> 8), (uint8_t)latest.H, (uint8_t)(latest.H >> 8) };
+      telemetryPublish(TOPIC_DHT, payload, sizeof(payload));
+    }
+  }
+
+  vTaskDelete(NULL);
+}
+
+// Validates one queued frame and folds it into the node registry.
+// Returns the node slot that changed, or -1.
+int handleSensorFrame(const EspNowRxFrame* rx) {
+  SensorFrame frame;
+  if (rx->len < (int)SENSOR_FRAME_HEADER_LEN || rx->len > (int)sizeof(frame)) {
+    sensorFramesRejected++;
+    return -1;
+  }
+  memcpy(&frame, rx->data, rx->len);
+
+  if (frame.version != SENSOR_FRAME_VERSION || frame.count == 0 || frame.count > SENSOR_FRAME_MAX_SAMPLES
+      || rx->len != (int)(SENSOR_FRAME_HEADER_LEN + frame.count * sizeof(SensorSample))) {
+    sensorFramesRejected++;
+    return -1;
+  }
+
+  uint64_t key = macKey(rx->mac);
+  uint32_t now = millis();
+
+  portENTER_CRITICAL(&sensorNodesMux);
+  int slot = sensorNodeSlot(key, now);
+  SensorNode* node = &sensorNodes[slot];
+
+  // Gap detection on the 16-bit sequence number. A sensor that restarted
+  // counts from 0 again under a new boot id, which is not a gap.
+  if (node->framesReceived > 0 && frame.boot != node->boot) {
+    node->restarts++;
+  } else if (node->framesReceived > 0) {
+    int16_t delta = (int16_t)(frame.seq - (uint16_t)(node->lastSeq + 1));
+    if (delta < 0 && delta >= -SENSOR_SEQ_REORDER_WINDOW) {
+      portEXIT_CRITICAL(&sensorNodesMux);
+      return -1;
+    }
+    if (delta > 0) node->framesLost += delta;
+  }
+
+  // Samples are oldest first, the dashboard only shows the newest
+  node->sensorId = frame.sensorId;
+  node->rssi = rx->rssi;
+  node->latest = frame.samples[frame.count - 1];
+  node->lastSeenMs = now;
+  node->boot = frame.boot;
+  node->lastSeq = frame.seq;
+  node->framesReceived++;
+  portEXIT_CRITICAL(&sensorNodesMux);
+
+  // Sample dt is relative to the sender clock, anchor it to the newest one
+  uint32_t nowSec = time(NULL);
+  uint16_t newestDt = frame.samples[frame.count - 1].dt;
+  for (int i = 0; i < frame.count; i++) {
+    uint32_t t = nowSec - (uint16_t)(newestDt - frame.samples[i].dt) / 10;
+    historyAdd(HISTORY_METRIC_T, t, frame.samples[i].T);
+    historyAdd(HISTORY_METRIC_H, t, frame.samples[i].H);
+  }
+
+  return slot;
+}
+
+// A sensor looking for our channel; the broadcast ACK names it as target
+void replyProbe(const EspNowRxFrame* rx) {
+  DiscoveryFrame ack;
+  ack.type = ESPNOW_MSG_ACK;
+  ack.channel = rx->data[1];
+  memcpy(ack.target, rx->mac, 6);
+
+  if (esp_now_send(discoveryAddress, (uint8_t*)&ack, sizeof(ack)) == ESP_OK) discoveryProbesAnswered++;
+}
+
+uint64_t macKey(const uint8_t* mac) {
+  uint64_t key = 0;
+  for (int i = 0; i < 6; i++) key = (key << 8) | mac[i];
+  return key;
+}
+
+// Returns the slot for key, claiming a free slot (or evicting the least
+// recently seen node) for new senders. Caller holds sensorNodesMux.
+int sensorNodeSlot(uint64_t key, uint32_t now) {
+  int freeSlot = -1;
+  int oldestSlot = 0;
+
+  for (int i = 0; i < MAX_SENSOR_NODES; i++) {
+    if (sensorNodeKeys[i] == key) return i;
+    if (sensorNodeKeys[i] == 0) {
+      if (freeSlot < 0) freeSlot = i;
+    } else if (now - sensorNodes[i].lastSeenMs > now - sensorNodes[oldestSlot].lastSeenMs) {
+      oldestSlot = i;
+    }
+  }
+
+  int slot = freeSlot;
+  if (slot < 0) {
+    slot = oldestSlot;
+    sensorNodesEvicted++;
+  }
+
+  sensorNodeKeys[slot] = key;
+  memset(&sensorNodes[slot], 0, sizeof(SensorNode));
+  for (int i = 0; i < 6; i++) sensorNodes[slot].mac[i] = key >> (8 * (5 - i));
+  return slot;
+}
+
+// Caller holds sensorNodesMux
+void sensorNodeEvictStale(uint32_t now) {
+  for (int i = 0; i < MAX_SENSOR_NODES; i++) {
+    if (sensorNodeKeys[i] != 0 && now - sensorNodes[i].lastSeenMs > SENSOR_NODE_TIMEOUT_MS) {
+      sensorNodeKeys[i] = 0;
+      sensorNodesEvicted++;
+    }
+  }
 }
@@ -2,6 +2,12 @@
 #include <esp_now.h>
 #include <esp_wifi.h>
 #include <DHT.h>
+#include <Preferences.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <sys/time.h>
+
+#include "clock_log.h"
 
 // ----------- Konfigurasi DHT Sensor -----------
 #define DHTPIN 4        // Pin DHT11
@@ -9,41 +15,218 @@
 
 DHT dht(DHTPIN, DHTTYPE);
 
+// ----------- Konfigurasi Pengiriman -----------
+#define SENSOR_ID 1                  // ID sensor ini di ESP1
+#define SAMPLE_INTERVAL_MS 2000      // Interval baca DHT11
+#define MAX_BATCH_DELAY_MS 6000      // Sampel paling lama ditahan sebelum dikirim
+#define HEARTBEAT_INTERVAL_MS 30000  // Tetap kirim walau nilai tidak berubah
+#define DEADBAND_T 5                 // 0.5 C (x10)
+#define DEADBAND_H 20                // 2.0 % (x10)
+
+// ----------- Konfigurasi Discovery Channel -----------
+#define PROBE_DWELL_MS 60            // Tunggu ACK per channel
+#define PROBE_ROUND_BACKOFF_MS 5000  // Jeda setelah 14 channel tanpa ACK
+#define MAX_SEND_FAILURES 3          // Gagal berturut-turut sebelum scan ulang
+
+// ----------- Konfigurasi Low Power (Deep Sleep) -----------
+// 1 = baca sensor, simpan di RTC memory, lalu deep sleep. Radio hanya
+// dinyalakan saat batch penuh, nilai keluar deadband, atau heartbeat.
+#define LOW_POWER_MODE 0
+#define LP_SAMPLE_INTERVAL_MS 60000      // Lama tidur antar sampel
+#define LP_HEARTBEAT_INTERVAL_MS 600000  // Tetap kirim walau nilai tidak berubah
+#define LP_SEND_TIMEOUT_MS 100           // Tunggu callback kirim
+#define LP_SCAN_TIMEOUT_MS 1500          // Batas scan channel per siklus
+#define LP_AWAKE_BUDGET_MS 300           // Target waktu bangun per siklus
+#define DHT_WARMUP_MS 1000               // DHT11 setelah power-on
+
+// Perkiraan arus untuk log energi per siklus
+#define ACTIVE_CURRENT_MA 40
+#define RADIO_CURRENT_MA 120
+#define SLEEP_CURRENT_UA 10
+
 // ----------- Struktur Data untuk ESP-NOW -----------
+// Format frame harus sama dengan esp1.cpp
+#define SENSOR_FRAME_VERSION 2
+#define SENSOR_FRAME_MAX_SAMPLES 8
+
 typedef struct SensorData {
   float T; // Suhu
   float H; // Kelembaban
 } SensorData;
 
+typedef struct __attribute__((packed)) SensorSample {
+  uint16_t dt; // Selisih dari timestamp frame (x100 ms)
+  int16_t T;   // Suhu x10
+  uint16_t H;  // Kelembaban x10
+} SensorSample;
+
+typedef struct __attribute__((packed)) SensorFrame {
+  uint8_t version;
+  uint8_t sensorId;
+  uint16_t boot;      // Acak tiap power-on, seq mulai dari 0 lagi
+  uint16_t seq;
+  uint32_t timestamp; // millis() saat sampel pertama
+  uint8_t count;
+  SensorSample samples[SENSOR_FRAME_MAX_SAMPLES];
+} SensorFrame;
+
+#define SENSOR_FRAME_HEADER_LEN offsetof(SensorFrame, samples)
+
+// Byte pertama frame discovery, tidak bentrok dengan SENSOR_FRAME_VERSION
+#define ESPNOW_MSG_PROBE 0xF0
+#define ESPNOW_MSG_ACK 0xF1
+
+typedef struct __attribute__((packed)) DiscoveryFrame {
+  uint8_t type;      // ESPNOW_MSG_PROBE / ESPNOW_MSG_ACK
+  uint8_t channel;   // Channel tempat probe dikirim
+  uint8_t target[6]; // ACK: MAC sensor yang mengirim probe
+} DiscoveryFrame;
+
+// ----------- State Machine Scan Channel -----------
+typedef enum ScanState {
+  SCAN_PROBING,
+  SCAN_LOCKED,
+} ScanState;
+
+typedef struct ChannelScan {
+  ScanState state;
+  uint8_t channel;     // Channel yang sedang di-probe / sudah terkunci
+  uint16_t probed;     // Jumlah probe sejak scan dimulai
+  unsigned long since; // Waktu probe terakhir
+} ChannelScan;
+
 SensorData sensorData;
 
+// State batch di RTC memory supaya bertahan saat deep sleep
+RTC_DATA_ATTR SensorFrame frame;        // Batch yang sedang dikumpulkan
+RTC_DATA_ATTR SensorSample lastQueued;  // Sampel acuan deadband
+RTC_DATA_ATTR bool hasQueued = false;
+RTC_DATA_ATTR uint16_t frameSeq = 0;
+RTC_DATA_ATTR uint16_t frameBoot = 0;   // 0 = belum dipilih sejak power-on
+RTC_DATA_ATTR unsigned long lastSendMs = 0;
+unsigned long lastSampleMs = 0;
+
+// Statistik low power
+RTC_DATA_ATTR uint32_t lpCycles = 0;
+RTC_DATA_ATTR uint32_t lpFlushes = 0;
+
 // ----------- MAC Address ESP1 -----------
 uint8_t broadcastAddress[] = { 0x3c, 0x84, 0x27, 0xc9, 0x55, 0x64 };
 
+// Alamat broadcast ESP-NOW untuk probe discovery
+uint8_t discoveryAddress[] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+
 // ----------- Variabel WiFi Channel -----------
-uint8_t WIFI_CHANNEL = 1; // Default channel
-bool channelConnected = false;
+// Channel terakhir yang berhasil: RTC bertahan saat deep sleep,
+// NVS bertahan saat power dimatikan
+RTC_DATA_ATTR uint8_t rtcChannel = 0;
+Preferences prefs;
+
+ChannelScan scan;
+volatile uint8_t ackChannel = 0;     // Diisi OnDataRecv saat ACK ESP1 diterima
+volatile uint8_t sendFailures = 0;
+volatile bool rescanRequested = false;
+volatile bool sendDone = false;
+volatile bool sendOk = false;
 
 // ----------- Callback untuk ESP-NOW -----------
 void OnDataSent(const uint8_t *macAddr, esp_now_send_status_t status) {
-  Serial.print("Send Status: ");
-  Serial.println(status == ESP_NOW_SEND_SUCCESS ? "Success" : "Failed");
+  // Status broadcast probe tidak berarti apa-apa
+  if (memcmp(macAddr, discoveryAddress, 6) == 0) return;
 
-  if (status == ESP_NOW_SEND_FAIL && !channelConnected) {
-    Serial.println("Trying other WiFi Channel...");
-    Serial.printf("Current Channel: %d\n", WIFI_CHANNEL);
+  if (status == ESP_NOW_SEND_SUCCESS) {
+    LOG_DEBUG("Send Status: Success");
+  } else {
+    LOG_WARN("Send Status: Failed");
+  }
 
-    // Perbarui channel WiFi
-    WIFI_CHANNEL = (WIFI_CHANNEL == 14) ? 1 : WIFI_CHANNEL + 1;
+  sendOk = status == ESP_NOW_SEND_SUCCESS;
+  sendDone = true;
 
-    esp_wifi_set_promiscuous(true);
-    esp_wifi_set_channel(WIFI_CHANNEL, WIFI_SECOND_CHAN_NONE);
-    esp_wifi_set_promiscuous(false);
+  if (status == ESP_NOW_SEND_SUCCESS) {
+    sendFailures = 0;
+  } else if (++sendFailures >= MAX_SEND_FAILURES) {
+    rescanRequested = true;
+  }
+}
 
-    Serial.printf("Trying Channel: %d\n", WIFI_CHANNEL);
-  } else {
-    channelConnected = true;
+void OnDataRecv(const esp_now_recv_info_t *info, const uint8_t *incomingData, int len) {
+  if (len != sizeof(DiscoveryFrame) || incomingData[0] != ESPNOW_MSG_ACK) return;
+
+  DiscoveryFrame ack;
+  memcpy(&ack, incomingData, sizeof(ack));
+
+  uint8_t mac[6];
+  esp_wifi_get_mac(WIFI_IF_STA, mac);
+  if (memcmp(ack.target, mac, 6) == 0) ackChannel = ack.channel;
+}
+
+// ----------- Fungsi Channel -----------
+void setChannel(uint8_t channel) {
+  esp_wifi_set_promiscuous(true);
+  esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE);
+  esp_wifi_set_promiscuous(false);
+}
+
+uint8_t loadChannel() {
+  if (rtcChannel != 0) return rtcChannel;
+
+  prefs.begin("espnow", true);
+  uint8_t channel = prefs.getUChar("channel", 1);
+  prefs.end();
+
+  return (channel >= 1 && channel <= 14) ? channel : 1;
+}
+
+void saveChannel(uint8_t channel) {
+  rtcChannel = channel;
+
+  // Hanya tulis flash kalau berubah
+  prefs.begin("espnow", false);
+  if (prefs.getUChar("channel", 0) != channel) prefs.putUChar("channel", channel);
+  prefs.end();
+}
+
+void channelScanStart(ChannelScan &scan, uint8_t firstChannel) {
+  scan.state = SCAN_PROBING;
+  scan.channel = firstChannel;
+  scan.probed = 0;
+  scan.since = 0;
+}
+
+// Satu langkah scan. Mengembalikan channel yang harus di-probe sekarang,
+// atau 0 kalau masih menunggu ACK / sudah terkunci. Tidak menyentuh radio
+// sehingga bisa dijalankan di host dengan radio simulasi.
+uint8_t channelScanStep(ChannelScan &scan, unsigned long now, uint8_t ackedChannel) {
+  if (scan.state != SCAN_PROBING) return 0;
+
+  if (scan.probed > 0 && ackedChannel == scan.channel) {
+    scan.state = SCAN_LOCKED;
+    return 0;
   }
+
+  if (scan.probed > 0) {
+    // Satu putaran penuh tanpa ACK, kemungkinan ESP1 mati: tunggu lebih lama
+    unsigned long dwell = (scan.probed % 14 == 0) ? PROBE_ROUND_BACKOFF_MS : PROBE_DWELL_MS;
+    if (now - scan.since < dwell) return 0;
+
+    scan.channel = scan.channel % 14 + 1;
+  }
+
+  scan.probed++;
+  scan.since = now;
+  return scan.channel;
+}
+
+void sendProbe(uint8_t channel) {
+  setChannel(channel);
+
+  DiscoveryFrame probe;
+  memset(&probe, 0, sizeof(probe));
+  probe.type = ESPNOW_MSG_PROBE;
+  probe.channel = channel;
+
+  esp_now_send(discoveryAddress, (uint8_t *)&probe, sizeof(probe));
 }
 
 // ----------- Fungsi untuk Membaca Sensor -----------
@@ -52,36 +235,110 @@ void readSensors() {
   sensorData.T = dht.readTemperature();
   sensorData.H = dht.readHumidity();
 
-  // Log data sensor ke Serial Monitor
-  Serial.printf("Temperature: %.1f, Humidity: %.1f%\n", 
-                sensorData.T, sensorData.H);
+  // Log data sensor, hanya muncul kalau LOG_LEVEL DEBUG
+  LOG_DEBUG("Temperature: %.1f, Humidity: %.1f%%", sensorData.T, sensorData.H);
 }
 
-// ----------- Setup Program -----------
-void setup() {
-  Serial.begin(115200);
+// ----------- Fungsi Batch ESP-NOW -----------
+// seq dipakai batch ini sampai terkirim, kiriman ulang membawa seq yang
+// sama sehingga ESP1 tidak menghitungnya sebagai frame hilang
+void startBatch(unsigned long now) {
+  frame.timestamp = now;
+  frame.seq = frameSeq++;
+}
 
-  // Inisialisasi DHT11
-  dht.begin();
+void dropOldestSample() {
+  uint16_t shift = frame.count > 1 ? frame.samples[1].dt : 0;
+  for (int i = 1; i < frame.count; i++) {
+    frame.samples[i - 1] = frame.samples[i];
+    frame.samples[i - 1].dt -= shift;
+  }
+  frame.timestamp += shift * 100UL;
+  frame.count--;
+}
+
+// Mengembalikan true kalau sampel keluar dari deadband sampel acuan.
+// Sampel di dalam deadband hanya disimpan kalau keepAll (mode low power).
+bool queueSample(unsigned long now, bool keepAll) {
+  if (isnan(sensorData.T) || isnan(sensorData.H)) return false;
+
+  SensorSample sample;
+  sample.T = (int16_t)lroundf(sensorData.T * 10);
+  sample.H = (uint16_t)lroundf(sensorData.H * 10);
+
+  bool changed = !hasQueued || abs(sample.T - lastQueued.T) >= DEADBAND_T || abs(sample.H - lastQueued.H) >= DEADBAND_H;
+  if (!changed && !keepAll) return false;
+
+  // Batch penuh (kiriman sebelumnya gagal): buang sampel paling lama
+  if (frame.count == SENSOR_FRAME_MAX_SAMPLES) dropOldestSample();
+
+  if (frame.count == 0) startBatch(now);
+  sample.dt = (uint16_t)min((now - frame.timestamp) / 100, 0xFFFFUL);
+
+  frame.samples[frame.count++] = sample;
+  if (changed) {
+    lastQueued = sample;
+    hasQueued = true;
+  }
+  return changed;
+}
+
+// Heartbeat: kirim sampel terakhir walau masih di dalam deadband
+bool queueHeartbeat(unsigned long now) {
+  if (frame.count > 0 || !hasQueued) return false;
+
+  startBatch(now);
+  lastQueued.dt = 0;
+  frame.samples[frame.count++] = lastQueued;
+  return true;
+}
+
+// Kirim batch tanpa mengosongkannya
+bool sendFrame() {
+  // RTC memory kosong lagi setelah reset (bukan deep sleep), frameSeq
+  // juga kembali ke 0; boot id baru memberi tahu ESP1 bahwa ini bukan gap
+  if (frameBoot == 0) frameBoot = esp_random() % 0xffff + 1;
+
+  frame.version = SENSOR_FRAME_VERSION;
+  frame.sensorId = SENSOR_ID;
+  frame.boot = frameBoot;
 
+  size_t len = SENSOR_FRAME_HEADER_LEN + frame.count * sizeof(SensorSample);
+  esp_err_t result = esp_now_send(broadcastAddress, (uint8_t *)&frame, len);
+  if (result == ESP_OK) {
+    LOG_DEBUG("Data sent successfully (%d samples)", frame.count);
+  } else {
+    LOG_ERROR("Error sending data");
+  }
+  return result == ESP_OK;
+}
+
+void flushFrame(unsigned long now) {
+  sendFrame();
+
+  frame.count = 0;
+  lastSendMs = now;
+}
+
+// ----------- Fungsi Radio -----------
+bool initRadio() {
   // Inisialisasi WiFi
   WiFi.mode(WIFI_STA);
   WiFi.disconnect();
 
-  // Atur channel WiFi
-  esp_wifi_set_promiscuous(true);
-  esp_wifi_set_channel(WIFI_CHANNEL, WIFI_SECOND_CHAN_NONE);
-  esp_wifi_set_promiscuous(false);
+  // Mulai dari channel terakhir yang berhasil, biasanya langsung dapat ACK
+  setChannel(loadChannel());
 
   // Log MAC Address ESP2
-  Serial.println("ESP2 MAC Address: " + WiFi.macAddress());
+  LOG_INFO("ESP2 MAC Address: %s", WiFi.macAddress().c_str());
 
   // Inisialisasi ESP-NOW
   if (esp_now_init() != ESP_OK) {
-    Serial.println("ESP-NOW Init Failed");
-    return;
+    LOG_ERROR("ESP-NOW Init Failed");
+    return false;
   }
   esp_now_register_send_cb(OnDataSent);
+  esp_now_register_recv_cb(OnDataRecv);
 
   // Tambahkan peer (ESP1)
   esp_now_peer_info_t peerInfo;
@@ -91,25 +348,172 @@ void setup() {
   peerInfo.encrypt = false; // Non-enkripsi
 
   if (esp_now_add_peer(&peerInfo) != ESP_OK) {
-    Serial.println("Failed to add peer");
-    return;
+    LOG_ERROR("Failed to add peer");
+    return false;
+  }
+
+  // Tambahkan peer broadcast untuk probe discovery
+  memcpy(peerInfo.peer_addr, discoveryAddress, 6);
+  if (esp_now_add_peer(&peerInfo) != ESP_OK) {
+    LOG_ERROR("Failed to add discovery peer");
+    return false;
+  }
+
+  return true;
+}
+
+// Scan channel sampai dapat ACK atau timeout (dipakai mode low power)
+bool scanBlocking(unsigned long timeoutMs) {
+  ackChannel = 0;
+  channelScanStart(scan, loadChannel());
+
+  unsigned long start = millis();
+  while (scan.state == SCAN_PROBING && millis() - start < timeoutMs) {
+    uint8_t probeChannel = channelScanStep(scan, millis(), ackChannel);
+    if (probeChannel != 0) sendProbe(probeChannel);
+    delay(5);
+  }
+
+  if (scan.state != SCAN_LOCKED) return false;
+
+  saveChannel(scan.channel);
+  setChannel(scan.channel);
+  return true;
+}
+
+// ----------- Mode Low Power -----------
+// Jam RTC tetap jalan saat deep sleep, millis() mulai dari 0 tiap bangun
+unsigned long nowMs() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000UL + tv.tv_usec / 1000;
+}
+
+// Kirim batch dan tunggu hasilnya; kalau gagal, scan sekali lalu coba lagi
+bool lowPowerFlush(unsigned long now) {
+  for (int attempt = 0; attempt < 2; attempt++) {
+    sendDone = false;
+    if (sendFrame()) {
+      unsigned long start = millis();
+      while (!sendDone && millis() - start < LP_SEND_TIMEOUT_MS) delay(1);
+    }
+
+    if (sendDone && sendOk) {
+      frame.count = 0;
+      lastSendMs = now;
+      lpFlushes++;
+      return true;
+    }
+
+    if (attempt == 0 && !scanBlocking(LP_SCAN_TIMEOUT_MS)) break;
+  }
+
+  return false;
+}
+
+void logCycleBudget(int64_t radioUs) {
+  // esp_timer mulai dari 0 saat bangun (boot ROM tidak terhitung)
+  int64_t awakeUs = esp_timer_get_time();
+  float charge = (awakeUs - radioUs) / 1e6f * ACTIVE_CURRENT_MA
+               + radioUs / 1e6f * RADIO_CURRENT_MA
+               + LP_SAMPLE_INTERVAL_MS / 1000.0f * SLEEP_CURRENT_UA / 1000.0f;
+
+  LOG_INFO("Cycle %lu: awake %lld ms (radio %lld ms), batch %d, ~%.2f mAs/cycle, flushes %lu",
+           (unsigned long)lpCycles, (long long)(awakeUs / 1000), (long long)(radioUs / 1000), frame.count, charge,
+           (unsigned long)lpFlushes);
+  if (awakeUs / 1000 > LP_AWAKE_BUDGET_MS) {
+    LOG_WARN("Cycle over budget (%d ms)", LP_AWAKE_BUDGET_MS);
   }
+}
+
+// Satu siklus: baca, simpan, (kadang) kirim, lalu deep sleep. Tidak kembali.
+void lowPowerCycle() {
+  lpCycles++;
+  if (esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER) delay(DHT_WARMUP_MS);
+
+  unsigned long now = nowMs();
+  readSensors();
+  bool changed = queueSample(now, true);
+
+  bool heartbeat = now - lastSendMs >= LP_HEARTBEAT_INTERVAL_MS;
+  int64_t radioUs = 0;
+  if (frame.count > 0 && (changed || heartbeat || frame.count == SENSOR_FRAME_MAX_SAMPLES)) {
+    int64_t radioStart = esp_timer_get_time();
+    if (initRadio()) lowPowerFlush(now);
+    radioUs = esp_timer_get_time() - radioStart;
+  }
+
+  // Tidak ada task drain di mode ini, kosongkan ring sebelum tidur
+  logCycleBudget(radioUs);
+  logDrainSerial();
+  Serial.flush();
+
+  esp_sleep_enable_timer_wakeup(LP_SAMPLE_INTERVAL_MS * 1000ULL);
+  esp_deep_sleep_start();
+}
+
+// ----------- Setup Program -----------
+void setup() {
+  Serial.begin(115200);
+
+  // Inisialisasi DHT11
+  dht.begin();
+
+#if LOW_POWER_MODE
+  lowPowerCycle();
+#endif
 
-  Serial.println("ESP2 Initialized and Ready to Send Data");
+  // Log ditulis ke Serial oleh task prioritas rendah
+  logBegin();
+
+  if (!initRadio()) return;
+  channelScanStart(scan, loadChannel());
+
+  LOG_INFO("ESP2 Initialized and Ready to Send Data");
 }
 
 // ----------- Loop Program -----------
 void loop() {
+  // Kirim ulang gagal terus: ESP1 kemungkinan pindah channel
+  if (rescanRequested && scan.state == SCAN_LOCKED) {
+    rescanRequested = false;
+    sendFailures = 0;
+    ackChannel = 0;
+    channelScanStart(scan, scan.channel);
+  }
+
+  // Selama scan, data tidak dikirim dan loop berjalan cepat
+  if (scan.state == SCAN_PROBING) {
+    uint8_t probeChannel = channelScanStep(scan, millis(), ackChannel);
+    if (probeChannel != 0) sendProbe(probeChannel);
+
+    if (scan.state == SCAN_LOCKED) {
+      LOG_INFO("ESP1 found on channel %d", scan.channel);
+      saveChannel(scan.channel);
+    }
+
+    delay(5);
+    return;
+  }
+
+  // Jadwal pakai millis() supaya lama pengiriman tidak menggeser interval
+  unsigned long now = millis();
+  if (now - lastSampleMs < SAMPLE_INTERVAL_MS) {
+    delay(SAMPLE_INTERVAL_MS - (now - lastSampleMs));
+    return;
+  }
+  lastSampleMs = now;
+
   // Membaca data dari sensor
   readSensors();
+  queueSample(now, false);
+
+  bool heartbeat = now - lastSendMs >= HEARTBEAT_INTERVAL_MS;
+  if (heartbeat) queueHeartbeat(now);
 
   // Mengirimkan data ke ESP1
-  esp_err_t result = esp_now_send(broadcastAddress, (uint8_t *)&sensorData, sizeof(sensorData));
-  if (result == ESP_OK) {
-    Serial.println("Data sent successfully");
-  } else {
-    Serial.println("Error sending data");
+  if (frame.count == SENSOR_FRAME_MAX_SAMPLES
+      || (frame.count > 0 && (heartbeat || now - frame.timestamp >= MAX_BATCH_DELAY_MS))) {
+    flushFrame(now);
   }
-
-  delay(2000); // Interval pengiriman data
-}
\ No newline at end of file
+}
@@ -0,0 +1,363 @@
+// Cost of the string and JSON hot paths, the way the firmware first built
+// them (String concatenation, std::to_string, strftime) against what it
+// does now (fixed buffers, binary frames) and the ArduinoJson parse of a
+// POST body. Every benchmark reports, besides ns/op:
+//   allocs_per_op  heap allocations (malloc/calloc/realloc) per operation
+//   peak_heap_B    most heap held at once above what it started with
+// and the GET /alarm ones also
+//   bytes_copied   bytes written into buffers per operation: the response
+//                  itself, plus every String temporary and realloc move
+// The heap figures are what set the per-feature budget; ns/op on the host
+// only ranks the alternatives, the ESP32 is roughly 20-50x slower.
+//
+// The ArduinoJson numbers are for the bundled subset unless the build is
+// configured with ARDUINOJSON_INCLUDE_DIR pointing at the real library.
+#include "esp1.cpp"
+
+#include <benchmark/benchmark.h>
+#include <malloc.h>
+
+#include <chrono>
+#include <string>
+
+#include "sim.h"
+
+/* ===== Heap accounting ==== */
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void __libc_free(void* ptr);
+
+static std::atomic<uint64_t> heapAllocs(0);
+static std::atomic<int64_t> heapLive(0);
+static std::atomic<int64_t> heapPeak(0);
+static std::atomic<uint64_t> heapMoved(0);  // bytes realloc copied to a new block
+
+static void heapTrack(int64_t delta) {
+  int64_t live = heapLive.fetch_add(delta) + delta;
+  int64_t peak = heapPeak.load();
+  while (live > peak && !heapPeak.compare_exchange_weak(peak, live)) {}
+}
+
+extern "C" void* malloc(size_t size) {
+  void* ptr = __libc_malloc(size);
+  if (ptr) {
+    heapAllocs++;
+    heapTrack(malloc_usable_size(ptr));
+  }
+  return ptr;
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+  void* ptr = __libc_calloc(count, size);
+  if (ptr) {
+    heapAllocs++;
+    heapTrack(malloc_usable_size(ptr));
+  }
+  return ptr;
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+  int64_t before = ptr ? malloc_usable_size(ptr) : 0;
+  void* grown = __libc_realloc(ptr, size);
+  if (grown) {
+    heapAllocs++;
+    if (ptr && grown != ptr) heapMoved += std::min<uint64_t>(before, size);
+    heapTrack((int64_t)malloc_usable_size(grown) - before);
+  }
+  return grown;
+}
+
+extern "C" void free(void* ptr) {
+  if (ptr) heapTrack(-(int64_t)malloc_usable_size(ptr));
+  __libc_free(ptr);
+}
+
+// Counts the heap over the timed loop and reports it per operation
+class HeapScope {
+public:
+  explicit HeapScope(benchmark::State& state) : state(state) {
+    allocs = heapAllocs.load();
+    live = heapLive.load();
+    heapPeak = live;
+  }
+
+  // Read before the counters map allocates its own nodes
+  ~HeapScope() {
+    double count = heapAllocs.load() - allocs;
+    double peak = heapPeak.load() - live;
+    state.counters["allocs_per_op"] = benchmark::Counter(count, benchmark::Counter::kAvgIterations);
+    state.counters["peak_heap_B"] = peak;
+  }
+
+private:
+  benchmark::State& state;
+  uint64_t allocs;
+  int64_t live;
+};
+
+/* ===== Fixtures ==== */
+static void fillAlarms(int count) {
+  alarmInit();
+  alarmBuildFreeList();
+  for (int i = 0; i < count; i++) {
+    AlarmEntry entry = {};
+    entry.seconds = (6 * 3600 + i * 60) % SECONDS_PER_DAY;
+    entry.days = i % 2 ? 0x3e : 0;
+    entry.flags = ALARM_ENABLED;
+    snprintf(entry.label, sizeof(entry.label), "Alarm %d", i);
+    int slot = alarmAlloc();
+    alarmSet(slot, entry);
+  }
+}
+
+static void setClock() {
+  simSetWallClock(1700000000LL * 1000000);
+  clockUtcOffset = 7 * 3600;
+}
+
+/* ===== GET /alarm ==== */
+static void reportBytesCopied(benchmark::State& state, uint64_t bytes) {
+  state.counters["bytes_copied"] = benchmark::Counter(bytes, benchmark::Counter::kAvgIterations);
+}
+
+// The original handler: one String grown by concatenation, sent whole
+static void BM_AlarmList_StringConcat(benchmark::State& state) {
+  fillAlarms(state.range(0));
+  uint64_t copied = simStringBytesCopied() + heapMoved;
+  HeapScope heap(state);
+  for (auto _ : state) {
+    String json = "{";
+    json += "\"alarms\": [";
+    for (int i = 0; i < MAX_ALARM; i++) {
+      AlarmEntry alarm;
+      if (!alarmGet(i, alarm)) continue;
+      char time[16];
+      snprintf(time, sizeof(time), "%02lu:%02lu", (unsigned long)(alarm.seconds / 3600),
+               (unsigned long)(alarm.seconds / 60 % 60));
+      json += "{\"id\":\"" + String(i) + "\"";
+      json += ",\"time\":\"" + String(time) + "\"";
+      json += ",\"label\":\"" + String(alarm.label) + "\"},";
+    }
+    json += "]}";
+    benchmark::DoNotOptimize(json.c_str());
+  }
+  reportBytesCopied(state, simStringBytesCopied() + heapMoved - copied);
+}
+
+// Now: fillAlarmJson streamed into TCP-sized chunks, as AsyncTCP drains it
+static void BM_AlarmList_ChunkedSnprintf(benchmark::State& state) {
+  fillAlarms(state.range(0));
+  uint8_t chunk[1436];
+  uint64_t copied = 0;
+  HeapScope heap(state);
+  for (auto _ : state) {
+    AlarmJsonWriter writer;
+    writer.next = 0;
+    writer.remaining = ALARM_PAGE_MAX;
+    writer.first = true;
+    writer.revision = alarmRevision;
+    writer.length = strlcpy(writer.record, "{\"alarms\":[", sizeof(writer.record));
+    writer.sent = 0;
+    size_t total = 0;
+    while (size_t n = fillAlarmJson(writer, chunk, sizeof(chunk))) total += n;
+    benchmark::DoNotOptimize(total);
+    copied += total;
+  }
+  reportBytesCopied(state, copied);
+}
+
+// Now, WebSocket snapshot and sync events: the binary alarm entry
+static void BM_AlarmList_Binary(benchmark::State& state) {
+  fillAlarms(state.range(0));
+  static uint8_t frame[MAX_ALARM * (9 + ALARM_LABEL_MAX_LEN)];
+  uint64_t copied = 0;
+  HeapScope heap(state);
+  for (auto _ : state) {
+    size_t length = 0;
+    for (int i = 0; i < MAX_ALARM; i++) {
+      if (alarmLists[i].seconds == ALARM_TIME_INVALID) continue;
+      length += encodeAlarmEntry(frame + length, i);
+    }
+    benchmark::DoNotOptimize(length);
+    copied += length;
+  }
+  reportBytesCopied(state, copied);
+}
+
+BENCHMARK(BM_AlarmList_StringConcat)->Arg(8)->Arg(64)->Arg(MAX_ALARM);
+BENCHMARK(BM_AlarmList_ChunkedSnprintf)->Arg(8)->Arg(64)->Arg(MAX_ALARM);
+BENCHMARK(BM_AlarmList_Binary)->Arg(8)->Arg(64)->Arg(MAX_ALARM);
+
+/* ===== DHT frame (OnDataRecv) ==== */
+static const SensorSample dhtSample = { 0, 273, 615 };
+
+static void BM_DhtFrame_StringConcat(benchmark::State& state) {
+  HeapScope heap(state);
+  for (auto _ : state) {
+    String json = "{";
+    json += "\"T\":\"" + String((int)(dhtSample.T / 10)) + "\"";
+    json += ",\"H\":\"" + String((int)(dhtSample.H / 10)) + "\"}";
+    benchmark::DoNotOptimize(json.c_str());
+  }
+}
+
+static void BM_DhtFrame_Snprintf(benchmark::State& state) {
+  HeapScope heap(state);
+  for (auto _ : state) {
+    char json[40];
+    int n = snprintf(json, sizeof(json), "{\"T\":%d.%d,\"H\":%d.%d}", dhtSample.T / 10, abs(dhtSample.T % 10),
+                     dhtSample.H / 10, dhtSample.H % 10);
+    benchmark::DoNotOptimize(json);
+    benchmark::DoNotOptimize(n);
+  }
+}
+
+// Now: TOPIC_DHT payload as built in taskSensorConsumer
+static void BM_DhtFrame_Binary(benchmark::State& state) {
+  HeapScope heap(state);
+  for (auto _ : state) {
+    uint8_t payload[6] = { 0, 1, (uint8_t)dhtSample.T, (uint8_t)(dhtSample.T >> 8), (uint8_t)dhtSample.H,
+                           (uint8_t)(dhtSample.H >> 8) };
+    benchmark::DoNotOptimize(payload);
+  }
+}
+
+BENCHMARK(BM_DhtFrame_StringConcat);
+BENCHMARK(BM_DhtFrame_Snprintf);
+BENCHMARK(BM_DhtFrame_Binary);
+
+/* ===== Pollution value (taskAirPollutionSensor) ==== */
+static void BM_Pollution_ToString(benchmark::State& state) {
+  int gasValue = 1432;
+  HeapScope heap(state);
+  for (auto _ : state) {
+    String value = std::to_string(gasValue).c_str();
+    benchmark::DoNotOptimize(value.c_str());
+  }
+}
+
+static void BM_Pollution_Snprintf(benchmark::State& state) {
+  int gasValue = 1432;
+  HeapScope heap(state);
+  for (auto _ : state) {
+    char value[8];
+    snprintf(value, sizeof(value), "%d", gasValue);
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+static void BM_Pollution_Binary(benchmark::State& state) {
+  uint16_t ppm = 1432;
+  HeapScope heap(state);
+  for (auto _ : state) {
+    uint8_t payload[2] = { (uint8_t)ppm, (uint8_t)(ppm >> 8) };
+    benchmark::DoNotOptimize(payload);
+  }
+}
+
+BENCHMARK(BM_Pollution_ToString);
+BENCHMARK(BM_Pollution_Snprintf);
+BENCHMARK(BM_Pollution_Binary);
+
+/* ===== Clock (taskUpdateTime) ==== */
+static void BM_Time_StrftimeString(benchmark::State& state) {
+  setClock();
+  HeapScope heap(state);
+  for (auto _ : state) {
+    time_t now = time(NULL) + clockUtcOffset;
+    struct tm timeinfo;
+    gmtime_r(&now, &timeinfo);
+    char buffer[50];
+    strftime(buffer, sizeof(buffer), "%H:%M:%S", &timeinfo);
+    String currentTime = String(buffer);
+    benchmark::DoNotOptimize(currentTime.c_str());
+  }
+}
+
+static void BM_Time_Snprintf(benchmark::State& state) {
+  setClock();
+  HeapScope heap(state);
+  for (auto _ : state) {
+    uint32_t local = (time(NULL) + clockUtcOffset) % SECONDS_PER_DAY;
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%02lu:%02lu:%02lu", (unsigned long)(local / 3600),
+             (unsigned long)(local / 60 % 60), (unsigned long)(local % 60));
+    benchmark::DoNotOptimize(buffer);
+  }
+}
+
+// Now: one 12-byte sync, the dashboard ticks the seconds itself
+static void BM_Time_BinarySync(benchmark::State& state) {
+  setClock();
+  HeapScope heap(state);
+  for (auto _ : state) {
+    uint8_t payload[12];
+    benchmark::DoNotOptimize(encodeTimeSync(payload));
+    benchmark::DoNotOptimize(payload);
+  }
+}
+
+BENCHMARK(BM_Time_StrftimeString);
+BENCHMARK(BM_Time_Snprintf);
+BENCHMARK(BM_Time_BinarySync);
+
+/* ===== Log line (clock_log.h) ==== */
+#define LOG_BAUD 115200
+#define LOG_BITS_PER_BYTE 10  // start, 8 data, stop
+
+// Before the ring: the caller formatted the line and wrote it to Serial
+// itself, blocked until the UART had shifted every byte out
+static void BM_Log_BlockingSerial(benchmark::State& state) {
+  uint16_t ppm = 1432;
+  HeapScope heap(state);
+  for (auto _ : state) {
+    LogLine record;
+    record.ms = millis();
+    record.level = LOG_LEVEL_INFO;
+    int length = snprintf(record.text, sizeof(record.text), "Pollution %u ppm, sensor %d", ppm, 2);
+    record.length = (uint8_t)constrain(length, 0, LOG_TEXT_MAX - 1);
+    char line[LOG_FORMATTED_MAX];
+    size_t bytes = logFormat(record, line, sizeof(line));
+
+    // Spins like the TX FIFO wait does, sleeping would round up to the tick
+    auto done = std::chrono::steady_clock::now()
+                + std::chrono::nanoseconds(bytes * LOG_BITS_PER_BYTE * 1000000000ULL / LOG_BAUD);
+    while (std::chrono::steady_clock::now() < done) {}
+    benchmark::DoNotOptimize(line);
+  }
+}
+
+// Now: one enabled LOG_INFO formats into a local record and copies it into
+// the ring; the UART time moves to the drain task
+static void BM_Log_Ring(benchmark::State& state) {
+  uint16_t ppm = 1432;
+  HeapScope heap(state);
+  for (auto _ : state) LOG_INFO("Pollution %u ppm, sensor %d", ppm, 2);
+}
+
+BENCHMARK(BM_Log_BlockingSerial)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Log_Ring);
+
+/* ===== POST /alarm body ==== */
+static const char alarmBody[] = "{\"time\":\"06:45\",\"label\":\"Morning run\",\"days\":62,\"enabled\":true}";
+
+// The handler parses in place from its body slot, so no string copies
+static void BM_AlarmBody_StaticJsonDocument(benchmark::State& state) {
+  char body[sizeof(alarmBody)];
+  HeapScope heap(state);
+  for (auto _ : state) {
+    memcpy(body, alarmBody, sizeof(alarmBody));
+    StaticJsonDocument<BODY_JSON_CAPACITY> json;
+    DeserializationError error = deserializeJson(json, body, sizeof(alarmBody) - 1);
+    uint32_t seconds = parseAlarmTime(json["time"] | "");
+    uint8_t days = json["days"] | 0;
+    benchmark::DoNotOptimize(error);
+    benchmark::DoNotOptimize(seconds);
+    benchmark::DoNotOptimize(days);
+  }
+}
+
+BENCHMARK(BM_AlarmBody_StaticJsonDocument);
+
+BENCHMARK_MAIN();
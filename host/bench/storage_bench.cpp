@@ -0,0 +1,147 @@
+// Flash cost of the storage log, run the way taskStorage runs it against
+// the host directory that stands in for LittleFS. Reports, besides ns/op:
+//   flash_B_per_op  bytes written per logical change, the index rewrites
+//                   and compactions it triggers included
+//   compactions     storageCompact runs over the whole benchmark
+//   records_read    log records replayed per boot
+// Replay time is host file I/O, so only the ratio between the indexed and
+// the full-scan boot carries over to the ESP32.
+#include "esp1.cpp"
+
+#include <benchmark/benchmark.h>
+#include <stdlib.h>
+
+#include "sim.h"
+
+/* ===== Fixtures ==== */
+static const uint32_t START = 1700000000 - 1700000000 % 900;
+
+// Fresh flash, RAM and log
+static void storageBoot() {
+  char dir[] = "/tmp/storage_bench_XXXXXX";
+  if (mkdtemp(dir) == NULL) abort();
+  simFsSetRoot(dir);
+  if (logFile) logFile.close();
+  alarmInit();
+  historyInit();
+  historyPersistCount = 0;
+  memset(&logHistoryBatch, 0, sizeof(logHistoryBatch));
+  memset(storageAlarmDirtyBits, 0, sizeof(storageAlarmDirtyBits));
+  logNeedsCompaction = false;
+  storageReplay();
+  alarmBuildFreeList();
+  logFile = LittleFS.open(LOG_PATH, "a");
+}
+
+// One taskStorage wakeup
+static void storageWake() {
+  storageFlushAlarms();
+  storageCollectHistory();
+  if (logNeedsCompaction || logIndex.length + logAppendsSinceIndex * LOG_RECORD_SIZE > LOG_COMPACT_BYTES) {
+    storageCompact();
+  }
+}
+
+static void setAlarm(int slot, uint32_t seconds) {
+  AlarmEntry entry = {};
+  entry.seconds = seconds % SECONDS_PER_DAY;
+  entry.days = ALARM_DAYS_ALL;
+  entry.flags = ALARM_ENABLED;
+  snprintf(entry.label, sizeof(entry.label), "Alarm %d", slot);
+  portENTER_CRITICAL(&alarmMux);
+  alarmSet(slot, entry);
+  storageAlarmDirty(slot);
+  portEXIT_CRITICAL(&alarmMux);
+}
+
+// Counts the flash written over the timed loop and reports it per operation
+class FlashScope {
+public:
+  explicit FlashScope(benchmark::State& state) : state(state) {
+    bytes = simFsBytesWritten();
+    compactions = logCompactions;
+  }
+
+  ~FlashScope() {
+    double written = simFsBytesWritten() - bytes;
+    state.counters["flash_B_per_op"] = benchmark::Counter(written, benchmark::Counter::kAvgIterations);
+    state.counters["compactions"] = logCompactions - compactions;
+  }
+
+private:
+  benchmark::State& state;
+  uint64_t bytes;
+  uint32_t compactions;
+};
+
+/* ===== Logical changes ==== */
+// One alarm edited per wakeup, cycling over range(0) live alarms
+static void BM_Storage_AlarmChange(benchmark::State& state) {
+  storageBoot();
+  int alarms = state.range(0);
+  for (int slot = 0; slot < alarms; slot++) setAlarm(slot, slot * 60);
+  storageWake();
+
+  uint32_t n = 0;
+  FlashScope flash(state);
+  for (auto _ : state) {
+    setAlarm(n % alarms, n * 60);
+    storageWake();
+    n++;
+  }
+}
+
+// One closed 15 min bucket per wakeup, batched LOG_HISTORY_BATCH to a record
+static void BM_Storage_HistoryChange(benchmark::State& state) {
+  storageBoot();
+  uint32_t n = 0;
+  FlashScope flash(state);
+  for (auto _ : state) {
+    historyAdd(HISTORY_METRIC_PPM, START + n * 900, 100 + n % 400);
+    storageWake();
+    n++;
+  }
+}
+
+BENCHMARK(BM_Storage_AlarmChange)->Arg(8)->Arg(MAX_ALARM);
+BENCHMARK(BM_Storage_HistoryChange);
+
+/* ===== Boot replay ==== */
+// A log compacted once and then appended to for a while: every alarm
+// slot live, a week of history, and range(1) more alarm edits after the
+// compaction. range(0) keeps (1) or drops (0) the index block.
+static void BM_Storage_Replay(benchmark::State& state) {
+  storageBoot();
+  for (int slot = 0; slot < MAX_ALARM; slot++) setAlarm(slot, slot * 60);
+  for (uint32_t i = 0; i <= HISTORY_TIER_15M_LEN; i++) {
+    for (int m = 0; m < HISTORY_METRICS; m++) historyAdd(m, START + i * 900, 100 + i % 400);
+    storageWake();
+  }
+  storageCompact();
+  for (int i = 0; i < state.range(1); i++) {
+    setAlarm(i % MAX_ALARM, i * 60 + 30);
+    storageWake();
+  }
+  logFile.close();
+  if (!state.range(0)) LittleFS.remove(LOG_INDEX_PATH);
+
+  uint32_t replayed = logRecordsReplayed;
+  for (auto _ : state) {
+    alarmInit();
+    historyInit();
+    storageReplay();
+  }
+  state.counters["records_read"] =
+      benchmark::Counter(logRecordsReplayed - replayed, benchmark::Counter::kAvgIterations);
+  state.counters["log_B"] = logIndex.length + logAppendsSinceIndex * LOG_RECORD_SIZE;
+}
+
+BENCHMARK(BM_Storage_Replay)
+    ->ArgNames({ "index", "appends" })
+    ->Args({ 0, 0 })
+    ->Args({ 1, 0 })
+    ->Args({ 0, 200 })
+    ->Args({ 1, 200 })
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
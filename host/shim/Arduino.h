@@ -0,0 +1,180 @@
+// Host shim for the parts of the ESP32 Arduino core that esp1.cpp and
+// esp2.cpp use, so the sketches build and run on Linux. Behaviour follows
+// the real core where the firmware depends on it (String grows its buffer
+// to the exact length, Print::printf formats through a 64-byte stack
+// buffer), everything else is the simplest thing that works.
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "freertos_shim.h"
+#include "esp_shim.h"
+
+using std::isnan;
+using std::max;
+using std::min;
+
+#define PROGMEM
+#define IRAM_ATTR
+#define RTC_DATA_ATTR
+#define DRAM_ATTR
+
+#define LOW 0x0
+#define HIGH 0x1
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define ADC_0db 0
+#define ADC_2_5db 1
+#define ADC_6db 2
+#define ADC_11db 3
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+uint16_t analogRead(uint8_t pin);
+void analogSetAttenuation(int attenuation);
+void analogReadResolution(uint8_t bits);
+
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1,
+                const char* server2 = nullptr, const char* server3 = nullptr);
+
+uint32_t getCpuFrequencyMhz();
+#define getCpuFreqMHz getCpuFrequencyMhz
+
+uint32_t esp_random();
+
+// glibc has its own from 2.38 on
+#if !defined(__GLIBC__) || !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dst, const char* src, size_t size);
+#endif
+
+class String {
+public:
+  String(const char* cstr = "");
+  String(const String& other);
+  String(String&& other) noexcept;
+  explicit String(char c);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(float value, unsigned int decimals = 2);
+  explicit String(double value, unsigned int decimals = 2);
+  ~String();
+
+  String& operator=(const String& other);
+  String& operator=(String&& other) noexcept;
+  String& operator=(const char* cstr);
+
+  bool reserve(unsigned int size);
+  unsigned int length() const { return len; }
+  bool isEmpty() const { return len == 0; }
+  const char* c_str() const { return buffer ? buffer : ""; }
+
+  bool concat(const char* cstr, unsigned int length);
+  bool concat(const char* cstr) { return concat(cstr, cstr ? strlen(cstr) : 0); }
+  bool concat(const String& other) { return concat(other.c_str(), other.len); }
+  bool concat(char c) { return concat(&c, 1); }
+  bool concat(int value);
+  bool concat(unsigned int value);
+  bool concat(long value);
+  bool concat(unsigned long value);
+
+  template <typename T>
+  String& operator+=(const T& value) {
+    concat(value);
+    return *this;
+  }
+
+  bool equals(const char* cstr) const;
+  bool operator==(const String& other) const { return equals(other.c_str()); }
+  bool operator==(const char* cstr) const { return equals(cstr); }
+  bool operator!=(const String& other) const { return !equals(other.c_str()); }
+  bool operator!=(const char* cstr) const { return !equals(cstr); }
+
+  char charAt(unsigned int index) const { return index < len ? buffer[index] : 0; }
+  char operator[](unsigned int index) const { return charAt(index); }
+
+  int indexOf(char c, unsigned int from = 0) const;
+  int indexOf(const char* cstr, unsigned int from = 0) const;
+  int indexOf(const String& other, unsigned int from = 0) const { return indexOf(other.c_str(), from); }
+  bool startsWith(const char* prefix) const;
+  bool startsWith(const String& prefix) const { return startsWith(prefix.c_str()); }
+  bool endsWith(const char* suffix) const;
+  bool endsWith(const String& suffix) const { return endsWith(suffix.c_str()); }
+  String substring(unsigned int from) const { return substring(from, len); }
+  String substring(unsigned int from, unsigned int to) const;
+  long toInt() const { return atol(c_str()); }
+
+private:
+  char* buffer = nullptr;
+  unsigned int capacity = 0;
+  unsigned int len = 0;
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+  size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+  size_t print(const char* str) { return write(str); }
+  size_t print(const String& str) { return write(str.c_str(), str.length()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int value) { return printf("%d", value); }
+  size_t print(unsigned int value) { return printf("%u", value); }
+  size_t print(long value) { return printf("%ld", value); }
+  size_t print(unsigned long value) { return printf("%lu", value); }
+  size_t print(double value, int digits = 2) { return printf("%.*f", digits, value); }
+
+  template <typename T>
+  size_t println(const T& value) {
+    size_t n = print(value);
+    return n + write("\r\n");
+  }
+  size_t println() { return write("\r\n"); }
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud) {}
+  void end() {}
+  void flush();
+  int availableForWrite() { return 128; }
+  operator bool() const { return true; }
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+};
+
+extern HardwareSerial Serial;
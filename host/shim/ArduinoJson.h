@@ -0,0 +1,471 @@
+// The slice of ArduinoJson 6 the firmware uses: StaticJsonDocument,
+// deserializeJson() and reading values back. Pool accounting follows the
+// library on a 32-bit target, one 16-byte slot per member or element, so
+// a document runs out of memory where it would on the chip. Strings in a
+// mutable input are unescaped in place and point into it (zero-copy), as
+// the library does for char* input.
+//
+// Configure with -DARDUINOJSON_INCLUDE_DIR=<ArduinoJson/src> to build
+// against the real library instead; that directory is searched first.
+#pragma once
+
+#include <Arduino.h>
+#include <cerrno>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#define ARDUINOJSON_SLOT_SIZE 16
+#define ARDUINOJSON_DEFAULT_NESTING_LIMIT 10
+
+class DeserializationError {
+public:
+  enum Code {
+    Ok,
+    EmptyInput,
+    IncompleteInput,
+    InvalidInput,
+    NoMemory,
+    TooDeep,
+  };
+
+  DeserializationError(Code code = Ok) : value(code) {}
+  explicit operator bool() const { return value != Ok; }
+  Code code() const { return value; }
+  bool operator==(Code other) const { return value == other; }
+  bool operator!=(Code other) const { return value != other; }
+
+  const char* c_str() const {
+    static const char* const names[] = { "Ok", "EmptyInput", "IncompleteInput", "InvalidInput", "NoMemory", "TooDeep" };
+    return names[value];
+  }
+
+private:
+  Code value;
+};
+
+namespace ArduinoJsonShim {
+
+enum class Type : uint8_t { Null, Bool, Integer, Float, String, Object, Array };
+
+#define ARDUINOJSON_NO_SLOT 0xffff
+
+struct Slot {
+  Type type = Type::Null;
+  const char* key = nullptr;  // member name inside an object
+  uint16_t next = ARDUINOJSON_NO_SLOT;
+  uint16_t child = ARDUINOJSON_NO_SLOT;  // first member or element
+  union {
+    bool boolean;
+    long long integer;
+    double real;
+    const char* string;
+  };
+  Slot() : integer(0) {}
+};
+
+}  // namespace ArduinoJsonShim
+
+class JsonDocument;
+
+class JsonVariantConst {
+public:
+  JsonVariantConst() {}
+  JsonVariantConst(const JsonDocument* doc, const ArduinoJsonShim::Slot* slot) : doc(doc), slot(slot) {}
+
+  bool isNull() const { return slot == nullptr || slot->type == ArduinoJsonShim::Type::Null; }
+
+  template <typename T>
+  bool is() const {
+    using ArduinoJsonShim::Type;
+    if (slot == nullptr) return false;
+    if constexpr (std::is_same<T, bool>::value) {
+      return slot->type == Type::Bool;
+    } else if constexpr (std::is_integral<T>::value) {
+      return slot->type == Type::Integer && slot->integer >= (long long)std::numeric_limits<T>::min()
+             && (slot->integer < 0 || (unsigned long long)slot->integer <= (unsigned long long)std::numeric_limits<T>::max());
+    } else if constexpr (std::is_floating_point<T>::value) {
+      return slot->type == Type::Integer || slot->type == Type::Float;
+    } else if constexpr (std::is_same<T, const char*>::value || std::is_same<T, String>::value) {
+      return slot->type == Type::String;
+    } else {
+      static_assert(sizeof(T) == 0, "type not supported by the ArduinoJson shim");
+      return false;
+    }
+  }
+
+  template <typename T>
+  T as() const {
+    using ArduinoJsonShim::Type;
+    if constexpr (std::is_same<T, bool>::value) {
+      if (slot == nullptr) return false;
+      if (slot->type == Type::Bool) return slot->boolean;
+      if (slot->type == Type::Integer) return slot->integer != 0;
+      return false;
+    } else if constexpr (std::is_arithmetic<T>::value) {
+      if (slot == nullptr) return 0;
+      if (slot->type == Type::Integer) return is<T>() || std::is_floating_point<T>::value ? (T)slot->integer : 0;
+      if (slot->type == Type::Float) return (T)slot->real;
+      if (slot->type == Type::Bool) return slot->boolean;
+      return 0;
+    } else if constexpr (std::is_same<T, const char*>::value) {
+      return slot != nullptr && slot->type == Type::String ? slot->string : nullptr;
+    } else if constexpr (std::is_same<T, String>::value) {
+      return String(as<const char*>());
+    } else {
+      static_assert(sizeof(T) == 0, "type not supported by the ArduinoJson shim");
+    }
+  }
+
+  template <typename T>
+  operator T() const {
+    return as<T>();
+  }
+
+  // The value when it has type T, otherwise the default
+  template <typename T>
+  T operator|(T fallback) const {
+    return is<T>() ? as<T>() : fallback;
+  }
+
+  JsonVariantConst operator[](const char* key) const;
+  JsonVariantConst operator[](size_t index) const;
+  JsonVariantConst operator[](int index) const { return (*this)[(size_t)index]; }
+  bool containsKey(const char* key) const { return !(*this)[key].isNull() || memberExists(key); }
+  size_t size() const;
+
+private:
+  bool memberExists(const char* key) const;
+
+  const JsonDocument* doc = nullptr;
+  const ArduinoJsonShim::Slot* slot = nullptr;
+};
+
+typedef JsonVariantConst JsonVariant;
+
+class JsonDocument {
+public:
+  JsonDocument(const JsonDocument&) = delete;
+  JsonDocument& operator=(const JsonDocument&) = delete;
+
+  JsonVariantConst as() const { return JsonVariantConst(this, &root); }
+  JsonVariantConst operator[](const char* key) const { return as()[key]; }
+  JsonVariantConst operator[](size_t index) const { return as()[index]; }
+  JsonVariantConst operator[](int index) const { return as()[(size_t)index]; }
+  bool containsKey(const char* key) const { return as().containsKey(key); }
+  bool isNull() const { return as().isNull(); }
+
+  size_t capacity() const { return slotCapacity * ARDUINOJSON_SLOT_SIZE; }
+  size_t memoryUsage() const { return slotsUsed * ARDUINOJSON_SLOT_SIZE; }
+  void clear() {
+    root = ArduinoJsonShim::Slot();
+    slotsUsed = 0;
+    copiedInput.clear();
+  }
+
+  const ArduinoJsonShim::Slot* slotAt(uint16_t index) const {
+    return index == ARDUINOJSON_NO_SLOT ? nullptr : &slots[index];
+  }
+
+protected:
+  JsonDocument(ArduinoJsonShim::Slot* slots, size_t slotCapacity) : slots(slots), slotCapacity(slotCapacity) {}
+
+private:
+  friend class JsonParser;
+
+  ArduinoJsonShim::Slot* slots;
+  size_t slotCapacity;
+  size_t slotsUsed = 0;
+  ArduinoJsonShim::Slot root;
+  std::string copiedInput;  // const input is copied, then parsed in place
+};
+
+template <size_t Capacity>
+class StaticJsonDocument : public JsonDocument {
+public:
+  StaticJsonDocument() : JsonDocument(pool, sizeof(pool) / sizeof(pool[0])) {}
+
+private:
+  ArduinoJsonShim::Slot pool[Capacity / ARDUINOJSON_SLOT_SIZE > 0 ? Capacity / ARDUINOJSON_SLOT_SIZE : 1];
+};
+
+inline JsonVariantConst JsonVariantConst::operator[](const char* key) const {
+  if (slot == nullptr || slot->type != ArduinoJsonShim::Type::Object) return JsonVariantConst();
+  for (const ArduinoJsonShim::Slot* member = doc->slotAt(slot->child); member; member = doc->slotAt(member->next)) {
+    if (strcmp(member->key, key) == 0) return JsonVariantConst(doc, member);
+  }
+  return JsonVariantConst();
+}
+
+inline JsonVariantConst JsonVariantConst::operator[](size_t index) const {
+  if (slot == nullptr || slot->type != ArduinoJsonShim::Type::Array) return JsonVariantConst();
+  const ArduinoJsonShim::Slot* element = doc->slotAt(slot->child);
+  for (; element && index > 0; index--) element = doc->slotAt(element->next);
+  return element ? JsonVariantConst(doc, element) : JsonVariantConst();
+}
+
+inline bool JsonVariantConst::memberExists(const char* key) const {
+  if (slot == nullptr || slot->type != ArduinoJsonShim::Type::Object) return false;
+  for (const ArduinoJsonShim::Slot* member = doc->slotAt(slot->child); member; member = doc->slotAt(member->next)) {
+    if (strcmp(member->key, key) == 0) return true;
+  }
+  return false;
+}
+
+inline size_t JsonVariantConst::size() const {
+  if (slot == nullptr || (slot->type != ArduinoJsonShim::Type::Object && slot->type != ArduinoJsonShim::Type::Array)) return 0;
+  size_t n = 0;
+  for (const ArduinoJsonShim::Slot* child = doc->slotAt(slot->child); child; child = doc->slotAt(child->next)) n++;
+  return n;
+}
+
+class JsonParser {
+public:
+  JsonParser(JsonDocument& doc, char* input, size_t length) : doc(doc), p(input), end(input + length) {}
+
+  DeserializationError parse() {
+    doc.root = ArduinoJsonShim::Slot();
+    doc.slotsUsed = 0;
+
+    skipSpace();
+    if (atEnd()) return DeserializationError::EmptyInput;
+    return parseValue(doc.root, 0);
+  }
+
+private:
+  typedef DeserializationError Error;
+
+  bool atEnd() const { return p >= end || *p == '\0'; }
+
+  void skipSpace() {
+    while (!atEnd() && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+  }
+
+  ArduinoJsonShim::Slot* allocSlot(uint16_t& index) {
+    if (doc.slotsUsed >= doc.slotCapacity) return nullptr;
+    index = doc.slotsUsed++;
+    doc.slots[index] = ArduinoJsonShim::Slot();
+    return &doc.slots[index];
+  }
+
+  Error parseValue(ArduinoJsonShim::Slot& out, int depth) {
+    skipSpace();
+    if (atEnd()) return Error::IncompleteInput;
+
+    switch (*p) {
+      case '{': return parseContainer(out, depth, true);
+      case '[': return parseContainer(out, depth, false);
+      case '"':
+      case '\'': {
+        const char* text;
+        Error error = parseString(text);
+        if (error) return error;
+        out.type = ArduinoJsonShim::Type::String;
+        out.string = text;
+        return Error::Ok;
+      }
+      case 't': return parseLiteral(out, "true");
+      case 'f': return parseLiteral(out, "false");
+      case 'n': return parseLiteral(out, "null");
+      default: return parseNumber(out);
+    }
+  }
+
+  Error parseContainer(ArduinoJsonShim::Slot& out, int depth, bool object) {
+    if (depth >= ARDUINOJSON_DEFAULT_NESTING_LIMIT) return Error::TooDeep;
+    out.type = object ? ArduinoJsonShim::Type::Object : ArduinoJsonShim::Type::Array;
+    out.child = ARDUINOJSON_NO_SLOT;
+    char close = object ? '}' : ']';
+    p++;
+
+    skipSpace();
+    if (atEnd()) return Error::IncompleteInput;
+    if (*p == close) {
+      p++;
+      return Error::Ok;
+    }
+
+    uint16_t* link = &out.child;
+    while (1) {
+      const char* key = nullptr;
+      if (object) {
+        skipSpace();
+        if (atEnd()) return Error::IncompleteInput;
+        if (*p != '"' && *p != '\'') return Error::InvalidInput;
+        Error error = parseString(key);
+        if (error) return error;
+        skipSpace();
+        if (atEnd()) return Error::IncompleteInput;
+        if (*p != ':') return Error::InvalidInput;
+        p++;
+      }
+
+      uint16_t index;
+      ArduinoJsonShim::Slot* slot = allocSlot(index);
+      if (slot == nullptr) return Error::NoMemory;
+      slot->key = key;
+      *link = index;
+      link = &slot->next;
+
+      Error error = parseValue(*slot, depth + 1);
+      if (error) return error;
+
+      skipSpace();
+      if (atEnd()) return Error::IncompleteInput;
+      if (*p == close) {
+        p++;
+        return Error::Ok;
+      }
+      if (*p != ',') return Error::InvalidInput;
+      p++;
+    }
+  }
+
+  static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+  }
+
+  bool readHex4(uint32_t& value) {
+    value = 0;
+    for (int i = 0; i < 4; i++) {
+      if (atEnd()) return false;
+      int digit = hexValue(*p++);
+      if (digit < 0) return false;
+      value = value << 4 | digit;
+    }
+    return true;
+  }
+
+  static char* putUtf8(char* w, uint32_t code) {
+    if (code < 0x80) {
+      *w++ = code;
+    } else if (code < 0x800) {
+      *w++ = 0xc0 | code >> 6;
+      *w++ = 0x80 | (code & 0x3f);
+    } else if (code < 0x10000) {
+      *w++ = 0xe0 | code >> 12;
+      *w++ = 0x80 | (code >> 6 & 0x3f);
+      *w++ = 0x80 | (code & 0x3f);
+    } else {
+      *w++ = 0xf0 | code >> 18;
+      *w++ = 0x80 | (code >> 12 & 0x3f);
+      *w++ = 0x80 | (code >> 6 & 0x3f);
+      *w++ = 0x80 | (code & 0x3f);
+    }
+    return w;
+  }
+
+  // Unescapes in place; the result never outgrows the escaped text
+  Error parseString(const char*& out) {
+    char quote = *p++;
+    char* w = p;
+    out = w;
+
+    while (1) {
+      if (atEnd()) return Error::IncompleteInput;
+      char c = *p++;
+      if (c == quote) break;
+      if (c != '\\') {
+        *w++ = c;
+        continue;
+      }
+
+      if (atEnd()) return Error::IncompleteInput;
+      c = *p++;
+      switch (c) {
+        case '"': case '\'': case '\\': case '/': *w++ = c; break;
+        case 'b': *w++ = '\b'; break;
+        case 'f': *w++ = '\f'; break;
+        case 'n': *w++ = '\n'; break;
+        case 'r': *w++ = '\r'; break;
+        case 't': *w++ = '\t'; break;
+        case 'u': {
+          uint32_t code;
+          if (!readHex4(code)) return atEnd() ? Error::IncompleteInput : Error::InvalidInput;
+          if (code >= 0xd800 && code < 0xdc00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+            p += 2;
+            uint32_t low;
+            if (!readHex4(low)) return Error::InvalidInput;
+            code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+          }
+          w = putUtf8(w, code);
+          break;
+        }
+        default: return Error::InvalidInput;
+      }
+    }
+
+    *w = '\0';
+    return Error::Ok;
+  }
+
+  Error parseLiteral(ArduinoJsonShim::Slot& out, const char* word) {
+    for (const char* c = word; *c; c++, p++) {
+      if (atEnd()) return Error::IncompleteInput;
+      if (*p != *c) return Error::InvalidInput;
+    }
+    if (word[0] == 'n') {
+      out.type = ArduinoJsonShim::Type::Null;
+    } else {
+      out.type = ArduinoJsonShim::Type::Bool;
+      out.boolean = word[0] == 't';
+    }
+    return Error::Ok;
+  }
+
+  Error parseNumber(ArduinoJsonShim::Slot& out) {
+    char text[64];
+    size_t n = 0;
+    bool real = false;
+    while (!atEnd() && strchr("+-0123456789.eE", *p) != nullptr) {
+      if (n + 1 >= sizeof(text)) return Error::InvalidInput;
+      if (*p == '.' || *p == 'e' || *p == 'E') real = true;
+      text[n++] = *p++;
+    }
+    text[n] = '\0';
+    if (n == 0) return Error::InvalidInput;
+
+    char* parsedEnd;
+    if (!real) {
+      errno = 0;
+      long long value = strtoll(text, &parsedEnd, 10);
+      if (*parsedEnd == '\0' && errno == 0) {
+        out.type = ArduinoJsonShim::Type::Integer;
+        out.integer = value;
+        return Error::Ok;
+      }
+    }
+
+    double value = strtod(text, &parsedEnd);
+    if (*parsedEnd != '\0') return Error::InvalidInput;
+    out.type = ArduinoJsonShim::Type::Float;
+    out.real = value;
+    return Error::Ok;
+  }
+
+  JsonDocument& doc;
+  char* p;
+  char* end;
+};
+
+inline DeserializationError deserializeJson(JsonDocument& doc, char* input, size_t length) {
+  if (input == nullptr) return DeserializationError::EmptyInput;
+  return JsonParser(doc, input, length).parse();
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, char* input) {
+  return deserializeJson(doc, input, input ? strlen(input) : 0);
+}
+
+DeserializationError deserializeJson(JsonDocument& doc, const char* input, size_t length);
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const char* input) {
+  return deserializeJson(doc, input, input ? strlen(input) : 0);
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const String& input) {
+  return deserializeJson(doc, input.c_str(), input.length());
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <Arduino.h>
+
+#define DHT11 11
+#define DHT22 22
+
+// Readings come from simSetDhtReader(), or a slow drift around 27 C / 60 %
+class DHT {
+public:
+  DHT(uint8_t pin, uint8_t type, uint8_t count = 6) : pin(pin), type(type) {}
+  void begin(uint8_t pullTimeUs = 55) {}
+  float readTemperature(bool fahrenheit = false, bool force = false);
+  float readHumidity(bool force = false);
+
+private:
+  uint8_t pin;
+  uint8_t type;
+};
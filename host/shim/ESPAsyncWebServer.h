@@ -0,0 +1,374 @@
+// The ESPAsyncWebServer surface the firmware uses. Requests come either
+// from a plain socket server (the sim binaries, so a browser can open the
+// dashboard) or from simHttpRequest()/simWsConnect() in tests; both go
+// through the same handler matching and response filling as the library.
+#pragma once
+
+#include <Arduino.h>
+#include <FS.h>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class AsyncWebServer;
+class AsyncWebServerRequest;
+class AsyncWebServerResponse;
+class AsyncWebSocket;
+class AsyncWebSocketClient;
+struct SimWsPeer;
+
+typedef enum {
+  HTTP_GET = 0b00000001,
+  HTTP_POST = 0b00000010,
+  HTTP_DELETE = 0b00000100,
+  HTTP_PUT = 0b00001000,
+  HTTP_PATCH = 0b00010000,
+  HTTP_HEAD = 0b00100000,
+  HTTP_OPTIONS = 0b01000000,
+  HTTP_ANY = 0b01111111,
+} WebRequestMethod;
+
+typedef uint8_t WebRequestMethodComposite;
+
+#define RESPONSE_TRY_AGAIN 0xFFFFFFFF
+#define WS_MAX_QUEUED_MESSAGES 32
+
+typedef std::function<void(AsyncWebServerRequest* request)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest* request, const String& filename, size_t index, uint8_t* data,
+                           size_t len, bool final)>
+  ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total)>
+  ArBodyHandlerFunction;
+typedef std::function<size_t(uint8_t* buffer, size_t maxLen, size_t index)> AwsResponseFiller;
+typedef std::function<void()> ArDisconnectHandler;
+
+class AsyncWebParameter {
+public:
+  AsyncWebParameter(const String& name, const String& value) : _name(name), _value(value) {}
+  const String& name() const { return _name; }
+  const String& value() const { return _value; }
+  bool isPost() const { return false; }
+  bool isFile() const { return false; }
+
+private:
+  String _name;
+  String _value;
+};
+
+class AsyncWebHeader {
+public:
+  AsyncWebHeader(const String& name, const String& value) : _name(name), _value(value) {}
+  const String& name() const { return _name; }
+  const String& value() const { return _value; }
+
+private:
+  String _name;
+  String _value;
+};
+
+/* ===== Responses ==== */
+class AsyncWebServerResponse {
+public:
+  AsyncWebServerResponse(int code, const String& contentType) : _code(code), _contentType(contentType) {}
+  virtual ~AsyncWebServerResponse() {}
+
+  void setCode(int code) { _code = code; }
+  void setContentType(const String& type) { _contentType = type; }
+  void addHeader(const String& name, const String& value) { _headers.emplace_back(name, value); }
+
+  // Host side: what the response puts on the wire
+  int code() const { return _code; }
+  const String& contentType() const { return _contentType; }
+  const std::vector<std::pair<String, String>>& headers() const { return _headers; }
+  virtual bool chunked() const { return false; }
+  // Next piece of the body, 0 once it is complete, RESPONSE_TRY_AGAIN
+  // when the source has nothing yet
+  virtual size_t fill(uint8_t* buffer, size_t maxLen) = 0;
+
+protected:
+  int _code;
+  String _contentType;
+  std::vector<std::pair<String, String>> _headers;
+};
+
+class AsyncBasicResponse : public AsyncWebServerResponse {
+public:
+  AsyncBasicResponse(int code, const String& contentType, const String& content)
+    : AsyncWebServerResponse(code, contentType), _content(content) {}
+  size_t fill(uint8_t* buffer, size_t maxLen) override;
+
+private:
+  String _content;
+  size_t _sent = 0;
+};
+
+class AsyncProgmemResponse : public AsyncWebServerResponse {
+public:
+  AsyncProgmemResponse(int code, const String& contentType, const uint8_t* content, size_t len)
+    : AsyncWebServerResponse(code, contentType), _content(content), _length(len) {}
+  size_t fill(uint8_t* buffer, size_t maxLen) override;
+
+private:
+  const uint8_t* _content;
+  size_t _length;
+  size_t _sent = 0;
+};
+
+class AsyncFileResponse : public AsyncWebServerResponse {
+public:
+  AsyncFileResponse(FS& fs, const String& path, const String& contentType);
+  size_t fill(uint8_t* buffer, size_t maxLen) override;
+
+private:
+  File _file;
+};
+
+class AsyncChunkedResponse : public AsyncWebServerResponse {
+public:
+  AsyncChunkedResponse(const String& contentType, AwsResponseFiller filler)
+    : AsyncWebServerResponse(200, contentType), _filler(filler) {}
+  bool chunked() const override { return true; }
+  size_t fill(uint8_t* buffer, size_t maxLen) override;
+
+private:
+  AwsResponseFiller _filler;
+  size_t _index = 0;
+};
+
+class AsyncResponseStream : public AsyncWebServerResponse, public Print {
+public:
+  AsyncResponseStream(const String& contentType, size_t bufferSize) : AsyncWebServerResponse(200, contentType) {
+    _content.reserve(bufferSize);
+  }
+  using Print::write;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* data, size_t len) override;
+  size_t fill(uint8_t* buffer, size_t maxLen) override;
+
+private:
+  std::string _content;
+  size_t _sent = 0;
+};
+
+/* ===== Requests ==== */
+class AsyncWebServerRequest {
+public:
+  AsyncWebServerRequest(AsyncWebServer* server, WebRequestMethodComposite method, const String& url);
+  ~AsyncWebServerRequest();
+
+  void* _tempObject = nullptr;
+
+  AsyncWebServer* server() const { return _server; }
+  WebRequestMethodComposite method() const { return _method; }
+  const String& url() const { return _url; }
+  size_t contentLength() const { return _contentLength; }
+
+  size_t params() const { return _params.size(); }
+  bool hasParam(const String& name, bool post = false, bool file = false) const;
+  AsyncWebParameter* getParam(const String& name, bool post = false, bool file = false) const;
+  AsyncWebParameter* getParam(size_t index) const;
+
+  size_t headers() const { return _headers.size(); }
+  bool hasHeader(const String& name) const;
+  AsyncWebHeader* getHeader(const String& name) const;
+  const String& header(const char* name) const;
+
+  void onDisconnect(ArDisconnectHandler fn) { _onDisconnect = fn; }
+
+  AsyncWebServerResponse* beginResponse(int code, const String& contentType = String(),
+                                        const String& content = String());
+  AsyncWebServerResponse* beginResponse(FS& fs, const String& path, const String& contentType = String(),
+                                        bool download = false);
+  AsyncWebServerResponse* beginResponse_P(int code, const String& contentType, const uint8_t* content, size_t len);
+  AsyncWebServerResponse* beginChunkedResponse(const String& contentType, AwsResponseFiller filler);
+  AsyncResponseStream* beginResponseStream(const String& contentType, size_t bufferSize = 1460);
+
+  void send(AsyncWebServerResponse* response);
+  void send(int code, const String& contentType = String(), const String& content = String());
+
+  // Host side
+  void addParam(const String& name, const String& value) { _params.emplace_back(new AsyncWebParameter(name, value)); }
+  void addHeader(const String& name, const String& value) { _headers.emplace_back(new AsyncWebHeader(name, value)); }
+  void setContentLength(size_t length) { _contentLength = length; }
+  AsyncWebServerResponse* response() const { return _response; }
+
+private:
+  AsyncWebServer* _server;
+  WebRequestMethodComposite _method;
+  String _url;
+  size_t _contentLength = 0;
+  std::vector<std::unique_ptr<AsyncWebParameter>> _params;
+  std::vector<std::unique_ptr<AsyncWebHeader>> _headers;
+  ArDisconnectHandler _onDisconnect;
+  AsyncWebServerResponse* _response = nullptr;
+};
+
+/* ===== Handlers ==== */
+class AsyncWebHandler {
+public:
+  virtual ~AsyncWebHandler() {}
+  virtual bool canHandle(AsyncWebServerRequest* request) { return false; }
+  virtual void handleRequest(AsyncWebServerRequest* request) {}
+  virtual void handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {}
+  virtual bool isRequestHandlerTrivial() { return true; }
+};
+
+class AsyncCallbackWebHandler : public AsyncWebHandler {
+public:
+  void setUri(const String& uri) { _uri = uri; }
+  void setMethod(WebRequestMethodComposite method) { _method = method; }
+  void onRequest(ArRequestHandlerFunction fn) { _onRequest = fn; }
+  void onUpload(ArUploadHandlerFunction fn) { _onUpload = fn; }
+  void onBody(ArBodyHandlerFunction fn) { _onBody = fn; }
+
+  bool canHandle(AsyncWebServerRequest* request) override;
+  void handleRequest(AsyncWebServerRequest* request) override;
+  void handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) override;
+  bool isRequestHandlerTrivial() override { return !_onRequest; }
+
+private:
+  String _uri;
+  WebRequestMethodComposite _method = HTTP_ANY;
+  ArRequestHandlerFunction _onRequest;
+  ArUploadHandlerFunction _onUpload;
+  ArBodyHandlerFunction _onBody;
+};
+
+/* ===== WebSocket ==== */
+typedef enum { WS_EVT_CONNECT, WS_EVT_DISCONNECT, WS_EVT_PONG, WS_EVT_ERROR, WS_EVT_DATA } AwsEventType;
+typedef enum { WS_CONTINUATION, WS_TEXT, WS_BINARY, WS_DISCONNECT = 0x08, WS_PING, WS_PONG } AwsFrameType;
+typedef enum { WS_DISCONNECTED, WS_CONNECTED, WS_DISCONNECTING } AwsClientStatus;
+
+typedef struct {
+  uint8_t message_opcode;
+  uint32_t num;
+  uint8_t final;
+  uint8_t masked;
+  uint8_t opcode;
+  uint64_t len;
+  uint8_t mask[4];
+  uint64_t index;
+} AwsFrameInfo;
+
+typedef std::function<void(AsyncWebSocket* server, AsyncWebSocketClient* client, AwsEventType type, void* arg,
+                           uint8_t* data, size_t len)>
+  AwsEventHandler;
+
+class AsyncWebSocketMessageBuffer {
+public:
+  explicit AsyncWebSocketMessageBuffer(size_t size) : _data(size) {}
+  AsyncWebSocketMessageBuffer(const uint8_t* data, size_t size) : _data(data, data + size) {}
+  uint8_t* get() { return _data.data(); }
+  size_t length() const { return _data.size(); }
+
+private:
+  friend class AsyncWebSocketClient;
+  std::vector<uint8_t> _data;
+};
+
+class AsyncWebSocketClient {
+public:
+  uint32_t id() const { return _id; }
+  AwsClientStatus status() const { return _status; }
+  AsyncWebSocket* server() const { return _server; }
+
+  bool canSend();
+  size_t queueLen();
+  void binary(const uint8_t* data, size_t len);
+  void binary(const char* data, size_t len) { binary((const uint8_t*)data, len); }
+  void binary(AsyncWebSocketMessageBuffer* buffer);
+  void text(const char* data, size_t len);
+  void text(const String& message) { text(message.c_str(), message.length()); }
+  void close(uint16_t code = 0, const char* message = nullptr);
+  void ping(const uint8_t* data = nullptr, size_t len = 0) {}
+
+  // Host side: where sent frames go. Returns false when the peer is gone.
+  typedef std::function<bool(AwsFrameType opcode, const uint8_t* data, size_t len)> Sink;
+
+private:
+  friend class AsyncWebSocket;
+  friend size_t simWsDrain(SimWsPeer* peer, size_t frames);
+
+  AsyncWebSocketClient(AsyncWebSocket* server, uint32_t id, Sink sink, bool autoDrain)
+    : _server(server), _id(id), _sink(sink), _autoDrain(autoDrain) {}
+  void queue(AwsFrameType opcode, std::vector<uint8_t> data);
+  size_t drain(size_t frames);
+
+  AsyncWebSocket* _server;
+  uint32_t _id;
+  std::atomic<AwsClientStatus> _status{ WS_CONNECTED };
+  Sink _sink;
+  bool _autoDrain;
+  std::mutex _lock;     // guards _queue
+  std::mutex _sending;  // keeps frames in order on the sink
+  std::deque<std::pair<AwsFrameType, std::vector<uint8_t>>> _queue;
+};
+
+class AsyncWebSocket : public AsyncWebHandler {
+public:
+  explicit AsyncWebSocket(const String& url) : _url(url) {}
+
+  const char* url() const { return _url.c_str(); }
+  void onEvent(AwsEventHandler handler) { _handler = handler; }
+  size_t count();
+  AsyncWebSocketClient* client(uint32_t id);
+  void cleanupClients(uint16_t maxClients = 8);
+  void closeAll(uint16_t code = 0, const char* message = nullptr);
+  AsyncWebSocketMessageBuffer* makeBuffer(size_t size = 0) { return new AsyncWebSocketMessageBuffer(size); }
+  AsyncWebSocketMessageBuffer* makeBuffer(const uint8_t* data, size_t size) {
+    return new AsyncWebSocketMessageBuffer(data, size);
+  }
+
+  bool canHandle(AsyncWebServerRequest* request) override;
+  void handleRequest(AsyncWebServerRequest* request) override {}
+
+  // Host side: a client is never freed, the firmware may still hold its
+  // pointer when it goes away
+  AsyncWebSocketClient* accept(AsyncWebSocketClient::Sink sink, bool autoDrain);
+  void receive(AsyncWebSocketClient* client, AwsFrameType opcode, uint8_t* data, size_t len);
+  void disconnected(AsyncWebSocketClient* client);
+
+private:
+  String _url;
+  AwsEventHandler _handler;
+  std::mutex _lock;
+  std::vector<AsyncWebSocketClient*> _clients;
+  uint32_t _nextId = 1;
+};
+
+/* ===== Server ==== */
+class AsyncWebServer {
+public:
+  explicit AsyncWebServer(uint16_t port);
+  ~AsyncWebServer();
+
+  void begin();
+  void end();
+  uint16_t port() const { return _port; }
+
+  AsyncWebHandler& addHandler(AsyncWebHandler* handler);
+  AsyncCallbackWebHandler& on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest);
+  AsyncCallbackWebHandler& on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+                              ArUploadHandlerFunction onUpload);
+  AsyncCallbackWebHandler& on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+                              ArUploadHandlerFunction onUpload, ArBodyHandlerFunction onBody);
+  void onNotFound(ArRequestHandlerFunction fn) { _notFound = fn; }
+
+  // Host side
+  AsyncWebHandler* findHandler(AsyncWebServerRequest* request);
+  void notFound(AsyncWebServerRequest* request);
+
+private:
+  uint16_t _port;
+  std::vector<AsyncWebHandler*> _handlers;
+  std::vector<std::unique_ptr<AsyncCallbackWebHandler>> _owned;
+  ArRequestHandlerFunction _notFound;
+  std::atomic<int> _listener{ -1 };
+};
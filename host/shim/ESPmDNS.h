@@ -0,0 +1,12 @@
+#pragma once
+
+#include <Arduino.h>
+
+class MDNSResponder {
+public:
+  bool begin(const char* hostName) { return hostName != nullptr && hostName[0] != '\0'; }
+  void end() {}
+  bool addService(const char* service, const char* proto, uint16_t port) { return true; }
+};
+
+extern MDNSResponder MDNS;
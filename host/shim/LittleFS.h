@@ -0,0 +1,16 @@
+#pragma once
+
+#include "FS.h"
+
+// Mounted on simFsRoot(): SIM_FS_DIR, or ./littlefs
+class LittleFSFS : public fs::FS {
+public:
+  bool begin(bool formatOnFail = false, const char* basePath = "/littlefs", uint8_t maxOpenFiles = 10,
+             const char* partitionLabel = "spiffs");
+  void end() {}
+  bool format();
+  size_t totalBytes();
+  size_t usedBytes();
+};
+
+extern LittleFSFS LittleFS;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Arduino.h>
+#include <string>
+
+// NVS in memory, shared by every Preferences object and lost at exit
+class Preferences {
+public:
+  bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr);
+  void end();
+  bool clear();
+  bool remove(const char* key);
+  bool isKey(const char* key);
+
+  size_t putUChar(const char* key, uint8_t value) { return putBytes(key, &value, sizeof(value)); }
+  size_t putInt(const char* key, int32_t value) { return putBytes(key, &value, sizeof(value)); }
+  size_t putUInt(const char* key, uint32_t value) { return putBytes(key, &value, sizeof(value)); }
+  size_t putBool(const char* key, bool value) { return putUChar(key, value ? 1 : 0); }
+  size_t putBytes(const char* key, const void* value, size_t len);
+
+  uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return get(key, defaultValue); }
+  int32_t getInt(const char* key, int32_t defaultValue = 0) { return get(key, defaultValue); }
+  uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return get(key, defaultValue); }
+  bool getBool(const char* key, bool defaultValue = false) { return getUChar(key, defaultValue ? 1 : 0) != 0; }
+  size_t getBytes(const char* key, void* buffer, size_t maxLen);
+  size_t getBytesLength(const char* key);
+
+private:
+  template <typename T>
+  T get(const char* key, T defaultValue) {
+    T value;
+    return getBytesLength(key) == sizeof(T) && getBytes(key, &value, sizeof(T)) == sizeof(T) ? value : defaultValue;
+  }
+
+  std::string space;
+  bool readOnly = false;
+  bool started = false;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Arduino.h>
+#include "esp_wifi.h"
+
+typedef enum {
+  WIFI_MODE_NULL,
+  WIFI_MODE_STA,
+  WIFI_MODE_AP,
+  WIFI_MODE_APSTA,
+} wifi_mode_t;
+
+#define WIFI_OFF WIFI_MODE_NULL
+#define WIFI_STA WIFI_MODE_STA
+#define WIFI_AP WIFI_MODE_AP
+#define WIFI_AP_STA WIFI_MODE_APSTA
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_CONNECTED = 3,
+  WL_DISCONNECTED = 6,
+} wl_status_t;
+
+class WiFiClass {
+public:
+  bool mode(wifi_mode_t mode);
+  wifi_mode_t getMode();
+  bool disconnect(bool wifiOff = false, bool eraseAp = false);
+  wl_status_t status();
+  int32_t channel();
+  bool setChannel(uint8_t primary, wifi_second_chan_t secondary = WIFI_SECOND_CHAN_NONE);
+  String macAddress();
+};
+
+extern WiFiClass WiFi;
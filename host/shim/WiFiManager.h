@@ -0,0 +1,10 @@
+#pragma once
+
+#include <WiFi.h>
+
+// Joins the simulated access point at once, on SIM_AP_CHANNEL (default 6)
+class WiFiManager {
+public:
+  bool autoConnect(const char* apName = nullptr, const char* apPassword = nullptr);
+  void resetSettings() {}
+};
@@ -0,0 +1,405 @@
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <rom/crc.h>
+#include <malloc.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "sim.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+static std::mutex serialMutex;
+static std::function<uint16_t(uint8_t)> analogReader;
+
+#define SIM_CPU_MHZ 240
+#define SIM_HEAP_SIZE (320 * 1024)
+
+unsigned long millis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros() {
+  return esp_timer_get_time();
+}
+
+int64_t esp_timer_get_time() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield() {
+  std::this_thread::yield();
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+void analogSetAttenuation(int attenuation) {}
+void analogReadResolution(uint8_t bits) {}
+
+void simSetAnalogReader(std::function<uint16_t(uint8_t pin)> reader) {
+  analogReader = reader;
+}
+
+// Without a reader the MQ-2 sits in clean air: about a third of full scale
+// with a little noise, which calibrates to the low end of the curve
+uint16_t analogRead(uint8_t pin) {
+  if (analogReader) return analogReader(pin);
+  return 1400 + esp_random() % 16;
+}
+
+uint32_t getCpuFrequencyMhz() {
+  return SIM_CPU_MHZ;
+}
+
+uint32_t esp_random() {
+  static std::mutex lock;
+  static std::mt19937 generator(std::random_device{}());
+  std::lock_guard<std::mutex> guard(lock);
+  return generator();
+}
+
+#if !defined(__GLIBC__) || !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dst, const char* src, size_t size) {
+  size_t length = strlen(src);
+  if (size > 0) {
+    size_t n = length < size - 1 ? length : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return length;
+}
+#endif
+
+// Same polynomial and conditioning as the ROM function (and zlib's crc32)
+uint32_t crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+  static uint32_t table[256];
+  static std::once_flag built;
+  std::call_once(built, [] {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) c = c & 1 ? 0xedb88320 ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
+  });
+
+  crc = ~crc;
+  for (uint32_t i = 0; i < len; i++) crc = table[(crc ^ buf[i]) & 0xff] ^ (crc >> 8);
+  return ~crc;
+}
+
+/* ===== ESP ==== */
+static std::atomic<uint32_t> heapFreeMin(SIM_HEAP_SIZE);
+
+// mallinfo2() only sees the main arena: keep every thread's allocations
+// there, and count from what the host runtime had before the sketch
+static size_t heapAtBoot() {
+  mallopt(M_ARENA_MAX, 1);
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+static const size_t heapBaseline = heapAtBoot();
+
+static uint32_t heapUsed() {
+  struct mallinfo2 info = mallinfo2();
+  size_t used = info.uordblks + info.hblkhd;
+  return used > heapBaseline ? used - heapBaseline : 0;
+}
+
+uint32_t EspClass::getCycleCount() {
+  return (uint32_t)(esp_timer_get_time() * SIM_CPU_MHZ);
+}
+
+uint32_t EspClass::getFreeHeap() {
+  uint32_t used = heapUsed();
+  uint32_t free = used < SIM_HEAP_SIZE ? SIM_HEAP_SIZE - used : 0;
+  uint32_t low = heapFreeMin.load();
+  while (free < low && !heapFreeMin.compare_exchange_weak(low, free)) {}
+  return free;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+  getFreeHeap();
+  return heapFreeMin.load();
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+  return getFreeHeap();
+}
+
+uint32_t EspClass::getHeapSize() {
+  return SIM_HEAP_SIZE;
+}
+
+void EspClass::restart() {
+  exit(0);
+}
+
+/* ===== Print ==== */
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    if (!write(*buffer++)) break;
+    n++;
+  }
+  return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+  char stackBuffer[64];
+  char* buffer = stackBuffer;
+
+  va_list args;
+  va_start(args, format);
+  va_list copy;
+  va_copy(copy, args);
+  int length = vsnprintf(buffer, sizeof(stackBuffer), format, copy);
+  va_end(copy);
+  if (length < 0) {
+    va_end(args);
+    return 0;
+  }
+
+  if ((size_t)length >= sizeof(stackBuffer)) {
+    buffer = (char*)malloc(length + 1);
+    if (buffer == NULL) {
+      va_end(args);
+      return 0;
+    }
+    vsnprintf(buffer, length + 1, format, args);
+  }
+  va_end(args);
+
+  size_t n = write((const uint8_t*)buffer, length);
+  if (buffer != stackBuffer) free(buffer);
+  return n;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  std::lock_guard<std::mutex> guard(serialMutex);
+  // Line at a time, like a UART monitor, even when stdout is a file
+  size_t n = fwrite(buffer, 1, size, stdout);
+  if (memchr(buffer, '\n', size) != nullptr) fflush(stdout);
+  return n;
+}
+
+void HardwareSerial::flush() {
+  std::lock_guard<std::mutex> guard(serialMutex);
+  fflush(stdout);
+}
+
+/* ===== String ==== */
+static std::atomic<uint64_t> stringBytesCopied(0);
+
+uint64_t simStringBytesCopied() {
+  return stringBytesCopied.load(std::memory_order_relaxed);
+}
+
+// Grows to exactly the length asked for, like the core does, so repeated
+// concatenation reallocates on every append
+String::String(const char* cstr) {
+  if (cstr) concat(cstr);
+}
+
+String::String(const String& other) {
+  concat(other);
+}
+
+String::String(String&& other) noexcept : buffer(other.buffer), capacity(other.capacity), len(other.len) {
+  other.buffer = nullptr;
+  other.capacity = 0;
+  other.len = 0;
+}
+
+String::String(char c) {
+  concat(c);
+}
+
+static void formatInteger(char* out, size_t size, long long value, unsigned char base, bool isSigned) {
+  if (base == 10) {
+    snprintf(out, size, isSigned ? "%lld" : "%llu", value);
+  } else if (base == 16) {
+    snprintf(out, size, "%llx", (unsigned long long)value);
+  } else {
+    char digits[66];
+    size_t i = sizeof(digits) - 1;
+    unsigned long long v = (unsigned long long)value;
+    digits[i] = '\0';
+    do {
+      digits[--i] = "0123456789abcdefghijklmnopqrstuvwxyz"[v % base];
+      v /= base;
+    } while (v > 0);
+    strlcpy(out, digits + i, size);
+  }
+}
+
+String::String(int value, unsigned char base) {
+  char text[66];
+  formatInteger(text, sizeof(text), value, base, true);
+  concat(text);
+}
+
+String::String(unsigned int value, unsigned char base) {
+  char text[66];
+  formatInteger(text, sizeof(text), value, base, false);
+  concat(text);
+}
+
+String::String(long value, unsigned char base) {
+  char text[66];
+  formatInteger(text, sizeof(text), value, base, true);
+  concat(text);
+}
+
+String::String(unsigned long value, unsigned char base) {
+  char text[66];
+  formatInteger(text, sizeof(text), value, base, false);
+  concat(text);
+}
+
+String::String(float value, unsigned int decimals) : String((double)value, decimals) {}
+
+String::String(double value, unsigned int decimals) {
+  char text[64];
+  snprintf(text, sizeof(text), "%.*f", (int)decimals, value);
+  concat(text);
+}
+
+String::~String() {
+  free(buffer);
+}
+
+String& String::operator=(const String& other) {
+  if (this == &other) return *this;
+  len = 0;
+  if (buffer) buffer[0] = '\0';
+  concat(other);
+  return *this;
+}
+
+String& String::operator=(String&& other) noexcept {
+  if (this == &other) return *this;
+  free(buffer);
+  buffer = other.buffer;
+  capacity = other.capacity;
+  len = other.len;
+  other.buffer = nullptr;
+  other.capacity = 0;
+  other.len = 0;
+  return *this;
+}
+
+String& String::operator=(const char* cstr) {
+  len = 0;
+  if (buffer) buffer[0] = '\0';
+  if (cstr) concat(cstr);
+  return *this;
+}
+
+bool String::reserve(unsigned int size) {
+  if (buffer && capacity >= size) return true;
+
+  char* grown = (char*)realloc(buffer, size + 1);
+  if (grown == nullptr) return false;
+  if (buffer == nullptr) grown[0] = '\0';
+  buffer = grown;
+  capacity = size;
+  return true;
+}
+
+bool String::concat(const char* cstr, unsigned int length) {
+  if (cstr == nullptr) return false;
+  if (length == 0) return reserve(len);
+
+  // Appending part of ourselves: the buffer may move
+  bool self = buffer && cstr >= buffer && cstr < buffer + capacity + 1;
+  size_t selfOffset = self ? cstr - buffer : 0;
+  if (!reserve(len + length)) return false;
+  if (self) cstr = buffer + selfOffset;
+
+  memmove(buffer + len, cstr, length);
+  stringBytesCopied.fetch_add(length, std::memory_order_relaxed);
+  len += length;
+  buffer[len] = '\0';
+  return true;
+}
+
+bool String::concat(int value) {
+  return concat(String(value));
+}
+
+bool String::concat(unsigned int value) {
+  return concat(String(value));
+}
+
+bool String::concat(long value) {
+  return concat(String(value));
+}
+
+bool String::concat(unsigned long value) {
+  return concat(String(value));
+}
+
+bool String::equals(const char* cstr) const {
+  return strcmp(c_str(), cstr ? cstr : "") == 0;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+  if (from >= len) return -1;
+  const char* found = strchr(buffer + from, c);
+  return found ? found - buffer : -1;
+}
+
+int String::indexOf(const char* cstr, unsigned int from) const {
+  if (from >= len) return -1;
+  const char* found = strstr(buffer + from, cstr);
+  return found ? found - buffer : -1;
+}
+
+bool String::startsWith(const char* prefix) const {
+  size_t n = strlen(prefix);
+  return n <= len && strncmp(c_str(), prefix, n) == 0;
+}
+
+bool String::endsWith(const char* suffix) const {
+  size_t n = strlen(suffix);
+  return n <= len && strcmp(c_str() + len - n, suffix) == 0;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+  if (from > to) std::swap(from, to);
+  if (from >= len) return String();
+  if (to > len) to = len;
+
+  String out;
+  out.concat(buffer + from, to - from);
+  return out;
+}
+
+String operator+(const String& lhs, const String& rhs) {
+  String out(lhs);
+  out.concat(rhs);
+  return out;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+  String out(lhs);
+  out.concat(rhs);
+  return out;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+  String out(lhs);
+  out.concat(rhs);
+  return out;
+}
@@ -0,0 +1,55 @@
+// ESP-NOW over UDP on localhost. Every simulated board binds one port of
+// a small range and sends each frame to all of them; a receiver keeps
+// what matches its channel and its MAC (or broadcast), and answers
+// unicast frames with the link-layer ACK that drives the send callback.
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_shim.h"
+#include "esp_wifi.h"
+
+#define ESP_NOW_ETH_ALEN 6
+#define ESP_NOW_KEY_LEN 16
+#define ESP_NOW_MAX_DATA_LEN 250
+
+#define ESP_ERR_ESPNOW_BASE 0x3064
+#define ESP_ERR_ESPNOW_NOT_INIT (ESP_ERR_ESPNOW_BASE + 1)
+#define ESP_ERR_ESPNOW_ARG (ESP_ERR_ESPNOW_BASE + 2)
+#define ESP_ERR_ESPNOW_NO_MEM (ESP_ERR_ESPNOW_BASE + 3)
+#define ESP_ERR_ESPNOW_FULL (ESP_ERR_ESPNOW_BASE + 4)
+#define ESP_ERR_ESPNOW_NOT_FOUND (ESP_ERR_ESPNOW_BASE + 5)
+#define ESP_ERR_ESPNOW_INTERNAL (ESP_ERR_ESPNOW_BASE + 6)
+#define ESP_ERR_ESPNOW_EXIST (ESP_ERR_ESPNOW_BASE + 7)
+
+typedef enum {
+  ESP_NOW_SEND_SUCCESS = 0,
+  ESP_NOW_SEND_FAIL,
+} esp_now_send_status_t;
+
+typedef struct esp_now_peer_info {
+  uint8_t peer_addr[ESP_NOW_ETH_ALEN];
+  uint8_t lmk[ESP_NOW_KEY_LEN];
+  uint8_t channel;
+  wifi_interface_t ifidx;
+  bool encrypt;
+  void* priv;
+} esp_now_peer_info_t;
+
+typedef struct esp_now_recv_info {
+  uint8_t* src_addr;
+  uint8_t* des_addr;
+  wifi_pkt_rx_ctrl_t* rx_ctrl;
+} esp_now_recv_info_t;
+
+typedef void (*esp_now_recv_cb_t)(const esp_now_recv_info_t* info, const uint8_t* data, int len);
+typedef void (*esp_now_send_cb_t)(const uint8_t* mac, esp_now_send_status_t status);
+
+esp_err_t esp_now_init();
+esp_err_t esp_now_deinit();
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t callback);
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t callback);
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer);
+esp_err_t esp_now_del_peer(const uint8_t* peerAddr);
+bool esp_now_is_peer_exist(const uint8_t* peerAddr);
+esp_err_t esp_now_send(const uint8_t* peerAddr, const uint8_t* data, size_t len);
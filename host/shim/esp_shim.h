@@ -0,0 +1,26 @@
+// esp_err_t and the ESP object. Heap figures come from the host allocator,
+// cycle counts from the monotonic clock scaled to a 240 MHz core.
+#pragma once
+
+#include <stdint.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NO_MEM 0x101
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_ERR_INVALID_STATE 0x103
+#define ESP_ERR_NOT_FOUND 0x105
+
+class EspClass {
+public:
+  uint32_t getCycleCount();
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  uint32_t getHeapSize();
+  void restart();
+};
+
+extern EspClass ESP;
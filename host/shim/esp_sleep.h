@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_shim.h"
+
+typedef enum {
+  ESP_SLEEP_WAKEUP_UNDEFINED,
+  ESP_SLEEP_WAKEUP_ALL,
+  ESP_SLEEP_WAKEUP_EXT0,
+  ESP_SLEEP_WAKEUP_EXT1,
+  ESP_SLEEP_WAKEUP_TIMER,
+} esp_sleep_wakeup_cause_t;
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs);
+// Sleeps, then restarts the process. RTC_DATA_ATTR variables do not
+// survive: the host has no memory that outlives a reset.
+[[noreturn]] void esp_deep_sleep_start();
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause();
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/time.h>
+
+typedef enum {
+  SNTP_SYNC_MODE_IMMED,
+  SNTP_SYNC_MODE_SMOOTH,
+} sntp_sync_mode_t;
+
+typedef enum {
+  SNTP_SYNC_STATUS_RESET,
+  SNTP_SYNC_STATUS_COMPLETED,
+  SNTP_SYNC_STATUS_IN_PROGRESS,
+} sntp_sync_status_t;
+
+typedef void (*sntp_sync_time_cb_t)(struct timeval* tv);
+
+void sntp_set_sync_mode(sntp_sync_mode_t mode);
+sntp_sync_mode_t sntp_get_sync_mode();
+void sntp_set_sync_interval(uint32_t intervalMs);
+uint32_t sntp_get_sync_interval();
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback);
+// COMPLETED reads back once, then RESET, as in ESP-IDF
+sntp_sync_status_t sntp_get_sync_status();
+void sntp_set_sync_status(sntp_sync_status_t status);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_shim.h"
+
+typedef enum {
+  WIFI_IF_STA,
+  WIFI_IF_AP,
+} wifi_interface_t;
+
+typedef enum {
+  WIFI_SECOND_CHAN_NONE,
+  WIFI_SECOND_CHAN_ABOVE,
+  WIFI_SECOND_CHAN_BELOW,
+} wifi_second_chan_t;
+
+typedef struct {
+  signed rssi : 8;
+  unsigned rate : 5;
+  unsigned : 1;
+  unsigned sig_mode : 2;
+  unsigned : 16;
+  unsigned channel : 4;
+} wifi_pkt_rx_ctrl_t;
+
+esp_err_t esp_wifi_get_mac(wifi_interface_t ifx, uint8_t mac[6]);
+esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second);
+esp_err_t esp_wifi_get_channel(uint8_t* primary, wifi_second_chan_t* second);
+esp_err_t esp_wifi_set_promiscuous(bool enable);
@@ -0,0 +1,196 @@
+#include <Arduino.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "sim.h"
+
+struct SimTask {
+  std::string name;
+  UBaseType_t priority;
+  BaseType_t core;
+  uint32_t stackDepth;
+  std::mutex lock;
+  std::condition_variable notified;
+  uint32_t notifications = 0;
+};
+
+struct SimQueue {
+  std::mutex lock;
+  std::condition_variable changed;
+  std::deque<std::vector<uint8_t>> items;
+  size_t length;
+  size_t itemSize;
+};
+
+// Thrown by vTaskDelete(NULL) to unwind the task's thread
+struct SimTaskDeleted {};
+
+// Tasks are never freed: a handle stays valid for anyone still holding it
+static thread_local SimTask* currentTask = nullptr;
+
+static SimTask* taskForThisThread() {
+  if (currentTask == nullptr) {
+    currentTask = new SimTask();
+    currentTask->name = "host";
+    currentTask->priority = 1;
+    currentTask->core = tskNO_AFFINITY;
+    currentTask->stackDepth = 0;
+  }
+  return currentTask;
+}
+
+template <typename Lock, typename Predicate>
+static bool waitTicks(std::condition_variable& cv, Lock& lock, TickType_t ticks, Predicate ready) {
+  if (ticks == portMAX_DELAY) {
+    cv.wait(lock, ready);
+    return true;
+  }
+  return cv.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth, void* parameters,
+                                   UBaseType_t priority, TaskHandle_t* created, BaseType_t core) {
+  SimTask* task = new SimTask();
+  task->name = name;
+  task->priority = priority;
+  task->core = core;
+  task->stackDepth = stackDepth;
+
+  // The handle is out before the task runs, as on the chip when the new
+  // task has a lower priority than its creator
+  if (created) *created = task;
+
+  std::thread([task, code, parameters] {
+    currentTask = task;
+    try {
+      code(parameters);
+    } catch (const SimTaskDeleted&) {
+    }
+  }).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth, void* parameters,
+                       UBaseType_t priority, TaskHandle_t* created) {
+  return xTaskCreatePinnedToCore(code, name, stackDepth, parameters, priority, created, tskNO_AFFINITY);
+}
+
+// Only a task deleting itself is supported, which is all the sketches do
+void vTaskDelete(TaskHandle_t task) {
+  if (task == nullptr || task == currentTask) throw SimTaskDeleted();
+}
+
+void vTaskDelay(TickType_t ticks) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment) {
+  TickType_t target = *previousWake + increment;
+  int32_t remaining = (int32_t)(target - xTaskGetTickCount());
+  if (remaining > 0) vTaskDelay(remaining);
+  *previousWake = target;
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)millis();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  return taskForThisThread();
+}
+
+// Stack use is not measured on the host, report the whole stack as free
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  if (task == nullptr) task = taskForThisThread();
+  return task->stackDepth;
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+  if (task == nullptr) task = taskForThisThread();
+  return task->priority;
+}
+
+BaseType_t xPortGetCoreID() {
+  BaseType_t core = taskForThisThread()->core;
+  return core == tskNO_AFFINITY ? 0 : core;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  if (task == nullptr) return pdFAIL;
+
+  std::lock_guard<std::mutex> guard(task->lock);
+  task->notifications++;
+  task->notified.notify_one();
+  return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+  SimTask* task = taskForThisThread();
+
+  std::unique_lock<std::mutex> guard(task->lock);
+  if (!waitTicks(task->notified, guard, ticksToWait, [task] { return task->notifications > 0; })) return 0;
+
+  uint32_t value = task->notifications;
+  task->notifications = clearOnExit ? 0 : value - 1;
+  return value;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  SimQueue* queue = new SimQueue();
+  queue->length = length;
+  queue->itemSize = itemSize;
+  return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+  delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+  std::unique_lock<std::mutex> guard(queue->lock);
+  if (!waitTicks(queue->changed, guard, ticksToWait, [queue] { return queue->items.size() < queue->length; })) {
+    return pdFALSE;
+  }
+
+  const uint8_t* bytes = (const uint8_t*)item;
+  queue->items.emplace_back(bytes, bytes + queue->itemSize);
+  queue->changed.notify_all();
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticksToWait) {
+  std::unique_lock<std::mutex> guard(queue->lock);
+  if (!waitTicks(queue->changed, guard, ticksToWait, [queue] { return !queue->items.empty(); })) return pdFALSE;
+
+  memcpy(item, queue->items.front().data(), queue->itemSize);
+  queue->items.pop_front();
+  queue->changed.notify_all();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> guard(queue->lock);
+  return queue->items.size();
+}
+
+void simRunSketch(void (*setup)(), void (*loop)(), bool joinLoopTask) {
+  SimTask* task = taskForThisThread();
+  task->name = "loopTask";
+  task->core = 1;
+  task->stackDepth = 8192;
+
+  try {
+    setup();
+    while (1) loop();
+  } catch (const SimTaskDeleted&) {
+  }
+
+  // The other tasks carry on, as they do on the chip
+  while (joinLoopTask) pause();
+}
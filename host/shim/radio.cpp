@@ -0,0 +1,438 @@
+#include <WiFi.h>
+#include <WiFiManager.h>
+#include <ESPmDNS.h>
+#include <DHT.h>
+#include <esp_now.h>
+#include <esp_sleep.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sim.h"
+
+#define SIM_FALLBACK_MAC "24:0a:c4:00:00:01"  // when SIM_MAC is not set
+
+#define SIM_BUS_PORT 47800  // first port of the bus, SIM_BUS_PORT overrides
+#define SIM_BUS_PORTS 8     // boards that can share it
+#define SIM_ACK_TIMEOUT_MS 30
+#define SIM_FRAME_ACK 1
+#define SIM_FRAME_DATA 0
+
+WiFiClass WiFi;
+MDNSResponder MDNS;
+
+typedef struct __attribute__((packed)) BusFrame {
+  char magic[2];  // "EN"
+  uint8_t kind;   // SIM_FRAME_DATA / SIM_FRAME_ACK
+  uint8_t channel;
+  uint8_t src[6];
+  uint8_t dst[6];
+  uint32_t id;
+  uint8_t payload[ESP_NOW_MAX_DATA_LEN];
+} BusFrame;
+
+#define BUS_HEADER_LEN offsetof(BusFrame, payload)
+
+typedef struct PendingSend {
+  uint32_t id;
+  uint8_t dst[6];
+  bool broadcast;
+  std::chrono::steady_clock::time_point deadline;
+} PendingSend;
+
+static const uint8_t broadcastMac[6] = { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff };
+
+static std::mutex radioMutex;
+static uint8_t radioMac[6];
+static bool radioMacSet = false;
+static std::atomic<uint8_t> radioChannel(0);
+static uint8_t apChannel = 0;
+static wifi_mode_t wifiMode = WIFI_MODE_NULL;
+
+static int busSocket = -1;
+static uint16_t busBase = 0;
+static uint16_t busPort = 0;
+static std::atomic<uint32_t> busNextId(1);
+static std::vector<std::array<uint8_t, 6>> peers;
+static std::vector<PendingSend> pending;
+static std::atomic<esp_now_recv_cb_t> recvCallback(nullptr);
+static std::atomic<esp_now_send_cb_t> sendCallback(nullptr);
+
+static uint64_t sleepWakeupUs = 0;
+static bool busTrace = false;  // SIM_RADIO_TRACE=1 logs every frame to stderr
+
+static int envInt(const char* name, int fallback) {
+  const char* value = getenv(name);
+  return value && *value ? atoi(value) : fallback;
+}
+
+static bool parseMac(const char* text, uint8_t mac[6]) {
+  unsigned int b[6];
+  if (text == nullptr || sscanf(text, "%x:%x:%x:%x:%x:%x", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]) != 6) return false;
+  for (int i = 0; i < 6; i++) mac[i] = b[i];
+  return true;
+}
+
+// Caller holds radioMutex
+static void radioInit() {
+  if (!radioMacSet) {
+    if (!parseMac(getenv("SIM_MAC"), radioMac)) parseMac(SIM_FALLBACK_MAC, radioMac);
+    radioMacSet = true;
+  }
+  if (radioChannel == 0) radioChannel = constrain(envInt("SIM_CHANNEL", 1), 1, 14);
+  if (apChannel == 0) apChannel = constrain(envInt("SIM_AP_CHANNEL", 6), 1, 14);
+}
+
+void simSetMac(const uint8_t mac[6]) {
+  std::lock_guard<std::mutex> guard(radioMutex);
+  memcpy(radioMac, mac, 6);
+  radioMacSet = true;
+}
+
+void simSetApChannel(uint8_t channel) {
+  std::lock_guard<std::mutex> guard(radioMutex);
+  apChannel = channel;
+}
+
+uint8_t simRadioChannel() {
+  std::lock_guard<std::mutex> guard(radioMutex);
+  radioInit();
+  return radioChannel;
+}
+
+/* ===== WiFi ==== */
+bool WiFiClass::mode(wifi_mode_t mode) {
+  std::lock_guard<std::mutex> guard(radioMutex);
+  radioInit();
+  wifiMode = mode;
+  return true;
+}
+
+wifi_mode_t WiFiClass::getMode() {
+  std::lock_guard<std::mutex> guard(radioMutex);
+  return wifiMode;
+}
+
+bool WiFiClass::disconnect(bool wifiOff, bool eraseAp) {
+  return true;
+}
+
+wl_status_t WiFiClass::status() {
+  return WL_CONNECTED;
+}
+
+int32_t WiFiClass::channel() {
+  return simRadioChannel();
+}
+
+bool WiFiClass::setChannel(uint8_t primary, wifi_second_chan_t secondary) {
+  return esp_wifi_set_channel(primary, secondary) == ESP_OK;
+}
+
+String WiFiClass::macAddress() {
+  uint8_t mac[6];
+  esp_wifi_get_mac(WIFI_IF_STA, mac);
+
+  char text[18];
+  snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  return String(text);
+}
+
+bool WiFiManager::autoConnect(const char* apName, const char* apPassword) {
+  std::lock_guard<std::mutex> guard(radioMutex);
+  radioInit();
+  radioChannel = apChannel;
+  return true;
+}
+
+esp_err_t esp_wifi_get_mac(wifi_interface_t ifx, uint8_t mac[6]) {
+  std::lock_guard<std::mutex> guard(radioMutex);
+  radioInit();
+  memcpy(mac, radioMac, 6);
+  return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second) {
+  if (primary < 1 || primary > 14) return ESP_ERR_INVALID_ARG;
+  std::lock_guard<std::mutex> guard(radioMutex);
+  radioInit();
+  radioChannel = primary;
+  return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_channel(uint8_t* primary, wifi_second_chan_t* second) {
+  *primary = simRadioChannel();
+  if (second) *second = WIFI_SECOND_CHAN_NONE;
+  return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_promiscuous(bool enable) {
+  return ESP_OK;
+}
+
+/* ===== ESP-NOW ==== */
+static void busSend(const BusFrame& frame, size_t len, const sockaddr_in* only) {
+  if (only) {
+    sendto(busSocket, &frame, len, 0, (const sockaddr*)only, sizeof(*only));
+    return;
+  }
+
+  sockaddr_in to;
+  memset(&to, 0, sizeof(to));
+  to.sin_family = AF_INET;
+  to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  for (uint16_t port = busBase; port < busBase + SIM_BUS_PORTS; port++) {
+    if (port == busPort) continue;
+    to.sin_port = htons(port);
+    sendto(busSocket, &frame, len, 0, (const sockaddr*)&to, sizeof(to));
+  }
+}
+
+static void busReceive() {
+  BusFrame frame;
+  sockaddr_in from;
+  socklen_t fromLen = sizeof(from);
+  ssize_t len = recvfrom(busSocket, &frame, sizeof(frame), MSG_DONTWAIT, (sockaddr*)&from, &fromLen);
+  if (len < (ssize_t)BUS_HEADER_LEN || frame.magic[0] != 'E' || frame.magic[1] != 'N') return;
+  if (busTrace) {
+    fprintf(stderr, "[radio] rx kind=%u ch=%u id=%u len=%d from %02x:%02x to %02x:%02x (on ch %u)\n", frame.kind,
+            frame.channel, frame.id, (int)len, frame.src[4], frame.src[5], frame.dst[4], frame.dst[5],
+            radioChannel.load());
+  }
+
+  uint8_t mac[6];
+  uint8_t channel;
+  {
+    std::lock_guard<std::mutex> guard(radioMutex);
+    memcpy(mac, radioMac, 6);
+    channel = radioChannel;
+  }
+  if (frame.channel != channel) return;
+
+  if (frame.kind == SIM_FRAME_ACK) {
+    if (memcmp(frame.dst, mac, 6) != 0) return;
+
+    bool acked = false;
+    {
+      std::lock_guard<std::mutex> guard(radioMutex);
+      for (size_t i = 0; i < pending.size(); i++) {
+        if (pending[i].id != frame.id) continue;
+        pending.erase(pending.begin() + i);
+        acked = true;
+        break;
+      }
+    }
+    esp_now_send_cb_t callback = sendCallback.load();
+    if (acked && callback) callback(frame.src, ESP_NOW_SEND_SUCCESS);
+    return;
+  }
+
+  bool unicast = memcmp(frame.dst, mac, 6) == 0;
+  if (!unicast && memcmp(frame.dst, broadcastMac, 6) != 0) return;
+
+  if (unicast) {
+    BusFrame ack;
+    memcpy(ack.magic, "EN", 2);
+    ack.kind = SIM_FRAME_ACK;
+    ack.channel = channel;
+    memcpy(ack.src, mac, 6);
+    memcpy(ack.dst, frame.src, 6);
+    ack.id = frame.id;
+    busSend(ack, BUS_HEADER_LEN, &from);
+  }
+
+  esp_now_recv_cb_t callback = recvCallback.load();
+  if (callback == nullptr) return;
+
+  wifi_pkt_rx_ctrl_t rxCtrl;
+  memset(&rxCtrl, 0, sizeof(rxCtrl));
+  rxCtrl.rssi = -40 - (int)(esp_random() % 20);
+  rxCtrl.channel = channel;
+  esp_now_recv_info_t info = { frame.src, frame.dst, &rxCtrl };
+  callback(&info, frame.payload, len - BUS_HEADER_LEN);
+}
+
+// Send callbacks whose outcome is known: broadcasts right away, unicasts
+// once acknowledged (in busReceive) or timed out
+static void busCompleteSends() {
+  std::vector<PendingSend> done;
+  auto now = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> guard(radioMutex);
+    for (size_t i = 0; i < pending.size();) {
+      if (pending[i].broadcast || now >= pending[i].deadline) {
+        done.push_back(pending[i]);
+        pending.erase(pending.begin() + i);
+      } else {
+        i++;
+      }
+    }
+  }
+
+  esp_now_send_cb_t callback = sendCallback.load();
+  if (callback == nullptr) return;
+  for (const PendingSend& send : done) {
+    callback(send.dst, send.broadcast ? ESP_NOW_SEND_SUCCESS : ESP_NOW_SEND_FAIL);
+  }
+}
+
+// Plays the WiFi task: every callback runs on this one thread
+static void busTask() {
+  pollfd fd = { busSocket, POLLIN, 0 };
+  while (1) {
+    if (poll(&fd, 1, 2) > 0) busReceive();
+    busCompleteSends();
+  }
+}
+
+esp_err_t esp_now_init() {
+  std::lock_guard<std::mutex> guard(radioMutex);
+  radioInit();
+  if (busSocket >= 0) return ESP_OK;
+
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) return ESP_ERR_ESPNOW_INTERNAL;
+
+  busBase = envInt("SIM_BUS_PORT", SIM_BUS_PORT);
+  busTrace = envInt("SIM_RADIO_TRACE", 0) != 0;
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  for (uint16_t port = busBase; port < busBase + SIM_BUS_PORTS; port++) {
+    addr.sin_port = htons(port);
+    if (bind(fd, (const sockaddr*)&addr, sizeof(addr)) == 0) {
+      busPort = port;
+      break;
+    }
+  }
+  if (busPort == 0) {
+    close(fd);
+    return ESP_ERR_ESPNOW_INTERNAL;
+  }
+
+  busSocket = fd;
+  std::thread(busTask).detach();
+  return ESP_OK;
+}
+
+esp_err_t esp_now_deinit() {
+  return ESP_OK;
+}
+
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t callback) {
+  recvCallback = callback;
+  return ESP_OK;
+}
+
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t callback) {
+  sendCallback = callback;
+  return ESP_OK;
+}
+
+static int peerIndex(const uint8_t* peerAddr) {
+  for (size_t i = 0; i < peers.size(); i++) {
+    if (memcmp(peers[i].data(), peerAddr, 6) == 0) return i;
+  }
+  return -1;
+}
+
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer) {
+  if (peer == nullptr) return ESP_ERR_ESPNOW_ARG;
+  std::lock_guard<std::mutex> guard(radioMutex);
+  if (busSocket < 0) return ESP_ERR_ESPNOW_NOT_INIT;
+  if (peerIndex(peer->peer_addr) >= 0) return ESP_ERR_ESPNOW_EXIST;
+
+  std::array<uint8_t, 6> mac;
+  memcpy(mac.data(), peer->peer_addr, 6);
+  peers.push_back(mac);
+  return ESP_OK;
+}
+
+esp_err_t esp_now_del_peer(const uint8_t* peerAddr) {
+  std::lock_guard<std::mutex> guard(radioMutex);
+  int i = peerIndex(peerAddr);
+  if (i < 0) return ESP_ERR_ESPNOW_NOT_FOUND;
+  peers.erase(peers.begin() + i);
+  return ESP_OK;
+}
+
+bool esp_now_is_peer_exist(const uint8_t* peerAddr) {
+  std::lock_guard<std::mutex> guard(radioMutex);
+  return peerIndex(peerAddr) >= 0;
+}
+
+esp_err_t esp_now_send(const uint8_t* peerAddr, const uint8_t* data, size_t len) {
+  if (peerAddr == nullptr || data == nullptr || len == 0 || len > ESP_NOW_MAX_DATA_LEN) return ESP_ERR_ESPNOW_ARG;
+
+  BusFrame frame;
+  PendingSend send;
+  {
+    std::lock_guard<std::mutex> guard(radioMutex);
+    if (busSocket < 0) return ESP_ERR_ESPNOW_NOT_INIT;
+    if (peerIndex(peerAddr) < 0) return ESP_ERR_ESPNOW_NOT_FOUND;
+
+    memcpy(frame.magic, "EN", 2);
+    frame.kind = SIM_FRAME_DATA;
+    frame.channel = radioChannel;
+    memcpy(frame.src, radioMac, 6);
+    memcpy(frame.dst, peerAddr, 6);
+    frame.id = busNextId++;
+    memcpy(frame.payload, data, len);
+
+    send.id = frame.id;
+    memcpy(send.dst, peerAddr, 6);
+    send.broadcast = memcmp(peerAddr, broadcastMac, 6) == 0;
+    send.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SIM_ACK_TIMEOUT_MS);
+    pending.push_back(send);
+  }
+
+  busSend(frame, BUS_HEADER_LEN + len, nullptr);
+  return ESP_OK;
+}
+
+/* ===== Sleep ==== */
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs) {
+  sleepWakeupUs = timeUs;
+  return ESP_OK;
+}
+
+void esp_deep_sleep_start() {
+  fflush(stdout);
+  std::this_thread::sleep_for(std::chrono::microseconds(sleepWakeupUs));
+
+  setenv("SIM_WAKEUP_CAUSE", "timer", 1);
+  execl("/proc/self/exe", "/proc/self/exe", (char*)nullptr);
+  _exit(1);
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() {
+  const char* cause = getenv("SIM_WAKEUP_CAUSE");
+  return cause && strcmp(cause, "timer") == 0 ? ESP_SLEEP_WAKEUP_TIMER : ESP_SLEEP_WAKEUP_UNDEFINED;
+}
+
+/* ===== DHT ==== */
+static std::function<float(bool)> dhtReader;
+
+void simSetDhtReader(std::function<float(bool humidity)> reader) {
+  dhtReader = reader;
+}
+
+float DHT::readTemperature(bool fahrenheit, bool force) {
+  float celsius = dhtReader ? dhtReader(false) : 27.0f + 1.5f * sinf(millis() / 120000.0f);
+  return fahrenheit ? celsius * 1.8f + 32 : celsius;
+}
+
+float DHT::readHumidity(bool force) {
+  return dhtReader ? dhtReader(true) : 60.0f + 6.0f * sinf(millis() / 300000.0f);
+}
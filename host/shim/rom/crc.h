@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdint.h>
+
+// CRC-32 (IEEE 802.3), the ROM routine: crc32_le(0, buf, len) equals zlib's crc32()
+uint32_t crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
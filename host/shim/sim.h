@@ -0,0 +1,87 @@
+// Controls for the host build that have no Arduino counterpart: what the
+// simulated sensors read, where the flash lives, how time is stepped, and
+// an in-process HTTP client for tests. The sketches never include this.
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+class AsyncWebServer;
+class AsyncWebSocket;
+class AsyncWebSocketClient;
+
+// Runs setup() and then loop() forever on the calling thread, which plays
+// the Arduino loop task. Returns only if loop() deletes its own task and
+// joinLoopTask is false.
+void simRunSketch(void (*setup)(), void (*loop)(), bool joinLoopTask = true);
+
+// Wall clock. The firmware reads it through gettimeofday()/time(), so the
+// offset is applied there; SNTP smooth-mode slews are modelled by adjtime().
+void simSetWallClock(int64_t epochUs);
+void simStepWallClock(int64_t deltaUs);
+void simSetSntpStatus(int status);  // sntp_sync_status_t
+void simSntpSync();                 // fires the sync notification callback
+
+// Bytes String has copied into its buffers (constructors, concat, +),
+// for benchmarks that compare it with fixed buffers
+uint64_t simStringBytesCopied();
+
+// Sensors
+void simSetAnalogReader(std::function<uint16_t(uint8_t pin)> reader);
+void simSetDhtReader(std::function<float(bool humidity)> reader);
+
+// Flash. The root is a host directory; a power cut lets the next
+// mutating operations succeed and makes every one after that fail, as if
+// the chip lost power between them.
+void simFsSetRoot(const char* path);
+const char* simFsRoot();
+void simFsPowerCut(int operationsLeft);
+void simFsPowerRestore();
+int simFsOperations();  // mutating operations since the last restore
+uint64_t simFsBytesWritten();  // file data written since start, index and compaction included
+
+// Radio
+void simSetMac(const uint8_t mac[6]);
+void simSetApChannel(uint8_t channel);
+uint8_t simRadioChannel();
+
+// In-process HTTP: runs the request through the server's handlers the way
+// AsyncTCP would, delivering the body in chunks of bodyChunk bytes and
+// draining chunked responses responseChunk bytes at a time.
+struct SimHttpResponse {
+  int code;
+  std::string contentType;
+  std::vector<std::pair<std::string, std::string>> headers;
+  std::string body;
+  size_t chunks;  // filler calls that returned data
+
+  const std::string* header(const char* name) const;
+};
+
+SimHttpResponse simHttpRequest(AsyncWebServer& server, const char* method, const char* url,
+                               const std::vector<std::pair<std::string, std::string>>& headers = {},
+                               const std::string& body = std::string(), size_t bodyChunk = 1436,
+                               size_t responseChunk = 1436);
+
+// A WebSocket client without a socket: frames the firmware sends land in
+// received. With autoDrain off the client's queue only empties on
+// simWsDrain(), which is how a slow browser looks to the firmware.
+// Firmware tasks append while the test reads, so go through lock or
+// simWsReceived().
+struct SimWsPeer {
+  AsyncWebSocketClient* client;
+  std::mutex lock;
+  std::vector<std::vector<uint8_t>> received;
+  bool closed = false;
+};
+
+SimWsPeer* simWsConnect(AsyncWebSocket& socket, bool autoDrain = true);
+void simWsSend(SimWsPeer* peer, const uint8_t* data, size_t len);
+size_t simWsDrain(SimWsPeer* peer, size_t frames);
+void simWsDisconnect(SimWsPeer* peer);
+std::vector<std::vector<uint8_t>> simWsReceived(SimWsPeer* peer);
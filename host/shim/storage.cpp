@@ -0,0 +1,305 @@
+#include <LittleFS.h>
+#include <Preferences.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "sim.h"
+
+LittleFSFS LittleFS;
+
+struct fs::FileImpl {
+  FILE* fp;
+  std::string path;
+  bool writable;
+};
+
+static std::mutex fsMutex;
+static std::string fsRoot;
+static std::atomic<int> fsOperations(0);
+static std::atomic<int> fsOperationsLeft(-1);  // -1 = power stays on
+static std::atomic<uint64_t> fsBytesWritten(0);
+
+void simFsSetRoot(const char* path) {
+  std::lock_guard<std::mutex> guard(fsMutex);
+  fsRoot = path;
+}
+
+const char* simFsRoot() {
+  std::lock_guard<std::mutex> guard(fsMutex);
+  if (fsRoot.empty()) {
+    const char* dir = getenv("SIM_FS_DIR");
+    fsRoot = dir && *dir ? dir : "littlefs";
+  }
+  return fsRoot.c_str();
+}
+
+void simFsPowerCut(int operationsLeft) {
+  fsOperations = 0;
+  fsOperationsLeft = operationsLeft;
+}
+
+void simFsPowerRestore() {
+  fsOperations = 0;
+  fsOperationsLeft = -1;
+}
+
+int simFsOperations() {
+  return fsOperations;
+}
+
+uint64_t simFsBytesWritten() {
+  return fsBytesWritten;
+}
+
+// Counts one mutating operation. Returns 1 when it may go through, 0 when
+// the power is already gone, and -1 for the operation the power dies in.
+static int fsPowered() {
+  int n = ++fsOperations;
+  int left = fsOperationsLeft.load();
+  if (left < 0 || n <= left) return 1;
+  return n == left + 1 ? -1 : 0;
+}
+
+static std::string hostPath(const char* path) {
+  std::string full = simFsRoot();
+  if (path[0] != '/') full += '/';
+  return full + path;
+}
+
+static void makeParents(const std::string& path) {
+  for (size_t i = 1; i < path.size(); i++) {
+    if (path[i] != '/') continue;
+    ::mkdir(path.substr(0, i).c_str(), 0755);
+  }
+}
+
+size_t fs::File::write(const uint8_t* buffer, size_t size) {
+  if (!impl || !impl->fp || !impl->writable) return 0;
+
+  int powered = fsPowered();
+  if (powered == 0) return 0;
+  // The write the power dies in lands halfway
+  size_t n = fwrite(buffer, 1, powered < 0 ? size / 2 : size, impl->fp);
+  fsBytesWritten += n;
+  return powered < 0 ? 0 : n;
+}
+
+size_t fs::File::read(uint8_t* buffer, size_t size) {
+  if (!impl || !impl->fp) return 0;
+  return fread(buffer, 1, size, impl->fp);
+}
+
+int fs::File::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int fs::File::available() {
+  if (!impl || !impl->fp) return 0;
+  return size() - position();
+}
+
+bool fs::File::seek(uint32_t pos, SeekMode mode) {
+  if (!impl || !impl->fp) return false;
+  static const int whence[] = { SEEK_SET, SEEK_CUR, SEEK_END };
+  return fseek(impl->fp, pos, whence[mode]) == 0;
+}
+
+size_t fs::File::position() const {
+  if (!impl || !impl->fp) return 0;
+  long pos = ftell(impl->fp);
+  return pos < 0 ? 0 : pos;
+}
+
+size_t fs::File::size() const {
+  if (!impl || !impl->fp) return 0;
+  struct stat st;
+  return fstat(fileno(impl->fp), &st) == 0 ? st.st_size : 0;
+}
+
+void fs::File::flush() {
+  if (impl && impl->fp) fflush(impl->fp);
+}
+
+void fs::File::close() {
+  if (impl && impl->fp) {
+    fclose(impl->fp);
+    impl->fp = nullptr;
+  }
+  impl.reset();
+}
+
+const char* fs::File::path() const {
+  return impl ? impl->path.c_str() : "";
+}
+
+fs::File::operator bool() const {
+  return impl && impl->fp;
+}
+
+fs::File fs::FS::open(const char* path, const char* mode, bool create) {
+  std::string full = hostPath(path);
+  bool writable = mode[0] != 'r' || strchr(mode, '+') != nullptr;
+
+  if (writable) {
+    if (fsPowered() <= 0) return File();
+    if (create || mode[0] != 'r') makeParents(full);
+  }
+
+  FILE* fp = fopen(full.c_str(), mode);
+  if (fp == nullptr) return File();
+  setvbuf(fp, nullptr, _IONBF, 0);
+
+  auto impl = std::make_shared<FileImpl>();
+  impl->fp = fp;
+  impl->path = path;
+  impl->writable = writable;
+  return File(impl);
+}
+
+bool fs::FS::exists(const char* path) {
+  struct stat st;
+  return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool fs::FS::remove(const char* path) {
+  if (fsPowered() <= 0) return false;
+  return unlink(hostPath(path).c_str()) == 0;
+}
+
+// Replaces an existing target in one step, like lfs_rename()
+bool fs::FS::rename(const char* from, const char* to) {
+  if (fsPowered() <= 0) return false;
+  return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool fs::FS::mkdir(const char* path) {
+  if (fsPowered() <= 0) return false;
+  return ::mkdir(hostPath(path).c_str(), 0755) == 0;
+}
+
+bool fs::FS::rmdir(const char* path) {
+  if (fsPowered() <= 0) return false;
+  return ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+bool LittleFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+  std::string root = simFsRoot();
+  makeParents(root + "/");
+  struct stat st;
+  return stat(root.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+static void removeTree(const std::string& path, bool keepRoot) {
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) return;
+
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+    std::string child = path + "/" + entry->d_name;
+    struct stat st;
+    if (lstat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+      removeTree(child, false);
+    } else {
+      unlink(child.c_str());
+    }
+  }
+  closedir(dir);
+  if (!keepRoot) ::rmdir(path.c_str());
+}
+
+static size_t treeBytes(const std::string& path) {
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) return 0;
+
+  size_t total = 0;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+    std::string child = path + "/" + entry->d_name;
+    struct stat st;
+    if (lstat(child.c_str(), &st) != 0) continue;
+    total += S_ISDIR(st.st_mode) ? treeBytes(child) : st.st_size;
+  }
+  closedir(dir);
+  return total;
+}
+
+bool LittleFSFS::format() {
+  removeTree(simFsRoot(), true);
+  return true;
+}
+
+size_t LittleFSFS::totalBytes() {
+  return 1408 * 1024;
+}
+
+size_t LittleFSFS::usedBytes() {
+  return treeBytes(simFsRoot());
+}
+
+/* ===== Preferences ==== */
+static std::mutex nvsMutex;
+static std::map<std::string, std::map<std::string, std::vector<uint8_t>>> nvs;
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partitionLabel) {
+  if (started || name == nullptr || strlen(name) > 15) return false;
+  space = name;
+  this->readOnly = readOnly;
+  started = true;
+  return true;
+}
+
+void Preferences::end() {
+  started = false;
+}
+
+bool Preferences::clear() {
+  if (!started || readOnly) return false;
+  std::lock_guard<std::mutex> guard(nvsMutex);
+  nvs[space].clear();
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  if (!started || readOnly) return false;
+  std::lock_guard<std::mutex> guard(nvsMutex);
+  return nvs[space].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+  return getBytesLength(key) > 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+  if (!started || readOnly || key == nullptr || strlen(key) > 15) return 0;
+  std::lock_guard<std::mutex> guard(nvsMutex);
+  const uint8_t* bytes = (const uint8_t*)value;
+  nvs[space][key].assign(bytes, bytes + len);
+  return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLen) {
+  if (!started) return 0;
+  std::lock_guard<std::mutex> guard(nvsMutex);
+  auto found = nvs[space].find(key);
+  if (found == nvs[space].end() || found->second.size() > maxLen) return 0;
+  memcpy(buffer, found->second.data(), found->second.size());
+  return found->second.size();
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  if (!started) return 0;
+  std::lock_guard<std::mutex> guard(nvsMutex);
+  auto found = nvs[space].find(key);
+  return found == nvs[space].end() ? 0 : found->second.size();
+}
@@ -0,0 +1,113 @@
+// Wall clock and SNTP. gettimeofday(), time() and adjtime() are replaced
+// for the whole process so tests can set and step the clock the firmware
+// sees without touching the host's.
+#include <Arduino.h>
+#include <esp_sntp.h>
+
+#include <atomic>
+#include <thread>
+
+#include "sim.h"
+
+static std::atomic<int64_t> wallOffsetUs(0);
+static std::atomic<int64_t> slewPendingUs(0);
+static std::atomic<int> syncStatus(SNTP_SYNC_STATUS_RESET);
+static sntp_sync_mode_t syncMode = SNTP_SYNC_MODE_IMMED;
+static uint32_t syncIntervalMs = 3600000;
+static std::atomic<sntp_sync_time_cb_t> syncCallback(nullptr);
+
+extern "C" int gettimeofday(struct timeval* __restrict tv, void* __restrict tz) __THROW {
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  int64_t us = now.tv_sec * 1000000LL + now.tv_nsec / 1000 + wallOffsetUs.load();
+
+  tv->tv_sec = us / 1000000;
+  tv->tv_usec = us % 1000000;
+  if (tv->tv_usec < 0) {
+    tv->tv_sec--;
+    tv->tv_usec += 1000000;
+  }
+  return 0;
+}
+
+extern "C" time_t time(time_t* out) __THROW {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  if (out) *out = tv.tv_sec;
+  return tv.tv_sec;
+}
+
+// Nothing slews on its own, the pending correction only changes when set
+extern "C" int adjtime(const struct timeval* delta, struct timeval* oldDelta) __THROW {
+  if (oldDelta) {
+    int64_t pending = slewPendingUs.load();
+    oldDelta->tv_sec = pending / 1000000;
+    oldDelta->tv_usec = pending % 1000000;
+  }
+  if (delta) slewPendingUs = delta->tv_sec * 1000000LL + delta->tv_usec;
+  return 0;
+}
+
+void simSetWallClock(int64_t epochUs) {
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  wallOffsetUs = epochUs - (now.tv_sec * 1000000LL + now.tv_nsec / 1000);
+}
+
+void simStepWallClock(int64_t deltaUs) {
+  wallOffsetUs += deltaUs;
+}
+
+void simSetSntpStatus(int status) {
+  syncStatus = status;
+}
+
+void simSntpSync() {
+  sntp_sync_time_cb_t callback = syncCallback.load();
+  if (callback == nullptr) return;
+
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  callback(&tv);
+}
+
+void sntp_set_sync_mode(sntp_sync_mode_t mode) {
+  syncMode = mode;
+}
+
+sntp_sync_mode_t sntp_get_sync_mode() {
+  return syncMode;
+}
+
+void sntp_set_sync_interval(uint32_t intervalMs) {
+  syncIntervalMs = intervalMs;
+}
+
+uint32_t sntp_get_sync_interval() {
+  return syncIntervalMs;
+}
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback) {
+  syncCallback = callback;
+}
+
+sntp_sync_status_t sntp_get_sync_status() {
+  int expected = SNTP_SYNC_STATUS_COMPLETED;
+  if (syncStatus.compare_exchange_strong(expected, SNTP_SYNC_STATUS_RESET)) return SNTP_SYNC_STATUS_COMPLETED;
+  return (sntp_sync_status_t)syncStatus.load();
+}
+
+void sntp_set_sync_status(sntp_sync_status_t status) {
+  syncStatus = status;
+}
+
+// The host clock is already right: the first "reply" lands shortly after,
+// the way lwIP calls back from its own task
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char* server1, const char* server2,
+                const char* server3) {
+  std::thread([] {
+    delay(100);
+    syncStatus = SNTP_SYNC_STATUS_COMPLETED;
+    simSntpSync();
+  }).detach();
+}
@@ -0,0 +1,781 @@
+#include <ESPAsyncWebServer.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+
+#include "sim.h"
+
+static const String emptyString;
+
+/* ===== Responses ==== */
+static size_t fillFrom(const uint8_t* content, size_t length, size_t& sent, uint8_t* buffer, size_t maxLen) {
+  size_t n = min(length - sent, maxLen);
+  memcpy(buffer, content + sent, n);
+  sent += n;
+  return n;
+}
+
+size_t AsyncBasicResponse::fill(uint8_t* buffer, size_t maxLen) {
+  return fillFrom((const uint8_t*)_content.c_str(), _content.length(), _sent, buffer, maxLen);
+}
+
+size_t AsyncProgmemResponse::fill(uint8_t* buffer, size_t maxLen) {
+  return fillFrom(_content, _length, _sent, buffer, maxLen);
+}
+
+AsyncFileResponse::AsyncFileResponse(FS& fs, const String& path, const String& contentType)
+  : AsyncWebServerResponse(200, contentType), _file(fs.open(path, "r")) {
+  if (!_file) _code = 404;
+}
+
+size_t AsyncFileResponse::fill(uint8_t* buffer, size_t maxLen) {
+  return _file ? _file.read(buffer, maxLen) : 0;
+}
+
+size_t AsyncChunkedResponse::fill(uint8_t* buffer, size_t maxLen) {
+  size_t n = _filler(buffer, maxLen, _index);
+  if (n != RESPONSE_TRY_AGAIN) _index += n;
+  return n;
+}
+
+size_t AsyncResponseStream::write(const uint8_t* data, size_t len) {
+  _content.append((const char*)data, len);
+  return len;
+}
+
+size_t AsyncResponseStream::fill(uint8_t* buffer, size_t maxLen) {
+  return fillFrom((const uint8_t*)_content.data(), _content.size(), _sent, buffer, maxLen);
+}
+
+/* ===== Requests ==== */
+AsyncWebServerRequest::AsyncWebServerRequest(AsyncWebServer* server, WebRequestMethodComposite method,
+                                             const String& url)
+  : _server(server), _method(method), _url(url) {}
+
+// The connection is gone once the request is, as on the chip
+AsyncWebServerRequest::~AsyncWebServerRequest() {
+  if (_onDisconnect) _onDisconnect();
+  delete _response;
+  free(_tempObject);
+}
+
+bool AsyncWebServerRequest::hasParam(const String& name, bool post, bool file) const {
+  return getParam(name, post, file) != nullptr;
+}
+
+AsyncWebParameter* AsyncWebServerRequest::getParam(const String& name, bool post, bool file) const {
+  for (auto& param : _params) {
+    if (param->name() == name) return param.get();
+  }
+  return nullptr;
+}
+
+AsyncWebParameter* AsyncWebServerRequest::getParam(size_t index) const {
+  return index < _params.size() ? _params[index].get() : nullptr;
+}
+
+bool AsyncWebServerRequest::hasHeader(const String& name) const {
+  return getHeader(name) != nullptr;
+}
+
+AsyncWebHeader* AsyncWebServerRequest::getHeader(const String& name) const {
+  for (auto& header : _headers) {
+    if (strcasecmp(header->name().c_str(), name.c_str()) == 0) return header.get();
+  }
+  return nullptr;
+}
+
+const String& AsyncWebServerRequest::header(const char* name) const {
+  AsyncWebHeader* found = getHeader(name);
+  return found ? found->value() : emptyString;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const String& contentType,
+                                                             const String& content) {
+  return new AsyncBasicResponse(code, contentType, content);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(FS& fs, const String& path, const String& contentType,
+                                                             bool download) {
+  return new AsyncFileResponse(fs, path, contentType);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse_P(int code, const String& contentType,
+                                                               const uint8_t* content, size_t len) {
+  return new AsyncProgmemResponse(code, contentType, content, len);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginChunkedResponse(const String& contentType,
+                                                                    AwsResponseFiller filler) {
+  return new AsyncChunkedResponse(contentType, filler);
+}
+
+AsyncResponseStream* AsyncWebServerRequest::beginResponseStream(const String& contentType, size_t bufferSize) {
+  return new AsyncResponseStream(contentType, bufferSize);
+}
+
+// Only the first response goes out
+void AsyncWebServerRequest::send(AsyncWebServerResponse* response) {
+  if (_response != nullptr) {
+    delete response;
+    return;
+  }
+  _response = response;
+}
+
+void AsyncWebServerRequest::send(int code, const String& contentType, const String& content) {
+  send(beginResponse(code, contentType, content));
+}
+
+/* ===== Handlers ==== */
+// Same rules as the library: exact path, "<uri>/..." below it, or a
+// trailing "*" prefix match
+bool AsyncCallbackWebHandler::canHandle(AsyncWebServerRequest* request) {
+  if (!_onRequest || !(_method & request->method())) return false;
+
+  if (_uri.length() > 0 && _uri.endsWith("*")) {
+    return request->url().startsWith(_uri.substring(0, _uri.length() - 1));
+  }
+  if (_uri.length() > 0 && _uri != request->url()) {
+    String below = _uri;
+    below += "/";
+    if (!request->url().startsWith(below)) return false;
+  }
+  return true;
+}
+
+void AsyncCallbackWebHandler::handleRequest(AsyncWebServerRequest* request) {
+  if (_onRequest) _onRequest(request);
+}
+
+void AsyncCallbackWebHandler::handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index,
+                                         size_t total) {
+  if (_onBody) _onBody(request, data, len, index, total);
+}
+
+/* ===== WebSocket ==== */
+bool AsyncWebSocketClient::canSend() {
+  std::lock_guard<std::mutex> guard(_lock);
+  return _queue.size() < WS_MAX_QUEUED_MESSAGES;
+}
+
+size_t AsyncWebSocketClient::queueLen() {
+  std::lock_guard<std::mutex> guard(_lock);
+  return _queue.size();
+}
+
+void AsyncWebSocketClient::binary(const uint8_t* data, size_t len) {
+  queue(WS_BINARY, std::vector<uint8_t>(data, data + len));
+}
+
+// The library takes ownership of the buffer
+void AsyncWebSocketClient::binary(AsyncWebSocketMessageBuffer* buffer) {
+  if (buffer == nullptr) return;
+  queue(WS_BINARY, std::move(buffer->_data));
+  delete buffer;
+}
+
+void AsyncWebSocketClient::text(const char* data, size_t len) {
+  queue(WS_TEXT, std::vector<uint8_t>(data, data + len));
+}
+
+// Like the library, a full queue drops the message
+void AsyncWebSocketClient::queue(AwsFrameType opcode, std::vector<uint8_t> data) {
+  if (_status != WS_CONNECTED) return;
+  {
+    std::lock_guard<std::mutex> guard(_lock);
+    if (_queue.size() >= WS_MAX_QUEUED_MESSAGES) {
+      Serial.printf("ERROR: Too many messages queued\n");
+      return;
+    }
+    _queue.emplace_back(opcode, std::move(data));
+  }
+  if (_autoDrain) drain(SIZE_MAX);
+}
+
+size_t AsyncWebSocketClient::drain(size_t frames) {
+  std::lock_guard<std::mutex> sending(_sending);
+  size_t sent = 0;
+  bool gone = false;
+
+  while (sent < frames) {
+    std::pair<AwsFrameType, std::vector<uint8_t>> frame;
+    {
+      std::lock_guard<std::mutex> guard(_lock);
+      if (_queue.empty()) break;
+      frame = std::move(_queue.front());
+      _queue.pop_front();
+    }
+    if (!_sink(frame.first, frame.second.data(), frame.second.size())) {
+      gone = true;
+      break;
+    }
+    sent++;
+  }
+
+  if (gone) _server->disconnected(this);
+  return sent;
+}
+
+void AsyncWebSocketClient::close(uint16_t code, const char* message) {
+  AwsClientStatus expected = WS_CONNECTED;
+  if (!_status.compare_exchange_strong(expected, WS_DISCONNECTING)) return;
+
+  uint8_t payload[2] = { (uint8_t)(code >> 8), (uint8_t)code };
+  {
+    std::lock_guard<std::mutex> sending(_sending);
+    _sink(WS_DISCONNECT, payload, code ? 2 : 0);
+  }
+  _server->disconnected(this);
+}
+
+bool AsyncWebSocket::canHandle(AsyncWebServerRequest* request) {
+  return request->method() == HTTP_GET && request->url() == _url && request->hasHeader("Upgrade")
+         && strcasecmp(request->header("Upgrade").c_str(), "websocket") == 0;
+}
+
+size_t AsyncWebSocket::count() {
+  std::lock_guard<std::mutex> guard(_lock);
+  size_t n = 0;
+  for (AsyncWebSocketClient* client : _clients) {
+    if (client->status() == WS_CONNECTED) n++;
+  }
+  return n;
+}
+
+AsyncWebSocketClient* AsyncWebSocket::client(uint32_t id) {
+  std::lock_guard<std::mutex> guard(_lock);
+  for (AsyncWebSocketClient* client : _clients) {
+    if (client->id() == id && client->status() == WS_CONNECTED) return client;
+  }
+  return nullptr;
+}
+
+// Closes the oldest client while there are too many
+void AsyncWebSocket::cleanupClients(uint16_t maxClients) {
+  AsyncWebSocketClient* oldest = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(_lock);
+    size_t connected = 0;
+    for (AsyncWebSocketClient* client : _clients) {
+      if (client->status() != WS_CONNECTED) continue;
+      if (oldest == nullptr) oldest = client;
+      connected++;
+    }
+    if (connected <= maxClients) oldest = nullptr;
+  }
+  if (oldest != nullptr) oldest->close();
+}
+
+void AsyncWebSocket::closeAll(uint16_t code, const char* message) {
+  std::vector<AsyncWebSocketClient*> clients;
+  {
+    std::lock_guard<std::mutex> guard(_lock);
+    clients = _clients;
+  }
+  for (AsyncWebSocketClient* client : clients) client->close(code, message);
+}
+
+AsyncWebSocketClient* AsyncWebSocket::accept(AsyncWebSocketClient::Sink sink, bool autoDrain) {
+  AsyncWebSocketClient* client;
+  {
+    std::lock_guard<std::mutex> guard(_lock);
+    client = new AsyncWebSocketClient(this, _nextId++, sink, autoDrain);
+    _clients.push_back(client);
+  }
+  if (_handler) _handler(this, client, WS_EVT_CONNECT, nullptr, nullptr, 0);
+  return client;
+}
+
+void AsyncWebSocket::receive(AsyncWebSocketClient* client, AwsFrameType opcode, uint8_t* data, size_t len) {
+  if (client->status() != WS_CONNECTED) return;
+
+  AwsFrameInfo info = {};
+  info.message_opcode = opcode;
+  info.final = 1;
+  info.masked = 1;
+  info.opcode = opcode;
+  info.len = len;
+  info.index = 0;
+  if (_handler) _handler(this, client, WS_EVT_DATA, &info, data, len);
+}
+
+void AsyncWebSocket::disconnected(AsyncWebSocketClient* client) {
+  if (client->_status.exchange(WS_DISCONNECTED) == WS_DISCONNECTED) return;
+  {
+    std::lock_guard<std::mutex> guard(client->_lock);
+    client->_queue.clear();
+  }
+  if (_handler) _handler(this, client, WS_EVT_DISCONNECT, nullptr, nullptr, 0);
+}
+
+/* ===== Server ==== */
+AsyncWebServer::AsyncWebServer(uint16_t port) : _port(port) {
+  const char* env = getenv("SIM_HTTP_PORT");
+  if (env && *env) _port = atoi(env);
+  // Privileged ports are out of reach of a normal user
+  else if (_port < 1024) _port = 8080;
+}
+
+AsyncWebServer::~AsyncWebServer() {
+  end();
+}
+
+AsyncWebHandler& AsyncWebServer::addHandler(AsyncWebHandler* handler) {
+  _handlers.push_back(handler);
+  return *handler;
+}
+
+AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, WebRequestMethodComposite method,
+                                            ArRequestHandlerFunction onRequest) {
+  return on(uri, method, onRequest, nullptr, nullptr);
+}
+
+AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, WebRequestMethodComposite method,
+                                            ArRequestHandlerFunction onRequest, ArUploadHandlerFunction onUpload) {
+  return on(uri, method, onRequest, onUpload, nullptr);
+}
+
+AsyncCallbackWebHandler& AsyncWebServer::on(const char* uri, WebRequestMethodComposite method,
+                                            ArRequestHandlerFunction onRequest, ArUploadHandlerFunction onUpload,
+                                            ArBodyHandlerFunction onBody) {
+  AsyncCallbackWebHandler* handler = new AsyncCallbackWebHandler();
+  handler->setUri(uri);
+  handler->setMethod(method);
+  handler->onRequest(onRequest);
+  handler->onUpload(onUpload);
+  handler->onBody(onBody);
+  _owned.emplace_back(handler);
+  addHandler(handler);
+  return *handler;
+}
+
+AsyncWebHandler* AsyncWebServer::findHandler(AsyncWebServerRequest* request) {
+  for (AsyncWebHandler* handler : _handlers) {
+    if (handler->canHandle(request)) return handler;
+  }
+  return nullptr;
+}
+
+void AsyncWebServer::notFound(AsyncWebServerRequest* request) {
+  if (_notFound) _notFound(request);
+  else request->send(404);
+}
+
+/* ===== Request plumbing shared by the socket server and tests ==== */
+static WebRequestMethodComposite parseMethod(const char* method) {
+  static const struct {
+    const char* name;
+    WebRequestMethod method;
+  } methods[] = {
+    { "GET", HTTP_GET }, { "POST", HTTP_POST }, { "DELETE", HTTP_DELETE }, { "PUT", HTTP_PUT },
+    { "PATCH", HTTP_PATCH }, { "HEAD", HTTP_HEAD }, { "OPTIONS", HTTP_OPTIONS },
+  };
+  for (auto& m : methods) {
+    if (strcmp(m.name, method) == 0) return m.method;
+  }
+  return 0;
+}
+
+static int hexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+static String urlDecode(const std::string& text) {
+  std::string out;
+  for (size_t i = 0; i < text.size(); i++) {
+    if (text[i] == '+') {
+      out += ' ';
+    } else if (text[i] == '%' && i + 2 < text.size() && hexDigit(text[i + 1]) >= 0 && hexDigit(text[i + 2]) >= 0) {
+      out += (char)(hexDigit(text[i + 1]) << 4 | hexDigit(text[i + 2]));
+      i += 2;
+    } else {
+      out += text[i];
+    }
+  }
+  return String(out.c_str());
+}
+
+static AsyncWebServerRequest* buildRequest(AsyncWebServer& server, const char* method, const std::string& target,
+                                           const std::vector<std::pair<std::string, std::string>>& headers,
+                                           size_t contentLength) {
+  size_t query = target.find('?');
+  std::string path = target.substr(0, query);
+  AsyncWebServerRequest* request =
+    new AsyncWebServerRequest(&server, parseMethod(method), urlDecode(path));
+
+  if (query != std::string::npos) {
+    std::string rest = target.substr(query + 1);
+    size_t start = 0;
+    while (start <= rest.size()) {
+      size_t end = rest.find('&', start);
+      if (end == std::string::npos) end = rest.size();
+      std::string pair = rest.substr(start, end - start);
+      if (!pair.empty()) {
+        size_t eq = pair.find('=');
+        request->addParam(urlDecode(pair.substr(0, eq)),
+                          eq == std::string::npos ? String() : urlDecode(pair.substr(eq + 1)));
+      }
+      start = end + 1;
+    }
+  }
+
+  for (auto& header : headers) request->addHeader(header.first.c_str(), header.second.c_str());
+  request->setContentLength(contentLength);
+  return request;
+}
+
+const std::string* SimHttpResponse::header(const char* name) const {
+  for (auto& h : headers) {
+    if (strcasecmp(h.first.c_str(), name) == 0) return &h.second;
+  }
+  return nullptr;
+}
+
+// Body in chunks of bodyChunk bytes, then the request handler, then the
+// response drained responseChunk bytes at a time, as AsyncTCP does
+static SimHttpResponse runRequest(AsyncWebServer& server, AsyncWebServerRequest* request, const std::string& body,
+                                  size_t bodyChunk, size_t responseChunk) {
+  AsyncWebHandler* handler = server.findHandler(request);
+
+  if (handler != nullptr && !body.empty()) {
+    std::vector<uint8_t> chunk;
+    for (size_t index = 0; index < body.size(); index += bodyChunk) {
+      size_t n = min(bodyChunk, body.size() - index);
+      chunk.assign(body.begin() + index, body.begin() + index + n);
+      handler->handleBody(request, chunk.data(), n, index, body.size());
+    }
+  }
+
+  if (handler != nullptr) handler->handleRequest(request);
+  else server.notFound(request);
+
+  SimHttpResponse result;
+  result.code = 500;
+  result.chunks = 0;
+
+  AsyncWebServerResponse* response = request->response();
+  if (response != nullptr) {
+    result.code = response->code();
+    result.contentType = response->contentType().c_str();
+    for (auto& h : response->headers()) result.headers.emplace_back(h.first.c_str(), h.second.c_str());
+
+    std::vector<uint8_t> buffer(responseChunk);
+    int retries = 0;
+    while (1) {
+      size_t n = response->fill(buffer.data(), buffer.size());
+      if (n == RESPONSE_TRY_AGAIN) {
+        if (++retries > 5000) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        continue;
+      }
+      if (n == 0) break;
+      result.body.append((const char*)buffer.data(), n);
+      result.chunks++;
+    }
+  }
+
+  delete request;
+  return result;
+}
+
+SimHttpResponse simHttpRequest(AsyncWebServer& server, const char* method, const char* url,
+                               const std::vector<std::pair<std::string, std::string>>& headers,
+                               const std::string& body, size_t bodyChunk, size_t responseChunk) {
+  AsyncWebServerRequest* request = buildRequest(server, method, url, headers, body.size());
+  return runRequest(server, request, body, bodyChunk, responseChunk);
+}
+
+/* ===== In-process WebSocket peers ==== */
+SimWsPeer* simWsConnect(AsyncWebSocket& socket, bool autoDrain) {
+  SimWsPeer* peer = new SimWsPeer();
+  peer->client = socket.accept(
+    [peer](AwsFrameType opcode, const uint8_t* data, size_t len) {
+      std::lock_guard<std::mutex> guard(peer->lock);
+      if (opcode == WS_DISCONNECT) peer->closed = true;
+      else peer->received.emplace_back(data, data + len);
+      return true;
+    },
+    autoDrain);
+  return peer;
+}
+
+void simWsSend(SimWsPeer* peer, const uint8_t* data, size_t len) {
+  std::vector<uint8_t> copy(data, data + len);
+  peer->client->server()->receive(peer->client, WS_BINARY, copy.data(), copy.size());
+}
+
+size_t simWsDrain(SimWsPeer* peer, size_t frames) {
+  return peer->client->drain(frames);
+}
+
+void simWsDisconnect(SimWsPeer* peer) {
+  peer->client->server()->disconnected(peer->client);
+}
+
+std::vector<std::vector<uint8_t>> simWsReceived(SimWsPeer* peer) {
+  std::lock_guard<std::mutex> guard(peer->lock);
+  return peer->received;
+}
+
+/* ===== Socket server ==== */
+static void sha1(const uint8_t* data, size_t length, uint8_t digest[20]) {
+  uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+  std::vector<uint8_t> message(data, data + length);
+  message.push_back(0x80);
+  while (message.size() % 64 != 56) message.push_back(0);
+  uint64_t bits = (uint64_t)length * 8;
+  for (int i = 7; i >= 0; i--) message.push_back(bits >> (i * 8));
+
+  for (size_t block = 0; block < message.size(); block += 64) {
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+      const uint8_t* p = &message[block + i * 4];
+      w[i] = (uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3];
+    }
+    for (int i = 16; i < 80; i++) {
+      uint32_t x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+      w[i] = x << 1 | x >> 31;
+    }
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20) f = (b & c) | (~b & d), k = 0x5A827999;
+      else if (i < 40) f = b ^ c ^ d, k = 0x6ED9EBA1;
+      else if (i < 60) f = (b & c) | (b & d) | (c & d), k = 0x8F1BBCDC;
+      else f = b ^ c ^ d, k = 0xCA62C1D6;
+      uint32_t t = (a << 5 | a >> 27) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = b << 30 | b >> 2;
+      b = a;
+      a = t;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+
+  for (int i = 0; i < 20; i++) digest[i] = h[i / 4] >> (24 - (i % 4) * 8);
+}
+
+static std::string base64(const uint8_t* data, size_t length) {
+  static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < length; i += 3) {
+    uint32_t n = data[i] << 16 | (i + 1 < length ? data[i + 1] << 8 : 0) | (i + 2 < length ? data[i + 2] : 0);
+    out += table[n >> 18 & 63];
+    out += table[n >> 12 & 63];
+    out += i + 1 < length ? table[n >> 6 & 63] : '=';
+    out += i + 2 < length ? table[n & 63] : '=';
+  }
+  return out;
+}
+
+static bool sendAll(int fd, const void* data, size_t length) {
+  const uint8_t* p = (const uint8_t*)data;
+  while (length > 0) {
+    ssize_t n = ::send(fd, p, length, MSG_NOSIGNAL);
+    if (n <= 0) return false;
+    p += n;
+    length -= n;
+  }
+  return true;
+}
+
+static bool recvAll(int fd, void* data, size_t length) {
+  uint8_t* p = (uint8_t*)data;
+  while (length > 0) {
+    ssize_t n = ::recv(fd, p, length, 0);
+    if (n <= 0) return false;
+    p += n;
+    length -= n;
+  }
+  return true;
+}
+
+static const char* statusText(int code) {
+  switch (code) {
+    case 101: return "Switching Protocols";
+    case 200: return "OK";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 413: return "Payload Too Large";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+    default: return "";
+  }
+}
+
+static void serveWebSocket(AsyncWebSocket* socket, int fd, const std::string& key) {
+  static const char magic[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+  std::string accept = key + magic;
+  uint8_t digest[20];
+  sha1((const uint8_t*)accept.data(), accept.size(), digest);
+  std::string reply = "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                      "Sec-WebSocket-Accept: " + base64(digest, 20) + "\r\n\r\n";
+  if (!sendAll(fd, reply.data(), reply.size())) return;
+
+  AsyncWebSocketClient* client = socket->accept(
+    [fd](AwsFrameType opcode, const uint8_t* data, size_t len) {
+      uint8_t head[10];
+      size_t headLen = 2;
+      head[0] = 0x80 | opcode;
+      if (len < 126) {
+        head[1] = len;
+      } else if (len < 65536) {
+        head[1] = 126;
+        head[2] = len >> 8;
+        head[3] = len;
+        headLen = 4;
+      } else {
+        head[1] = 127;
+        for (int i = 0; i < 8; i++) head[2 + i] = (uint64_t)len >> (56 - i * 8);
+        headLen = 10;
+      }
+      return sendAll(fd, head, headLen) && sendAll(fd, data, len);
+    },
+    true);
+
+  std::vector<uint8_t> payload;
+  while (client->status() == WS_CONNECTED) {
+    uint8_t head[2];
+    if (!recvAll(fd, head, 2)) break;
+    uint8_t opcode = head[0] & 0x0f;
+    uint64_t len = head[1] & 0x7f;
+    if (len == 126) {
+      uint8_t ext[2];
+      if (!recvAll(fd, ext, 2)) break;
+      len = ext[0] << 8 | ext[1];
+    } else if (len == 127) {
+      uint8_t ext[8];
+      if (!recvAll(fd, ext, 8)) break;
+      len = 0;
+      for (int i = 0; i < 8; i++) len = len << 8 | ext[i];
+    }
+    if (len > 65536) break;
+
+    uint8_t mask[4] = {};
+    if ((head[1] & 0x80) && !recvAll(fd, mask, 4)) break;
+    payload.resize(len);
+    if (len > 0 && !recvAll(fd, payload.data(), len)) break;
+    for (size_t i = 0; i < len; i++) payload[i] ^= mask[i % 4];
+
+    if (opcode == WS_DISCONNECT) break;
+    if (opcode == WS_PING) {
+      uint8_t pong[2] = { 0x80 | WS_PONG, 0 };
+      sendAll(fd, pong, 2);
+    } else if (opcode == WS_TEXT || opcode == WS_BINARY) {
+      socket->receive(client, (AwsFrameType)opcode, payload.data(), payload.size());
+    }
+  }
+
+  socket->disconnected(client);
+}
+
+static void serveConnection(AsyncWebServer* server, int fd) {
+  std::string head;
+  char c;
+  while (head.size() < 16384 && head.find("\r\n\r\n") == std::string::npos) {
+    if (::recv(fd, &c, 1, 0) != 1) {
+      ::close(fd);
+      return;
+    }
+    head += c;
+  }
+
+  char method[16] = "", target[2048] = "";
+  sscanf(head.c_str(), "%15s %2047s", method, target);
+
+  std::vector<std::pair<std::string, std::string>> headers;
+  size_t contentLength = 0;
+  size_t line = head.find("\r\n") + 2;
+  while (line < head.size()) {
+    size_t end = head.find("\r\n", line);
+    if (end == std::string::npos || end == line) break;
+    std::string text = head.substr(line, end - line);
+    size_t colon = text.find(':');
+    if (colon != std::string::npos) {
+      std::string name = text.substr(0, colon);
+      size_t start = text.find_first_not_of(' ', colon + 1);
+      std::string value = start == std::string::npos ? "" : text.substr(start);
+      if (strcasecmp(name.c_str(), "Content-Length") == 0) contentLength = strtoul(value.c_str(), nullptr, 10);
+      headers.emplace_back(name, value);
+    }
+    line = end + 2;
+  }
+
+  std::string body(contentLength, '\0');
+  if (contentLength > 0 && !recvAll(fd, &body[0], contentLength)) {
+    ::close(fd);
+    return;
+  }
+
+  AsyncWebServerRequest* request = buildRequest(*server, method, target, headers, contentLength);
+  AsyncWebSocket* socket = dynamic_cast<AsyncWebSocket*>(server->findHandler(request));
+  if (socket != nullptr && request->hasHeader("Sec-WebSocket-Key")) {
+    std::string key = request->header("Sec-WebSocket-Key").c_str();
+    delete request;
+    serveWebSocket(socket, fd, key);
+    ::close(fd);
+    return;
+  }
+
+  SimHttpResponse response = runRequest(*server, request, body, 1436, 1436);
+  std::string reply = "HTTP/1.1 " + std::to_string(response.code) + " " + statusText(response.code) + "\r\n";
+  if (!response.contentType.empty()) reply += "Content-Type: " + response.contentType + "\r\n";
+  for (auto& h : response.headers) reply += h.first + ": " + h.second + "\r\n";
+  reply += "Content-Length: " + std::to_string(response.body.size()) + "\r\nConnection: close\r\n\r\n";
+  if (strcmp(method, "HEAD") != 0) reply += response.body;
+  sendAll(fd, reply.data(), reply.size());
+  ::close(fd);
+}
+
+void AsyncWebServer::begin() {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  int yes = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+  sockaddr_in address = {};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_ANY);
+  address.sin_port = htons(_port);
+  if (::bind(fd, (sockaddr*)&address, sizeof(address)) != 0 || ::listen(fd, 8) != 0) {
+    Serial.printf("[web] cannot listen on port %u: %s\n", _port, strerror(errno));
+    ::close(fd);
+    return;
+  }
+  _listener = fd;
+  Serial.printf("[web] listening on http://localhost:%u/\n", _port);
+
+  std::thread([this, fd] {
+    while (1) {
+      int client = ::accept(fd, nullptr, nullptr);
+      if (client < 0) break;
+      int one = 1;
+      setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      std::thread(serveConnection, this, client).detach();
+    }
+  }).detach();
+}
+
+void AsyncWebServer::end() {
+  int fd = _listener.exchange(-1);
+  if (fd >= 0) {
+    ::shutdown(fd, SHUT_RDWR);
+    ::close(fd);
+  }
+}
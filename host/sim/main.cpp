@@ -0,0 +1,19 @@
+// Runs a sketch on the host. The loop task is this thread, everything the
+// sketch starts from setup() gets a thread of its own.
+#include <Arduino.h>
+
+#include "sim.h"
+
+#ifndef SIM_DEFAULT_MAC
+#define SIM_DEFAULT_MAC "24:0a:c4:00:00:01"
+#endif
+
+void setup();
+void loop();
+
+int main() {
+  // Each board has its own address unless SIM_MAC says otherwise
+  setenv("SIM_MAC", SIM_DEFAULT_MAC, 0);
+  simRunSketch(setup, loop);
+  return 0;
+}
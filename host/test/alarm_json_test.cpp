@@ -0,0 +1,121 @@
+// GET /alarm streams its JSON through fillAlarmJson. Whatever size the TCP
+// window hands it, from a few bytes to more than the whole body, the
+// reassembled output must be the same valid document.
+#include "esp1.cpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "sim.h"
+
+namespace {
+
+// Escaping grows these, up to the longest record the writer allows for
+const char* const LABELS[] = {
+  "",
+  "Morning run",
+  "quote \" and backslash \\",
+  "tab\tnewline\nbell\x07",
+  "caf\xc3\xa9 \xe2\x98\x95",
+  "\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"",
+  "\x01\x02\x03\x04\x05\x06\x07\x08\x0b\x0c\x0e\x0f\x10\x11\x12\x13\x14\x15\x16\x17\x18\x19\x1a\x1b\x1c\x1d\x1e\x1f\x01\x02\x03\x04",
+};
+const int LABEL_COUNT = sizeof(LABELS) / sizeof(LABELS[0]);
+
+class AlarmJson : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    webGetAlarm();
+  }
+
+  void SetUp() override {
+    alarmInit();
+  }
+
+  void addAlarms(int count) {
+    for (int i = 0; i < count; i++) {
+      AlarmEntry entry = {};
+      entry.seconds = (i * 7919) % SECONDS_PER_DAY;
+      entry.days = i % ALARM_DAYS_ALL;
+      entry.flags = i % 3 ? ALARM_ENABLED : 0;
+      strlcpy(entry.label, LABELS[i % LABEL_COUNT], sizeof(entry.label));
+      alarmSet(alarmAlloc(), entry);
+    }
+  }
+
+  SimHttpResponse get(const char* url, size_t chunk) {
+    return simHttpRequest(server, "GET", url, {}, std::string(), 1436, chunk);
+  }
+};
+
+TEST_F(AlarmJson, SameBodyForAnyChunkSize) {
+  addAlarms(ALARM_PAGE_MAX);
+  const char* url = "/alarm?start=0&limit=64";
+
+  SimHttpResponse whole = get(url, 1 << 20);
+  ASSERT_EQ(whole.code, 200);
+  ASSERT_EQ(whole.chunks, 1u);
+
+  for (size_t chunk : { 3, 64, 2000 }) {
+    SimHttpResponse response = get(url, chunk);
+    ASSERT_EQ(response.code, 200);
+    EXPECT_EQ(response.body, whole.body) << "chunk " << chunk;
+    // Every call but the last fills the buffer
+    EXPECT_EQ(response.chunks, (whole.body.size() + chunk - 1) / chunk) << "chunk " << chunk;
+  }
+}
+
+TEST_F(AlarmJson, BodyParsesBackToTheTable) {
+  addAlarms(ALARM_PAGE_MAX);
+
+  for (size_t chunk : { 3, 64, 2000 }) {
+    SimHttpResponse response = get("/alarm?start=0&limit=64", chunk);
+    std::vector<char> body(response.body.begin(), response.body.end());
+    static StaticJsonDocument<24 * 1024> json;
+    ASSERT_FALSE(deserializeJson(json, body.data(), body.size())) << response.body;
+
+    JsonVariant alarms = json["alarms"];
+    ASSERT_EQ(alarms.size(), (size_t)ALARM_PAGE_MAX);
+    for (int i = 0; i < ALARM_PAGE_MAX; i++) {
+      JsonVariant alarm = alarms[i];
+      EXPECT_EQ(alarm["id"].as<int>(), i);
+      EXPECT_EQ(parseAlarmTime(alarm["time"] | ""), (i * 7919u) % SECONDS_PER_DAY);
+      EXPECT_EQ(alarm["days"].as<int>(), i % ALARM_DAYS_ALL);
+      EXPECT_EQ(alarm["enabled"].as<bool>(), i % 3 != 0);
+      EXPECT_STREQ(alarm["label"] | "?", LABELS[i % LABEL_COUNT]) << "alarm " << i;
+    }
+    EXPECT_EQ(json["count"].as<int>(), ALARM_PAGE_MAX);
+    EXPECT_EQ(json["next"].as<int>(), -1);
+  }
+}
+
+TEST_F(AlarmJson, PagesSkipFreeSlotsAndPointAtTheNext) {
+  addAlarms(40);
+  // A hole early in the table
+  alarmClear(5);
+  alarmFree(5);
+
+  SimHttpResponse first = get("/alarm?start=0&limit=32", 3);
+  std::vector<char> body(first.body.begin(), first.body.end());
+  static StaticJsonDocument<24 * 1024> json;
+  ASSERT_FALSE(deserializeJson(json, body.data(), body.size()));
+  ASSERT_EQ(json["alarms"].size(), 32u);
+  EXPECT_EQ(json["alarms"][5]["id"].as<int>(), 6);
+  EXPECT_EQ(json["count"].as<int>(), 39);
+  EXPECT_EQ(json["next"].as<int>(), 33);
+
+  SimHttpResponse second = get("/alarm?start=33&limit=32", 64);
+  body.assign(second.body.begin(), second.body.end());
+  ASSERT_FALSE(deserializeJson(json, body.data(), body.size()));
+  EXPECT_EQ(json["alarms"].size(), 7u);
+  EXPECT_EQ(json["next"].as<int>(), -1);
+}
+
+TEST_F(AlarmJson, EmptyTable) {
+  SimHttpResponse response = get("/alarm", 3);
+  EXPECT_EQ(response.body, "{\"alarms\":[],\"count\":0,\"next\":-1,\"revision\":" + std::to_string(alarmRevision) + "}");
+}
+
+}  // namespace
@@ -0,0 +1,249 @@
+// Alarm scheduler: next-fire math across days, weekday masks and UTC
+// offsets, the min-heap order, alarmFireDue driven by a fake clock, and
+// the label arena.
+#include "esp1.cpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sim.h"
+
+namespace {
+
+// 2023-11-14 22:13:20 UTC, a Tuesday; 05:13:20 Wednesday at UTC+7
+const time_t START = 1700000000;
+
+const uint8_t SUNDAY = 1 << 0;
+const uint8_t TUESDAY = 1 << 2;
+const uint8_t WEDNESDAY = 1 << 3;
+const uint8_t SATURDAY = 1 << 6;
+
+class Alarm : public ::testing::Test {
+protected:
+  void SetUp() override {
+    clockUtcOffset = 7 * 3600;
+    alarmInit();
+    alarmHeapSize = 0;
+    alarmCheckedThrough = 0;
+    simSetWallClock((int64_t)START * 1000000);
+  }
+
+  int add(const char* time, uint8_t days, bool enabled = true) {
+    AlarmEntry entry = {};
+    entry.seconds = parseAlarmTime(time);
+    entry.days = days;
+    entry.flags = enabled ? ALARM_ENABLED : 0;
+    int slot = alarmAlloc();
+    alarmSet(slot, entry);
+    return slot;
+  }
+
+  // Runs the scheduler once a second up to until, the way the task would
+  // after each wakeup, and returns what fired with the second it fired at
+  std::vector<std::pair<time_t, AlarmFired>> runUntil(time_t until) {
+    std::vector<std::pair<time_t, AlarmFired>> result;
+    for (time_t now = time(NULL); now <= until; now++) {
+      simSetWallClock((int64_t)now * 1000000);
+      AlarmFired fired[ALARM_FIRE_BATCH];
+      int count = alarmFireDue(time(NULL), fired, ALARM_FIRE_BATCH);
+      for (int i = 0; i < count; i++) result.push_back({ now, fired[i] });
+    }
+    return result;
+  }
+};
+
+TEST_F(Alarm, NextFireIsLaterTodayOrTomorrow) {
+  EXPECT_EQ(alarmNextFire(parseAlarmTime("06:00"), 0, START), START + 46 * 60 + 40);
+  EXPECT_EQ(alarmNextFire(parseAlarmTime("05:13:20"), 0, START), START);
+  EXPECT_EQ(alarmNextFire(parseAlarmTime("05:00"), 0, START), START - 800 + SECONDS_PER_DAY);
+}
+
+TEST_F(Alarm, NextFireFollowsTheWeekdayMask) {
+  EXPECT_EQ(alarmNextFire(parseAlarmTime("06:00"), WEDNESDAY, START), START + 2800);
+  EXPECT_EQ(alarmNextFire(parseAlarmTime("06:00"), SATURDAY, START), START + 2800 + 3 * SECONDS_PER_DAY);
+  EXPECT_EQ(alarmNextFire(parseAlarmTime("06:00"), SUNDAY | SATURDAY, START), START + 2800 + 3 * SECONDS_PER_DAY);
+  // Passed today, so a week from now
+  EXPECT_EQ(alarmNextFire(parseAlarmTime("05:00"), WEDNESDAY, START), START - 800 + 7 * SECONDS_PER_DAY);
+}
+
+TEST_F(Alarm, NextFireUsesTheLocalDay) {
+  // Still Tuesday 17:13:20 at UTC-5
+  clockUtcOffset = -5 * 3600;
+  EXPECT_EQ(alarmNextFire(parseAlarmTime("06:00"), WEDNESDAY, START), START + 12 * 3600 + 46 * 60 + 40);
+  EXPECT_EQ(alarmNextFire(parseAlarmTime("18:00"), WEDNESDAY, START), START + 2800 + SECONDS_PER_DAY);
+  EXPECT_EQ(alarmNextFire(parseAlarmTime("18:00"), TUESDAY, START), START + 2800);
+}
+
+TEST_F(Alarm, HeapPopsInFireOrder) {
+  std::mt19937 random(1);
+  for (int i = 0; i < MAX_ALARM; i++) {
+    // Plenty of ties, the heap must still hand back every slot
+    alarmFireAt[i] = START + random() % 500;
+    alarmHeapPush(i);
+  }
+
+  std::vector<uint16_t> popped;
+  while (alarmHeapSize > 0) {
+    uint16_t slot = alarmHeapPop();
+    if (!popped.empty()) {
+      EXPECT_LE(alarmFireAt[popped.back()], alarmFireAt[slot]);
+    }
+    popped.push_back(slot);
+  }
+
+  std::sort(popped.begin(), popped.end());
+  ASSERT_EQ(popped.size(), (size_t)MAX_ALARM);
+  for (int i = 0; i < MAX_ALARM; i++) EXPECT_EQ(popped[i], i);
+}
+
+TEST_F(Alarm, HeapKeepsOrderWhenRefilledWhilePopping) {
+  std::mt19937 random(2);
+  for (int i = 0; i < 64; i++) {
+    alarmFireAt[i] = START + random() % 10000;
+    alarmHeapPush(i);
+  }
+
+  // Pop and push back later, as a repeating alarm is rescheduled
+  time_t last = 0;
+  for (int round = 0; round < 1000; round++) {
+    uint16_t slot = alarmHeapPop();
+    EXPECT_LE(last, alarmFireAt[slot]);
+    last = alarmFireAt[slot];
+    alarmFireAt[slot] = last + 1 + random() % 10000;
+    alarmHeapPush(slot);
+  }
+  EXPECT_EQ(alarmHeapSize, 64);
+}
+
+TEST_F(Alarm, FiresOnTheSecondAndReschedulesRepeats) {
+  int once = add("05:14", 0);
+  int daily = add("05:15", ALARM_DAYS_ALL);
+  add("05:14:30", 0, false);
+  alarmScheduleAll(time(NULL));
+  ASSERT_EQ(alarmHeapSize, 2);
+
+  auto fired = runUntil(START + 300);
+  ASSERT_EQ(fired.size(), 2u);
+
+  EXPECT_EQ(fired[0].first, START + 40);
+  EXPECT_EQ(fired[0].second.slot, once);
+  EXPECT_TRUE(fired[0].second.ring);
+  EXPECT_NE(fired[0].second.revision, 0u);
+  EXPECT_FALSE(alarmLists[once].flags & ALARM_ENABLED);
+
+  EXPECT_EQ(fired[1].first, START + 100);
+  EXPECT_EQ(fired[1].second.slot, daily);
+  EXPECT_TRUE(fired[1].second.ring);
+  EXPECT_EQ(fired[1].second.revision, 0u);
+
+  // Only the repeating alarm is left, due the same time tomorrow
+  ASSERT_EQ(alarmHeapSize, 1);
+  EXPECT_EQ(alarmFireAt[alarmHeap[0]], START + 100 + SECONDS_PER_DAY);
+  EXPECT_EQ(alarmCheckedThrough, START + 300);
+}
+
+TEST_F(Alarm, LateWakeupWithinGraceStillRings) {
+  add("05:14", ALARM_DAYS_ALL);
+  alarmScheduleAll(time(NULL));
+
+  time_t now = START + 40 + ALARM_GRACE_SEC;
+  AlarmFired fired[ALARM_FIRE_BATCH];
+  ASSERT_EQ(alarmFireDue(now, fired, ALARM_FIRE_BATCH), 1);
+  EXPECT_TRUE(fired[0].ring);
+}
+
+TEST_F(Alarm, ForwardStepRingsWhatItJumpedOver) {
+  // Handled through START, then SNTP steps the clock 30 min ahead
+  int once = add("05:30", 0);
+  int daily = add("05:40", ALARM_DAYS_ALL);
+  alarmCheckedThrough = START;
+  alarmScheduleAll(alarmCheckedThrough + 1);
+
+  time_t now = START + 30 * 60;
+  AlarmFired fired[ALARM_FIRE_BATCH];
+  ASSERT_EQ(alarmFireDue(now, fired, ALARM_FIRE_BATCH), 2);
+  EXPECT_EQ(fired[0].slot, once);
+  EXPECT_TRUE(fired[0].ring);
+  EXPECT_NE(fired[0].revision, 0u);
+  EXPECT_FALSE(alarmLists[once].flags & ALARM_ENABLED);
+  EXPECT_EQ(fired[1].slot, daily);
+  EXPECT_TRUE(fired[1].ring);
+
+  // Nothing rings twice afterwards
+  ASSERT_EQ(alarmHeapSize, 1);
+  EXPECT_EQ(alarmFireAt[alarmHeap[0]], START + 1600 + SECONDS_PER_DAY);
+  EXPECT_EQ(alarmFireDue(now + 1, fired, ALARM_FIRE_BATCH), 0);
+}
+
+TEST_F(Alarm, HandledSecondReplayedLateDoesNotRing) {
+  // A second already handled, reached again long after it
+  add("05:14", ALARM_DAYS_ALL);
+  alarmScheduleAll(time(NULL));
+  alarmCheckedThrough = START + 40;
+
+  AlarmFired fired[ALARM_FIRE_BATCH];
+  ASSERT_EQ(alarmFireDue(START + 41 + ALARM_GRACE_SEC, fired, ALARM_FIRE_BATCH), 1);
+  EXPECT_FALSE(fired[0].ring);
+}
+
+TEST_F(Alarm, FullBatchLeavesTheRestForTheNextCall) {
+  for (int i = 0; i < ALARM_FIRE_BATCH + 3; i++) add("05:14", ALARM_DAYS_ALL);
+  alarmScheduleAll(time(NULL));
+
+  AlarmFired fired[ALARM_FIRE_BATCH];
+  EXPECT_EQ(alarmFireDue(START + 40, fired, ALARM_FIRE_BATCH), ALARM_FIRE_BATCH);
+  // Not yet through START + 40, the next call picks up the rest
+  EXPECT_LT(alarmCheckedThrough, START + 40);
+  EXPECT_EQ(alarmFireDue(START + 40, fired, ALARM_FIRE_BATCH), 3);
+  EXPECT_EQ(alarmCheckedThrough, START + 40);
+}
+
+// Full-length labels, different enough that a misplaced move shows
+std::string label(int n) {
+  std::string text = "label " + std::to_string(n) + " ";
+  while (text.size() < ALARM_LABEL_MAX_LEN) text += (char)('a' + (n + text.size()) % 26);
+  return text;
+}
+
+TEST_F(Alarm, FullArenaCompactsWithoutMovingAnyLabelsText) {
+  const int LABELS = ALARM_LABEL_ARENA / ALARM_LABEL_MAX_LEN - 8;
+  std::vector<std::pair<int, std::string>> alarms;
+  for (int i = 0; i < LABELS; i++) {
+    AlarmEntry entry = {};
+    entry.seconds = i * 60;
+    strcpy(entry.label, label(i).c_str());
+    int slot = alarmAlloc();
+    ASSERT_TRUE(alarmSet(slot, entry));
+    alarms.push_back({ slot, entry.label });
+  }
+
+  // Every other label released leaves the arena full of holes
+  std::vector<std::pair<int, std::string>> kept;
+  for (size_t i = 0; i < alarms.size(); i++) {
+    if (i % 2 == 0) alarmClear(alarms[i].first);
+    else kept.push_back(alarms[i]);
+  }
+
+  // Only fits once the holes are squeezed out
+  for (int i = LABELS; i < LABELS + 40; i++) {
+    AlarmEntry entry = {};
+    entry.seconds = i * 60;
+    strcpy(entry.label, label(i).c_str());
+    int slot = alarmAlloc();
+    ASSERT_TRUE(alarmSet(slot, entry)) << i;
+    kept.push_back({ slot, entry.label });
+  }
+
+  EXPECT_EQ(alarmLabelArenaUsed, kept.size() * ALARM_LABEL_MAX_LEN);
+  for (const std::pair<int, std::string>& alarm : kept) {
+    AlarmEntry entry;
+    ASSERT_TRUE(alarmGet(alarm.first, entry));
+    EXPECT_EQ(entry.label, alarm.second) << "slot " << alarm.first;
+  }
+}
+
+}  // namespace
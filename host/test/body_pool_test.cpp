@@ -0,0 +1,130 @@
+// POST bodies go through the fixed slot pool: chunked bodies reassemble,
+// oversize and excess requests are refused with a status, every way a
+// request ends gives its slot back, and a long add/delete soak leaves the
+// heap where it started.
+#include "esp1.cpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "sim.h"
+
+namespace {
+
+class BodyPool : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    webAddAlarm();
+    webDeleteAlarm();
+  }
+
+  void SetUp() override {
+    alarmInit();
+    requestBodiesRejected = 0;
+  }
+
+  static int freeSlots() {
+    int count = 0;
+    for (int i = 0; i < BODY_SLOTS; i++) count += requestBodies[i].owner == NULL;
+    return count;
+  }
+
+  static SimHttpResponse post(const char* url, const std::string& body, size_t chunk = 1436) {
+    return simHttpRequest(server, "POST", url, { { "Content-Type", "application/json" } }, body, chunk);
+  }
+
+  // A request whose first chunk has arrived, the rest still on the wire
+  static std::unique_ptr<AsyncWebServerRequest> started(const std::string& body) {
+    std::unique_ptr<AsyncWebServerRequest> request(new AsyncWebServerRequest(&server, HTTP_POST, "/alarm"));
+    request->setContentLength(body.size());
+    bodyAppend(request.get(), (uint8_t*)body.data(), 1, 0, body.size());
+    return request;
+  }
+};
+
+const std::string ALARM = "{\"time\":\"06:30\",\"label\":\"Morning run\",\"days\":62}";
+
+TEST_F(BodyPool, ReassemblesBodiesInAnyChunkSize) {
+  for (size_t chunk : { (size_t)1, (size_t)3, (size_t)16, ALARM.size() }) {
+    SimHttpResponse response = post("/alarm", ALARM, chunk);
+    ASSERT_EQ(response.code, 200) << "chunk " << chunk;
+
+    int id = atoi(response.body.c_str() + strlen("{\"id\":"));
+    AlarmEntry entry;
+    ASSERT_TRUE(alarmGet(id, entry));
+    EXPECT_STREQ(entry.label, "Morning run");
+    EXPECT_EQ(entry.days, 62);
+    EXPECT_EQ(freeSlots(), BODY_SLOTS);
+  }
+}
+
+TEST_F(BodyPool, OversizeBodyIsRefusedAndFreesItsSlot) {
+  std::string body = "{\"time\":\"06:30\",\"label\":\"" + std::string(BODY_MAX, 'x') + "\"}";
+  SimHttpResponse response = post("/alarm", body, 100);
+  EXPECT_EQ(response.code, 413);
+  EXPECT_EQ(requestBodiesRejected, 1u);
+  EXPECT_EQ(freeSlots(), BODY_SLOTS);
+
+  // Exactly BODY_MAX still fits
+  std::string padded = ALARM;
+  padded.insert(padded.size() - 1, std::string(BODY_MAX - ALARM.size(), ' '));
+  ASSERT_EQ(padded.size(), (size_t)BODY_MAX);
+  EXPECT_EQ(post("/alarm", padded, 100).code, 200);
+}
+
+TEST_F(BodyPool, RequestsBeyondThePoolGet503) {
+  std::vector<std::unique_ptr<AsyncWebServerRequest>> inFlight;
+  for (int i = 0; i < BODY_SLOTS; i++) inFlight.push_back(started(ALARM));
+  EXPECT_EQ(freeSlots(), 0);
+
+  SimHttpResponse response = post("/alarm", ALARM);
+  EXPECT_EQ(response.code, 503);
+  EXPECT_EQ(requestBodiesRejected, 1u);
+
+  // One of them finishes, the next request gets its slot
+  inFlight.pop_back();
+  EXPECT_EQ(freeSlots(), 1);
+  EXPECT_EQ(post("/alarm", ALARM).code, 200);
+}
+
+TEST_F(BodyPool, AbandonedRequestGivesItsSlotBack) {
+  // The client goes away halfway through the body
+  std::unique_ptr<AsyncWebServerRequest> request = started(ALARM);
+  EXPECT_EQ(freeSlots(), BODY_SLOTS - 1);
+  request.reset();
+  EXPECT_EQ(freeSlots(), BODY_SLOTS);
+}
+
+TEST_F(BodyPool, OutOfOrderChunkIsABadRequest) {
+  std::unique_ptr<AsyncWebServerRequest> request = started(ALARM);
+  EXPECT_EQ(bodyAppend(request.get(), (uint8_t*)ALARM.data() + 5, ALARM.size() - 5, 5, ALARM.size()), nullptr);
+  EXPECT_EQ(bodyTake(request.get()), -400);
+  EXPECT_EQ(freeSlots(), BODY_SLOTS);
+}
+
+TEST_F(BodyPool, AddDeleteSoakKeepsTheHeapFlat) {
+  auto cycle = [](int i) {
+    std::string label = "soak " + std::to_string(i % 1000);
+    SimHttpResponse added = post("/alarm", "{\"time\":\"07:00\",\"label\":\"" + label + "\",\"days\":127}", 1 + i % 64);
+    if (added.code != 200) return false;
+    int id = atoi(added.body.c_str() + strlen("{\"id\":"));
+    return post("/delete", "{\"index\":" + std::to_string(id) + "}", 1 + i % 7).code == 200;
+  };
+
+  // Lets the host allocator settle before measuring
+  for (int i = 0; i < 1000; i++) ASSERT_TRUE(cycle(i));
+  uint32_t before = ESP.getFreeHeap();
+
+  for (int i = 0; i < 100000; i++) ASSERT_TRUE(cycle(i)) << "cycle " << i;
+
+  EXPECT_EQ(alarmCount, 0);
+  EXPECT_EQ(freeSlots(), BODY_SLOTS);
+  EXPECT_EQ(requestBodiesRejected, 0u);
+  // Host allocator bookkeeping only, no per-request growth
+  EXPECT_GE(ESP.getFreeHeap() + 1024, before);
+}
+
+}  // namespace
@@ -0,0 +1,136 @@
+// ESP2 channel discovery: channelScanStep driven against a simulated
+// radio, where ESP1 sits on one channel and answers a probe sent on that
+// channel after some latency, and may lose probes or ACKs.
+#include "esp2.cpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+namespace {
+
+struct SimulatedRadio {
+  uint8_t apChannel;            // ESP1's channel, 0 = ESP1 is off
+  unsigned long latencyMs = 8;  // probe to ACK
+  double lossRate = 0;          // probe or ACK lost
+  std::mt19937 random{ 1 };
+
+  uint8_t acked = 0;
+  uint8_t pendingChannel = 0;
+  unsigned long pendingAt = 0;
+
+  void probe(uint8_t channel, unsigned long now) {
+    if (channel != apChannel) return;
+    if (std::uniform_real_distribution<>(0, 1)(random) < lossRate) return;
+    pendingChannel = channel;
+    pendingAt = now + latencyMs;
+  }
+
+  // What OnDataRecv would have stored in ackChannel by now
+  uint8_t ackChannel(unsigned long now) {
+    if (pendingChannel != 0 && now >= pendingAt) {
+      acked = pendingChannel;
+      pendingChannel = 0;
+    }
+    return acked;
+  }
+};
+
+struct ScanResult {
+  bool locked;
+  uint8_t channel;
+  uint16_t probes;
+  unsigned long elapsedMs;
+};
+
+// Steps the scan every 5 ms, as scanBlocking() does, for at most limitMs
+ScanResult runScan(SimulatedRadio& radio, uint8_t firstChannel, unsigned long limitMs) {
+  ChannelScan scan;
+  channelScanStart(scan, firstChannel);
+
+  unsigned long now = 1000;
+  const unsigned long start = now;
+  while (scan.state == SCAN_PROBING && now - start < limitMs) {
+    uint8_t channel = channelScanStep(scan, now, radio.ackChannel(now));
+    if (channel != 0) radio.probe(channel, now);
+    now += 5;
+  }
+  return { scan.state == SCAN_LOCKED, scan.channel, scan.probed, now - start };
+}
+
+TEST(ChannelScan, CachedChannelLocksOnTheFirstProbe) {
+  for (uint8_t channel = 1; channel <= 14; channel++) {
+    SimulatedRadio radio{ channel };
+    ScanResult result = runScan(radio, channel, 60000);
+    ASSERT_TRUE(result.locked);
+    EXPECT_EQ(result.channel, channel);
+    EXPECT_EQ(result.probes, 1);
+    EXPECT_LT(result.elapsedMs, (unsigned long)PROBE_DWELL_MS);
+  }
+}
+
+TEST(ChannelScan, StaleCacheLocksWithinOneRound) {
+  for (uint8_t from = 1; from <= 14; from++) {
+    for (uint8_t to = 1; to <= 14; to++) {
+      SimulatedRadio radio{ to };
+      ScanResult result = runScan(radio, from, 60000);
+      ASSERT_TRUE(result.locked) << (int)from << " -> " << (int)to;
+      EXPECT_EQ(result.channel, to);
+
+      // Channels are walked upwards and wrap from 14 to 1
+      int hops = (to - from + 14) % 14;
+      EXPECT_EQ(result.probes, hops + 1) << (int)from << " -> " << (int)to;
+      EXPECT_LE(result.elapsedMs, hops * PROBE_DWELL_MS + radio.latencyMs + 10);
+    }
+  }
+}
+
+TEST(ChannelScan, BacksOffAfterARoundWithoutAnswer) {
+  SimulatedRadio radio{ 0 };
+  ChannelScan scan;
+  channelScanStart(scan, 6);
+
+  unsigned long now = 1000;
+  unsigned long lastProbe = 0;
+  int probes = 0;
+  for (; probes < 3 * 14; now += 5) {
+    uint8_t channel = channelScanStep(scan, now, radio.ackChannel(now));
+    if (channel == 0) continue;
+
+    // After each full round the next probe waits for the backoff
+    if (probes > 0) {
+      unsigned long gap = now - lastProbe;
+      if (probes % 14 == 0) {
+        EXPECT_GE(gap, (unsigned long)PROBE_ROUND_BACKOFF_MS);
+      } else {
+        EXPECT_GE(gap, (unsigned long)PROBE_DWELL_MS);
+        EXPECT_LT(gap, (unsigned long)PROBE_DWELL_MS + 10);
+      }
+    }
+    EXPECT_EQ(channel, (6 - 1 + probes) % 14 + 1);
+    lastProbe = now;
+    probes++;
+  }
+  EXPECT_EQ(scan.state, SCAN_PROBING);
+}
+
+TEST(ChannelScan, LossyLinkStillLocks) {
+  SimulatedRadio radio{ 11 };
+  radio.lossRate = 0.5;
+  for (int attempt = 0; attempt < 50; attempt++) {
+    radio.acked = 0;
+    ScanResult result = runScan(radio, 1 + attempt % 14, 60000);
+    ASSERT_TRUE(result.locked);
+    EXPECT_EQ(result.channel, 11);
+  }
+}
+
+TEST(ChannelScan, LateAckForAnEarlierChannelDoesNotLock) {
+  // The ACK for channel 3 lands after the scan has moved to 4
+  SimulatedRadio radio{ 3 };
+  radio.latencyMs = PROBE_DWELL_MS + 20;
+  ScanResult result = runScan(radio, 3, 2 * PROBE_DWELL_MS);
+  EXPECT_FALSE(result.locked);
+}
+
+}  // namespace
@@ -0,0 +1,160 @@
+// clock_log.h ring under several concurrent writers and one reader that
+// keeps getting lapped: every record the reader accepts is whole, each
+// writer's records come back in order, and whatever was not read was
+// counted as skipped.
+#include "clock_log.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int WRITERS = 4;
+const uint32_t PER_WRITER = 200000;
+
+// Ties the text to its writer and count, so a record mixed from two
+// writes does not check out
+uint32_t tag(uint32_t writer, uint32_t n) {
+  uint32_t x = writer * 0x9e3779b9u ^ n * 0x85ebca6bu;
+  return x ^ x >> 15;
+}
+
+void write(uint32_t writer, uint32_t n) {
+  // Padding varies the length, so a torn record also shows in length
+  logWrite(LOG_LEVEL_INFO, "w%lu n%lu t%08lx %.*s", (unsigned long)writer, (unsigned long)n,
+           (unsigned long)tag(writer, n), (int)(n % 40), "........................................");
+}
+
+// False when the record is not exactly what one write produced
+bool whole(const LogLine& line, uint32_t& writer, uint32_t& n) {
+  unsigned long w, count, t;
+  int end = 0;
+  if (sscanf(line.text, "w%lu n%lu t%08lx %n", &w, &count, &t, &end) != 3 || end == 0) return false;
+  if (w >= WRITERS || t != tag(w, count)) return false;
+  if (line.length != end + count % 40 || strlen(line.text) != line.length) return false;
+  for (size_t i = end; i < line.length; i++) {
+    if (line.text[i] != '.') return false;
+  }
+  writer = w;
+  n = count;
+  return true;
+}
+
+TEST(ClockLog, ConcurrentWritersLapTheReaderWithoutTearing) {
+  uint32_t cursor = logHead.load();
+
+  std::atomic<int> running(WRITERS);
+  std::vector<std::thread> writers;
+  for (uint32_t w = 0; w < WRITERS; w++) {
+    writers.emplace_back([w, &running] {
+      for (uint32_t n = 0; n < PER_WRITER; n++) write(w, n);
+      running--;
+    });
+  }
+
+  uint64_t read = 0, skipped = 0;
+  int64_t last[WRITERS];
+  for (int w = 0; w < WRITERS; w++) last[w] = -1;
+
+  auto drain = [&] {
+    LogLine line;
+    uint32_t missed = 0;
+    while (logRead(cursor, line, &missed)) {
+      uint32_t writer, n;
+      ASSERT_TRUE(whole(line, writer, n)) << "torn record: " << std::string(line.text, line.length);
+      ASSERT_GT((int64_t)n, last[writer]) << "writer " << writer;
+      last[writer] = n;
+      read++;
+    }
+    skipped += missed;
+  };
+
+  while (running > 0) {
+    drain();
+    if (HasFatalFailure()) break;
+  }
+  for (std::thread& t : writers) t.join();
+  drain();
+
+  // Nothing is in flight any more, so the reader reaches the head and
+  // every position was either read or skipped
+  EXPECT_EQ(cursor, logHead.load());
+  EXPECT_EQ(read + skipped, (uint64_t)WRITERS * PER_WRITER);
+  EXPECT_GT(read, 0u);
+  EXPECT_GT(skipped, 0u);
+}
+
+// A writer preempted between claiming its position and publishing it,
+// while the others go a whole lap round the ring
+TEST(ClockLog, WriterLappedMidCopyNeitherStallsNorTearsTheReader) {
+  uint32_t cursor = logHead.load();
+  uint32_t pos = logHead.fetch_add(1);
+  LogLineSlot* slot = logSlotClaim(pos);
+  ASSERT_NE(slot, nullptr);
+
+  for (uint32_t n = 0; n < LOG_RING_SLOTS; n++) write(1, n);
+  memset(slot->record.text, '#', 20);  // the late copy lands on the newer record
+  logSlotPublish(*slot, pos);
+
+  LogLine line;
+  uint32_t skipped = 0, read = 0;
+  while (logRead(cursor, line, &skipped)) {
+    uint32_t writer, n;
+    ASSERT_TRUE(whole(line, writer, n)) << std::string(line.text, line.length);
+    read++;
+  }
+  EXPECT_EQ(cursor, logHead.load());
+  EXPECT_EQ(read + skipped, LOG_RING_SLOTS + 1u);
+  // The stuck record fell off the ring, the one it overwrote is skipped
+  EXPECT_EQ(skipped, 2u);
+
+  // The slot takes its next lap as usual
+  for (uint32_t n = 0; n < LOG_RING_SLOTS; n++) write(2, n);
+  skipped = read = 0;
+  while (logRead(cursor, line, &skipped)) read++;
+  EXPECT_EQ(read, (uint32_t)LOG_RING_SLOTS);
+  EXPECT_EQ(skipped, 0u);
+}
+
+TEST(ClockLog, WriterLappedBeforeItsClaimDropsItsRecord) {
+  uint32_t cursor = logHead.load();
+  uint32_t pos = logHead.fetch_add(1);
+  for (uint32_t n = 0; n < LOG_RING_SLOTS; n++) write(1, n);
+  EXPECT_EQ(logSlotClaim(pos), nullptr);
+
+  LogLine line;
+  uint32_t skipped = 0, read = 0;
+  while (logRead(cursor, line, &skipped)) read++;
+  EXPECT_EQ(read, (uint32_t)LOG_RING_SLOTS);
+  EXPECT_EQ(skipped, 1u);
+}
+
+TEST(ClockLog, ReaderThatKeepsUpSkipsNothing) {
+  uint32_t cursor = logHead.load();
+  LogLine line;
+  uint32_t skipped = 0;
+
+  // Two writers, never more than the ring ahead of the reader
+  uint32_t n = 0;
+  for (int round = 0; round < 1000; round++) {
+    std::thread a([n] { for (uint32_t i = 0; i < LOG_RING_SLOTS / 4; i++) write(0, n + i); });
+    std::thread b([n] { for (uint32_t i = 0; i < LOG_RING_SLOTS / 4; i++) write(1, n + i); });
+    a.join();
+    b.join();
+    n += LOG_RING_SLOTS / 4;
+
+    int count = 0;
+    while (logRead(cursor, line, &skipped)) {
+      uint32_t writer, index;
+      ASSERT_TRUE(whole(line, writer, index));
+      count++;
+    }
+    ASSERT_EQ(count, LOG_RING_SLOTS / 2);
+  }
+  EXPECT_EQ(skipped, 0u);
+}
+
+}  // namespace
@@ -0,0 +1,116 @@
+// GET / serves the pre-gzipped page with its ETag and answers a matching
+// If-None-Match with an empty 304, so a reload costs headers only. The
+// page loads nothing from outside the clock: it has to work on the
+// captive AP, where there is no internet.
+#include "esp1.cpp"
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+
+#include <regex>
+#include <string>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "sim.h"
+
+namespace {
+
+class Dashboard : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    webDashboard();
+  }
+};
+
+// Size of the uncompressed member, from the gzip trailer (ISIZE)
+uint32_t gzipInflatedSize(const std::string& body) {
+  const uint8_t* tail = (const uint8_t*)body.data() + body.size() - 4;
+  return tail[0] | tail[1] << 8 | tail[2] << 16 | (uint32_t)tail[3] << 24;
+}
+
+TEST_F(Dashboard, SendsTheGzippedPageWithItsETag) {
+  SimHttpResponse page = simHttpRequest(server, "GET", "/");
+  ASSERT_EQ(page.code, 200);
+  EXPECT_EQ(page.contentType, "text/html");
+  ASSERT_NE(page.header("Content-Encoding"), nullptr);
+  EXPECT_EQ(*page.header("Content-Encoding"), "gzip");
+  ASSERT_NE(page.header("ETag"), nullptr);
+  EXPECT_EQ(*page.header("ETag"), DASHBOARD_HTML_GZ_ETAG);
+
+  ASSERT_EQ(page.body.size(), DASHBOARD_HTML_GZ_LEN);
+  EXPECT_EQ(memcmp(page.body.data(), DASHBOARD_HTML_GZ, DASHBOARD_HTML_GZ_LEN), 0);
+  EXPECT_EQ((uint8_t)page.body[0], 0x1f);
+  EXPECT_EQ((uint8_t)page.body[1], 0x8b);
+}
+
+TEST_F(Dashboard, WireBytesAreAFractionOfTheSource) {
+  struct stat source;
+  ASSERT_EQ(stat(REPO_ROOT "/dashboard.html", &source), 0);
+
+  // Minified below the source, and gzip below a third of that
+  uint32_t inflated = gzipInflatedSize(std::string((const char*)DASHBOARD_HTML_GZ, DASHBOARD_HTML_GZ_LEN));
+  EXPECT_LT(inflated, (uint32_t)source.st_size);
+  EXPECT_LT(DASHBOARD_HTML_GZ_LEN * 3, inflated);
+}
+
+TEST_F(Dashboard, RevalidationWithTheSameETagIsAnEmpty304) {
+  SimHttpResponse page = simHttpRequest(server, "GET", "/", { { "If-None-Match", DASHBOARD_HTML_GZ_ETAG } });
+  EXPECT_EQ(page.code, 304);
+  EXPECT_TRUE(page.body.empty());
+  ASSERT_NE(page.header("ETag"), nullptr);
+  EXPECT_EQ(*page.header("ETag"), DASHBOARD_HTML_GZ_ETAG);
+
+  // A list of validators, one of them current
+  page = simHttpRequest(server, "GET", "/", { { "If-None-Match", "\"0000\", " DASHBOARD_HTML_GZ_ETAG } });
+  EXPECT_EQ(page.code, 304);
+
+  page = simHttpRequest(server, "GET", "/", { { "If-None-Match", "*" } });
+  EXPECT_EQ(page.code, 304);
+}
+
+TEST_F(Dashboard, StaleETagGetsTheFullPage) {
+  SimHttpResponse page = simHttpRequest(server, "GET", "/", { { "If-None-Match", "\"0000000000000000\"" } });
+  EXPECT_EQ(page.code, 200);
+  EXPECT_EQ(page.body.size(), DASHBOARD_HTML_GZ_LEN);
+}
+
+#ifdef HAVE_ZLIB
+std::string gunzip(const std::string& body) {
+  z_stream stream = {};
+  if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) return "";
+  std::string result(gzipInflatedSize(body), '\0');
+  stream.next_in = (Bytef*)body.data();
+  stream.avail_in = body.size();
+  stream.next_out = (Bytef*)result.data();
+  stream.avail_out = result.size();
+  int status = inflate(&stream, Z_FINISH);
+  inflateEnd(&stream);
+  return status == Z_STREAM_END && stream.avail_out == 0 ? result : "";
+}
+
+TEST_F(Dashboard, PageReferencesNothingOffTheClock) {
+  SimHttpResponse page = simHttpRequest(server, "GET", "/");
+  ASSERT_EQ(page.code, 200);
+  std::string html = gunzip(page.body);
+  ASSERT_FALSE(html.empty());
+
+  // Absolute http(s) or protocol-relative targets, quoted or not
+  const std::regex external(
+      "(\\b(src|href|action|poster|srcset)\\s*=\\s*|url\\(\\s*|@import\\s+|fetch\\(\\s*)[\"'`]?\\s*(https?:)?//",
+      std::regex::icase);
+  std::smatch match;
+  if (std::regex_search(html, match, external)) {
+    size_t at = match.position(0);
+    ADD_FAILURE() << "external reference: " << html.substr(at, 80);
+  }
+
+  // Scripts and styles are inline, assets come from /a/ on the clock
+  EXPECT_EQ(html.find("<script src"), std::string::npos);
+  EXPECT_EQ(html.find("<link rel=\"stylesheet\""), std::string::npos);
+}
+#endif
+
+}  // namespace
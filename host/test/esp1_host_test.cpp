@@ -0,0 +1,115 @@
+// Smoke test of the host build: esp1.cpp compiles against the shims and
+// its pure parts (alarm time parsing, history codec, log records, the log
+// ring) behave the same as on the chip.
+#include "esp1.cpp"
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include "sim.h"
+
+namespace {
+
+class Esp1Host : public ::testing::Test {
+protected:
+  void SetUp() override {
+    char dir[] = "/tmp/esp1_host_XXXXXX";
+    ASSERT_NE(mkdtemp(dir), nullptr);
+    simFsSetRoot(dir);
+    simFsPowerRestore();
+    alarmInit();
+    historyInit();
+  }
+};
+
+TEST_F(Esp1Host, ParsesAlarmTimes) {
+  EXPECT_EQ(parseAlarmTime("07:30"), 7 * 3600 + 30 * 60u);
+  EXPECT_EQ(parseAlarmTime("23:59:59"), 86399u);
+  EXPECT_EQ(parseAlarmTime("24:00"), ALARM_TIME_INVALID);
+  EXPECT_EQ(parseAlarmTime("7"), ALARM_TIME_INVALID);
+}
+
+TEST_F(Esp1Host, HistoryDecodesWhatWasAdded) {
+  const uint32_t start = 1700000000;
+  for (uint32_t t = 0; t < 5; t++) historyAdd(HISTORY_METRIC_T, start + t, 250 + t * 10);
+  // Closes the last 1 s bucket
+  historyAdd(HISTORY_METRIC_T, start + 5, 300);
+
+  HistoryJsonWriter writer = {};
+  writer.metric = HISTORY_METRIC_T;
+  writer.tier = 0;
+  writer.from = start;
+  writer.to = start + 4;
+  HistoryPoint points[HISTORY_JSON_BATCH];
+  int n = historyDecode(writer, points, HISTORY_JSON_BATCH);
+
+  ASSERT_EQ(n, 5);
+  for (int i = 0; i < n; i++) {
+    EXPECT_EQ(points[i].time, start + i);
+    EXPECT_EQ(points[i].avg, 250 + i * 10);
+  }
+}
+
+TEST_F(Esp1Host, LogRecordRoundTripsAndRejectsCorruption) {
+  logIndex = LogIndex();
+  logAppendsSinceIndex = 0;
+  logFile = LittleFS.open(LOG_PATH, "a");
+  ASSERT_TRUE(logFile);
+
+  LogRecord record = {};
+  record.type = LOG_HISTORY;
+  record.count = 1;
+  record.buckets[0] = { 1700000100, HISTORY_METRIC_PPM, 90, 100, 110 };
+  uint32_t offset = storageAppend(record);
+  ASSERT_EQ(offset, 0u);
+  logFile.close();
+
+  File file = LittleFS.open(LOG_PATH, "r");
+  LogRecord read;
+  ASSERT_TRUE(storageReadRecord(file, 0, read));
+  EXPECT_EQ(read.buckets[0].avg, 100);
+  file.close();
+
+  // One flipped byte fails the CRC
+  file = LittleFS.open(LOG_PATH, "r+");
+  file.seek(20);
+  file.write((uint8_t)0x5a);
+  file.close();
+  file = LittleFS.open(LOG_PATH, "r");
+  EXPECT_FALSE(storageReadRecord(file, 0, read));
+  file.close();
+}
+
+TEST_F(Esp1Host, LogRingKeepsLinesInOrder) {
+  LogLine line;
+  uint32_t cursor = logOldest();
+  while (logRead(cursor, line, nullptr)) {}
+
+  logWrite(LOG_LEVEL_INFO, "first %d", 1);
+  logWrite(LOG_LEVEL_WARN, "second");
+
+  ASSERT_TRUE(logRead(cursor, line, nullptr));
+  EXPECT_STREQ(line.text, "first 1");
+  ASSERT_TRUE(logRead(cursor, line, nullptr));
+  EXPECT_STREQ(line.text, "second");
+  EXPECT_FALSE(logRead(cursor, line, nullptr));
+}
+
+TEST_F(Esp1Host, AlarmPostedOverHttpIsListed) {
+  alarmBuildFreeList();
+  webAddAlarm();
+  webGetAlarm();
+
+  SimHttpResponse added = simHttpRequest(server, "POST", "/alarm", { { "Content-Type", "application/json" } },
+                                         "{\"time\":\"06:45\",\"label\":\"gym \\\"A\\\"\",\"days\":62}");
+  ASSERT_EQ(added.code, 200) << added.body;
+  EXPECT_EQ(added.body, "{\"id\":0}");
+
+  SimHttpResponse listed = simHttpRequest(server, "GET", "/alarm?start=0&limit=4");
+  ASSERT_EQ(listed.code, 200);
+  EXPECT_NE(listed.body.find("\"time\":\"06:45:00\",\"days\":62,\"enabled\":true,\"label\":\"gym \\\"A\\\"\""),
+            std::string::npos)
+    << listed.body;
+}
+
+}  // namespace
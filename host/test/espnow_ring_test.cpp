@@ -0,0 +1,120 @@
+// The ESP-NOW receive ring under load: a std::thread stands in for the
+// WiFi task calling OnDataRecv as fast as it can while the real
+// taskSensorConsumer drains. Every frame is either handled or counted as
+// an overflow, and overflows show up as gaps in the node's seq, never as
+// duplicates or rejected frames.
+#include "esp1.cpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "sim.h"
+
+namespace {
+
+const int SENSORS = 4;
+
+class EspNowRing : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    historyInit();
+    xTaskCreate(taskSensorConsumer, "sensorConsumer", 4096, NULL, 1, &taskHandleSensorConsumer);
+  }
+
+  void SetUp() override {
+    waitDrained();
+    portENTER_CRITICAL(&sensorNodesMux);
+    memset(sensorNodeKeys, 0, sizeof(sensorNodeKeys));
+    portEXIT_CRITICAL(&sensorNodesMux);
+    sensorFramesRejected = 0;
+    espNowRxOverflows = 0;
+    espNowRxMaxDepth = 0;
+    for (int i = 0; i < SENSORS; i++) seq[i] = 0;
+  }
+
+  // What the radio hands OnDataRecv for one frame from sensor
+  void deliver(int sensor) {
+    SensorFrame frame = {};
+    frame.version = SENSOR_FRAME_VERSION;
+    frame.sensorId = sensor;
+    frame.boot = 1;
+    frame.seq = seq[sensor]++;
+    frame.count = 1;
+    frame.samples[0] = { 0, (int16_t)(frame.seq & 0x7fff), (uint16_t)~frame.seq };
+
+    uint8_t mac[6] = { 0x24, 0x0a, 0xc4, 0x00, 0x00, (uint8_t)sensor };
+    wifi_pkt_rx_ctrl_t rxCtrl = {};
+    rxCtrl.rssi = -50;
+    esp_now_recv_info_t info = {};
+    info.src_addr = mac;
+    info.rx_ctrl = &rxCtrl;
+    OnDataRecv(&info, (const uint8_t*)&frame, SENSOR_FRAME_HEADER_LEN + sizeof(SensorSample));
+  }
+
+  static void waitDrained() {
+    while (espNowRxTail.load() != espNowRxHead.load()) std::this_thread::yield();
+  }
+
+  SensorNode node(int sensor) {
+    uint8_t mac[6] = { 0x24, 0x0a, 0xc4, 0x00, 0x00, (uint8_t)sensor };
+    portENTER_CRITICAL(&sensorNodesMux);
+    SensorNode copy = sensorNodes[sensorNodeSlot(macKey(mac), millis())];
+    portEXIT_CRITICAL(&sensorNodesMux);
+    return copy;
+  }
+
+  uint16_t seq[SENSORS];
+};
+
+TEST_F(EspNowRing, EveryFrameIsHandledOrCountedAsOverflow) {
+  const int frames = 200000;
+  std::thread wifi([this] {
+    for (int i = 0; i < frames; i++) deliver(i % SENSORS);
+  });
+  wifi.join();
+  waitDrained();
+
+  // Closing frame per sensor, so drops at the very end also become gaps
+  for (int sensor = 0; sensor < SENSORS; sensor++) deliver(sensor);
+  waitDrained();
+
+  uint32_t received = 0, lost = 0;
+  for (int sensor = 0; sensor < SENSORS; sensor++) {
+    SensorNode n = node(sensor);
+    received += n.framesReceived;
+    lost += n.framesLost;
+    EXPECT_EQ(n.lastSeq, (uint16_t)(seq[sensor] - 1));
+    EXPECT_EQ(n.latest.T, (int16_t)(n.lastSeq & 0x7fff));
+    EXPECT_EQ(n.latest.H, (uint16_t)~n.lastSeq);
+  }
+
+  EXPECT_EQ(sensorFramesRejected, 0u);
+  EXPECT_EQ(received + espNowRxOverflows, (uint32_t)frames + SENSORS);
+  EXPECT_EQ(lost, espNowRxOverflows);
+  EXPECT_LE(espNowRxMaxDepth, (uint32_t)ESPNOW_RX_QUEUE_LEN);
+}
+
+TEST_F(EspNowRing, NothingIsLostWhenTheConsumerKeepsUp) {
+  const int frames = 50000;
+  std::thread wifi([this] {
+    for (int i = 0; i < frames; i++) {
+      // A sender that backs off before the ring fills
+      while (espNowRxHead.load() - espNowRxTail.load() >= ESPNOW_RX_QUEUE_LEN) std::this_thread::yield();
+      deliver(i % SENSORS);
+    }
+  });
+  wifi.join();
+  waitDrained();
+
+  uint32_t received = 0, lost = 0;
+  for (int sensor = 0; sensor < SENSORS; sensor++) {
+    received += node(sensor).framesReceived;
+    lost += node(sensor).framesLost;
+  }
+  EXPECT_EQ(espNowRxOverflows, 0u);
+  EXPECT_EQ(received, (uint32_t)frames);
+  EXPECT_EQ(lost, 0u);
+}
+
+}  // namespace
@@ -0,0 +1,138 @@
+// History store: buckets come back exactly as they were added, whatever
+// the step between neighbours or the spread inside a bucket, across gaps,
+// ring wrap-around and every tier.
+#include "esp1.cpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+const uint32_t START = 1700000000;
+
+class History : public ::testing::Test {
+protected:
+  void SetUp() override {
+    historyInit();
+    historyPersistCount = 0;
+  }
+
+  std::vector<HistoryPoint> decode(uint8_t metric, uint8_t tier, uint32_t from = 0, uint32_t to = UINT32_MAX) {
+    HistoryJsonWriter writer = {};
+    writer.metric = metric;
+    writer.tier = tier;
+    writer.from = from;
+    writer.to = to;
+
+    std::vector<HistoryPoint> points;
+    HistoryPoint batch[HISTORY_JSON_BATCH];
+    while (int n = historyDecode(writer, batch, HISTORY_JSON_BATCH)) points.insert(points.end(), batch, batch + n);
+    return points;
+  }
+};
+
+TEST_F(History, LargeStepsAreExact) {
+  // 10 -> 2000 ppm and back, one sample per second
+  const int32_t values[] = { 10, 2000, 2000, 10, 11701, 0, 5, 9000 };
+  for (uint32_t i = 0; i < 8; i++) historyAdd(HISTORY_METRIC_PPM, START + i, values[i]);
+  historyAdd(HISTORY_METRIC_PPM, START + 8, 0);
+
+  std::vector<HistoryPoint> points = decode(HISTORY_METRIC_PPM, 0, START, START + 7);
+  ASSERT_EQ(points.size(), 8u);
+  for (int i = 0; i < 8; i++) {
+    EXPECT_EQ(points[i].avg, values[i]) << i;
+    EXPECT_EQ(points[i].min, values[i]) << i;
+    EXPECT_EQ(points[i].max, values[i]) << i;
+  }
+}
+
+TEST_F(History, WideBucketKeepsItsMinAndMax) {
+  // A spike inside one minute
+  historyAdd(HISTORY_METRIC_PPM, START, 10);
+  historyAdd(HISTORY_METRIC_PPM, START + 1, 2000);
+  historyAdd(HISTORY_METRIC_PPM, START + 2, 12);
+  historyAdd(HISTORY_METRIC_PPM, START + 120, 0);
+
+  std::vector<HistoryPoint> points = decode(HISTORY_METRIC_PPM, 1, START - START % 60, START - START % 60);
+  ASSERT_EQ(points.size(), 1u);
+  EXPECT_EQ(points[0].min, 10);
+  EXPECT_EQ(points[0].avg, (10 + 2000 + 12) / 3);
+  EXPECT_EQ(points[0].max, 2000);
+}
+
+TEST_F(History, NegativeValuesAndGaps) {
+  historyAdd(HISTORY_METRIC_T, START, -400);
+  historyAdd(HISTORY_METRIC_T, START + 1, 850);
+  // Nothing for 5 s, then back down
+  historyAdd(HISTORY_METRIC_T, START + 7, -400);
+  historyAdd(HISTORY_METRIC_T, START + 8, 0);
+
+  std::vector<HistoryPoint> points = decode(HISTORY_METRIC_T, 0, START, START + 7);
+  ASSERT_EQ(points.size(), 3u);
+  EXPECT_EQ(points[0].time, START);
+  EXPECT_EQ(points[0].avg, -400);
+  EXPECT_EQ(points[1].time, START + 1);
+  EXPECT_EQ(points[1].avg, 850);
+  EXPECT_EQ(points[2].time, START + 7);
+  EXPECT_EQ(points[2].avg, -400);
+}
+
+TEST_F(History, OutOfRangeSamplesAreClamped) {
+  historyAdd(HISTORY_METRIC_PPM, START, 100000);
+  historyAdd(HISTORY_METRIC_PPM, START + 1, -100000);
+  historyAdd(HISTORY_METRIC_PPM, START + 2, HISTORY_VALUE_MAX);
+  historyAdd(HISTORY_METRIC_PPM, START + 3, 0);
+
+  std::vector<HistoryPoint> points = decode(HISTORY_METRIC_PPM, 0, START, START + 2);
+  ASSERT_EQ(points.size(), 3u);
+  EXPECT_EQ(points[0].avg, HISTORY_VALUE_MAX);
+  EXPECT_EQ(points[1].avg, HISTORY_VALUE_MIN);
+  EXPECT_EQ(points[2].avg, HISTORY_VALUE_MAX);
+}
+
+TEST_F(History, RandomWalkSurvivesRingWrap) {
+  // Three rings' worth of 1 s buckets with extreme jumps and random gaps;
+  // the tier holds the newest HISTORY_TIER_1S_LEN and they must be exact
+  std::mt19937 random(7);
+  std::vector<std::pair<uint32_t, int32_t>> added;
+  uint32_t time = START;
+  for (int i = 0; i < 3 * HISTORY_TIER_1S_LEN; i++) {
+    if (random() % 10 == 0) time += random() % 20;
+    int32_t value = HISTORY_VALUE_MIN + (int32_t)(random() % (HISTORY_VALUE_MAX - HISTORY_VALUE_MIN + 1));
+    historyAdd(HISTORY_METRIC_H, time, value);
+    added.push_back({ time, value });
+    time++;
+  }
+  // Closes the last bucket
+  historyAdd(HISTORY_METRIC_H, time, 0);
+
+  std::vector<HistoryPoint> points = decode(HISTORY_METRIC_H, 0, 0, time - 1);
+  ASSERT_FALSE(points.empty());
+  uint32_t oldest = time - HISTORY_TIER_1S_LEN;
+  size_t next = 0;
+  while (added[next].first < oldest) next++;
+  ASSERT_EQ(points.size(), added.size() - next);
+  for (size_t i = 0; i < points.size(); i++, next++) {
+    ASSERT_EQ(points[i].time, added[next].first) << i;
+    ASSERT_EQ(points[i].avg, added[next].second) << i;
+    ASSERT_EQ(points[i].min, added[next].second) << i;
+    ASSERT_EQ(points[i].max, added[next].second) << i;
+  }
+}
+
+TEST_F(History, NodesShareOneSeries) {
+  // Two nodes reporting in the same second: one bucket spanning both
+  historyAdd(HISTORY_METRIC_T, START, 215);
+  historyAdd(HISTORY_METRIC_T, START, 281);
+  historyAdd(HISTORY_METRIC_T, START + 1, 0);
+
+  std::vector<HistoryPoint> points = decode(HISTORY_METRIC_T, 0, START, START);
+  ASSERT_EQ(points.size(), 1u);
+  EXPECT_EQ(points[0].min, 215);
+  EXPECT_EQ(points[0].avg, 248);
+  EXPECT_EQ(points[0].max, 281);
+}
+
+}  // namespace
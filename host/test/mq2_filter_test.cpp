@@ -0,0 +1,163 @@
+// MQ-2 pipeline kernels against synthetic ADC traces: the integer median
+// and moving average match a straightforward reference, spikes are
+// rejected, and the fixed-point Rs and ppm conversion stay within a few
+// percent of the datasheet curve they approximate.
+#include "esp1.cpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace {
+
+// Clean air around level with ADC noise, and a full-scale glitch on
+// roughly one sample in spikeEvery
+std::vector<uint16_t> trace(size_t length, uint16_t level, int noise, int spikeEvery, uint32_t seed) {
+  std::mt19937 random(seed);
+  std::vector<uint16_t> samples(length);
+  for (size_t i = 0; i < length; i++) {
+    int value = level + (int)(random() % (2 * noise + 1)) - noise;
+    if (spikeEvery > 0 && random() % spikeEvery == 0) value = random() % 2 ? MQ2_ADC_MAX : 0;
+    samples[i] = constrain(value, 0, MQ2_ADC_MAX);
+  }
+  return samples;
+}
+
+double datasheetPpm(double ratio) {
+  return pow(10, (log10(ratio) - 1.31) / -0.47);
+}
+
+TEST(Mq2Filter, MedianMatchesSortedWindow) {
+  std::vector<uint16_t> samples = trace(5000, 1800, 200, 10, 1);
+  MedianFilter<MQ2_MEDIAN_WINDOW> median;
+
+  for (size_t i = 0; i < samples.size(); i++) {
+    size_t from = i + 1 >= MQ2_MEDIAN_WINDOW ? i + 1 - MQ2_MEDIAN_WINDOW : 0;
+    std::vector<uint16_t> window(samples.begin() + from, samples.begin() + i + 1);
+    std::sort(window.begin(), window.end());
+    ASSERT_EQ(median.push(samples[i]), window[window.size() / 2]) << "sample " << i;
+  }
+}
+
+TEST(Mq2Filter, MovingAverageMatchesIntegerMean) {
+  std::vector<uint16_t> samples = trace(5000, 3000, 1000, 0, 2);
+  MovingAverage<MQ2_AVERAGE_WINDOW> average;
+
+  for (size_t i = 0; i < samples.size(); i++) {
+    size_t from = i + 1 >= MQ2_AVERAGE_WINDOW ? i + 1 - MQ2_AVERAGE_WINDOW : 0;
+    uint32_t sum = 0;
+    for (size_t j = from; j <= i; j++) sum += samples[j];
+    ASSERT_EQ(average.push(samples[i]), sum / (i + 1 - from)) << "sample " << i;
+  }
+}
+
+TEST(Mq2Filter, MovingAverageHoldsFullScale) {
+  // The sum must not wrap with every sample at the ADC maximum
+  MovingAverage<MQ2_AVERAGE_WINDOW> average;
+  for (int i = 0; i < 10 * MQ2_AVERAGE_WINDOW; i++) ASSERT_EQ(average.push(MQ2_ADC_MAX), MQ2_ADC_MAX);
+}
+
+TEST(Mq2Filter, IsolatedSpikesNeverReachTheOutput) {
+  // Glitches one or two samples long, never more than two within a window
+  std::vector<uint16_t> samples(4000, 1800);
+  for (size_t i = 50; i + 2 < samples.size(); i += 17) {
+    samples[i] = MQ2_ADC_MAX;
+    if (i % 2) samples[i + 1] = 0;
+  }
+
+  MedianFilter<MQ2_MEDIAN_WINDOW> median;
+  MovingAverage<MQ2_AVERAGE_WINDOW> average;
+  for (size_t i = 0; i < samples.size(); i++) ASSERT_EQ(average.push(median.push(samples[i])), 1800) << "sample " << i;
+}
+
+TEST(Mq2Filter, NoisyTraceSettlesNearItsLevel) {
+  // Glitches at random, rare enough that three rarely share a window
+  std::vector<uint16_t> samples = trace(5000, 1800, 60, 100, 3);
+  MedianFilter<MQ2_MEDIAN_WINDOW> median;
+  MovingAverage<MQ2_AVERAGE_WINDOW> average;
+
+  for (size_t i = 0; i < samples.size(); i++) {
+    uint16_t out = average.push(median.push(samples[i]));
+    if (i >= 2 * MQ2_AVERAGE_WINDOW) {
+      ASSERT_NEAR(out, 1800, 30) << "sample " << i;
+    }
+  }
+}
+
+TEST(Mq2Filter, StepIsFollowedWithinBothWindows) {
+  MedianFilter<MQ2_MEDIAN_WINDOW> median;
+  MovingAverage<MQ2_AVERAGE_WINDOW> average;
+  for (int i = 0; i < 100; i++) average.push(median.push(1000));
+
+  // Output rises monotonically and lands exactly once both windows hold
+  // only the new level
+  uint16_t last = 1000;
+  const int settle = MQ2_MEDIAN_WINDOW / 2 + MQ2_AVERAGE_WINDOW;
+  for (int i = 0; i < settle; i++) {
+    uint16_t out = average.push(median.push(3000));
+    EXPECT_GE(out, last);
+    last = out;
+  }
+  EXPECT_EQ(last, 3000);
+}
+
+TEST(Mq2Ppm, ResistanceMatchesFloat) {
+  for (uint16_t raw = 1; raw <= MQ2_ADC_MAX; raw++) {
+    double expected = (double)(MQ2_ADC_MAX - raw) / raw * 256;
+    ASSERT_EQ(mq2ResistanceQ8(raw), (uint32_t)expected) << "raw " << raw;
+  }
+  // 0 would divide by zero, it reads as the lowest reading instead
+  EXPECT_EQ(mq2ResistanceQ8(0), mq2ResistanceQ8(1));
+}
+
+TEST(Mq2Ppm, FollowsTheDatasheetCurve) {
+  const uint32_t first = MQ2_PPM_CURVE[0][0];
+  const uint32_t last = MQ2_PPM_CURVE[sizeof(MQ2_PPM_CURVE) / sizeof(MQ2_PPM_CURVE[0]) - 1][0];
+
+  for (uint32_t ratioQ8 = first; ratioQ8 <= last; ratioQ8++) {
+    double expected = datasheetPpm(ratioQ8 / 256.0);
+    uint16_t ppm = mq2Ppm(ratioQ8);
+    // Integer ppm dominates the error at the low end
+    if (expected >= 50) {
+      ASSERT_NEAR(ppm, expected, expected * 0.07) << "ratio " << ratioQ8;
+    } else {
+      ASSERT_NEAR(ppm, expected, 4) << "ratio " << ratioQ8;
+    }
+    if (ratioQ8 > first) {
+      ASSERT_LE(ppm, mq2Ppm(ratioQ8 - 1)) << "ratio " << ratioQ8;
+    }
+  }
+}
+
+TEST(Mq2Ppm, ClampsOutsideTheCurve) {
+  EXPECT_EQ(mq2Ppm(0), MQ2_PPM_CURVE[0][1]);
+  EXPECT_EQ(mq2Ppm(UINT32_MAX), 5);
+}
+
+TEST(Mq2Ppm, CalibratedTraceReadsTheRightConcentration) {
+  // Clean air at raw 1000, R0 derived the way the task does it
+  MedianFilter<MQ2_MEDIAN_WINDOW> median;
+  MovingAverage<MQ2_AVERAGE_WINDOW> average;
+  uint32_t calibrationSum = 0;
+  for (uint16_t raw : trace(MQ2_CALIBRATION_SAMPLES, 1000, 20, 50, 4)) {
+    calibrationSum += mq2ResistanceQ8(average.push(median.push(raw)));
+  }
+  uint32_t r0Q8 = calibrationSum / MQ2_CALIBRATION_SAMPLES * 100 / MQ2_CLEAN_AIR_RATIO_X100;
+
+  // Gas dropping Rs to a fifth of clean air, that is Rs/R0 ~ 1.97
+  double r0 = (double)(MQ2_ADC_MAX - 1000) / 1000 / (MQ2_CLEAN_AIR_RATIO_X100 / 100.0);
+  double rs = r0 * 9.83 / 5;
+  uint16_t gasRaw = lround(MQ2_ADC_MAX / (rs + 1));
+
+  uint16_t ppm = 0;
+  for (uint16_t raw : trace(500, gasRaw, 10, 50, 5)) {
+    ppm = mq2Ppm((mq2ResistanceQ8(average.push(median.push(raw))) << 8) / r0Q8);
+  }
+  double expected = datasheetPpm(9.83 / 5);
+  EXPECT_NEAR(ppm, expected, expected * 0.1);
+}
+
+}  // namespace
@@ -0,0 +1,147 @@
+// ESP2 batching: queueSample's deadband and keepAll, the oldest sample
+// dropped from a full batch with the rest rebased onto it, the heartbeat
+// sample, and lowPowerFlush against the simulated radio where nobody
+// answers, then with the send callback forced to succeed.
+#include "esp2.cpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+bool forceSendOk = false;
+
+// Stands in for ESP1's MAC-level ACK, which the simulated bus lacks here
+void sendResult(const uint8_t* mac, esp_now_send_status_t status) {
+  OnDataSent(mac, forceSendOk ? ESP_NOW_SEND_SUCCESS : status);
+}
+
+class SensorBatch : public ::testing::Test {
+protected:
+  void SetUp() override {
+    memset(&frame, 0, sizeof(frame));
+    memset(&lastQueued, 0, sizeof(lastQueued));
+    hasQueued = false;
+    frameSeq = 100;
+    lastSendMs = 0;
+    lpFlushes = 0;
+  }
+
+  static bool sample(unsigned long now, float T, float H, bool keepAll = false) {
+    sensorData.T = T;
+    sensorData.H = H;
+    return queueSample(now, keepAll);
+  }
+};
+
+TEST_F(SensorBatch, DeadbandDropsSmallChangesUnlessKeepAll) {
+  EXPECT_TRUE(sample(1000, 25.0f, 60.0f));
+  EXPECT_EQ(frame.count, 1);
+
+  // 0.4 C and 1.9 % are inside DEADBAND_T / DEADBAND_H
+  EXPECT_FALSE(sample(3000, 25.4f, 61.9f));
+  EXPECT_EQ(frame.count, 1);
+
+  // Low power keeps it, but it does not move the reference
+  EXPECT_FALSE(sample(5000, 25.4f, 61.9f, true));
+  EXPECT_EQ(frame.count, 2);
+  EXPECT_EQ(lastQueued.T, 250);
+  EXPECT_EQ(lastQueued.H, 600);
+
+  EXPECT_TRUE(sample(7000, 25.5f, 60.0f));
+  EXPECT_TRUE(sample(9000, 25.5f, 62.0f));
+  EXPECT_EQ(frame.count, 4);
+  EXPECT_EQ(lastQueued.H, 620);
+}
+
+TEST_F(SensorBatch, ReadFailureIsNotQueued) {
+  EXPECT_FALSE(sample(1000, NAN, 60.0f, true));
+  EXPECT_FALSE(sample(1000, 25.0f, NAN, true));
+  EXPECT_EQ(frame.count, 0);
+  EXPECT_FALSE(hasQueued);
+}
+
+TEST_F(SensorBatch, FullBatchDropsTheOldestAndRebases) {
+  const unsigned long start = 50000;
+  for (int i = 0; i < SENSOR_FRAME_MAX_SAMPLES; i++) sample(start + i * 2000, 20.0f + i, 50.0f, true);
+  ASSERT_EQ(frame.count, SENSOR_FRAME_MAX_SAMPLES);
+  EXPECT_EQ(frame.timestamp, start);
+  EXPECT_EQ(frame.samples[SENSOR_FRAME_MAX_SAMPLES - 1].dt, (SENSOR_FRAME_MAX_SAMPLES - 1) * 20);
+
+  sample(start + SENSOR_FRAME_MAX_SAMPLES * 2000, 40.0f, 50.0f, true);
+  ASSERT_EQ(frame.count, SENSOR_FRAME_MAX_SAMPLES);
+
+  // The second sample is the new origin, every dt still points at its time
+  EXPECT_EQ(frame.timestamp, start + 2000);
+  for (int i = 0; i < SENSOR_FRAME_MAX_SAMPLES - 1; i++) {
+    EXPECT_EQ(frame.samples[i].dt, i * 20) << i;
+    EXPECT_EQ(frame.samples[i].T, 210 + i * 10) << i;
+  }
+  EXPECT_EQ(frame.samples[SENSOR_FRAME_MAX_SAMPLES - 1].dt, (SENSOR_FRAME_MAX_SAMPLES - 1) * 20);
+  EXPECT_EQ(frame.samples[SENSOR_FRAME_MAX_SAMPLES - 1].T, 400);
+  EXPECT_EQ(frame.seq, 100);
+}
+
+TEST_F(SensorBatch, HeartbeatResendsTheReferenceSample) {
+  // Nothing measured yet, nothing to repeat
+  EXPECT_FALSE(queueHeartbeat(1000));
+  EXPECT_EQ(frame.count, 0);
+
+  sample(2000, 25.0f, 60.0f);
+  EXPECT_FALSE(queueHeartbeat(4000));  // batch not sent yet
+  flushFrame(4000);
+  ASSERT_EQ(frame.count, 0);
+
+  EXPECT_TRUE(queueHeartbeat(4000 + HEARTBEAT_INTERVAL_MS));
+  ASSERT_EQ(frame.count, 1);
+  EXPECT_EQ(frame.timestamp, 4000 + HEARTBEAT_INTERVAL_MS);
+  EXPECT_EQ(frame.samples[0].dt, 0);
+  EXPECT_EQ(frame.samples[0].T, 250);
+  EXPECT_EQ(frame.samples[0].H, 600);
+  EXPECT_EQ(frame.seq, 101);
+}
+
+TEST_F(SensorBatch, SeqIsTakenWhenTheBatchStarts) {
+  sample(1000, 25.0f, 60.0f);
+  sample(3000, 26.0f, 60.0f);
+  EXPECT_EQ(frame.seq, 100);
+  EXPECT_EQ(frameSeq, 101);
+
+  flushFrame(3000);
+  sample(5000, 27.0f, 60.0f);
+  EXPECT_EQ(frame.seq, 101);
+}
+
+TEST_F(SensorBatch, FailedFlushKeepsTheBatchAndItsSeq) {
+  ASSERT_TRUE(initRadio());
+  esp_now_register_send_cb(sendResult);
+
+  sample(1000, 25.0f, 60.0f, true);
+  sample(61000, 25.1f, 60.0f, true);
+  SensorFrame before = frame;
+
+  // No ESP1 on the bus: the unicast times out and the scan finds nobody
+  forceSendOk = false;
+  EXPECT_FALSE(lowPowerFlush(61000));
+  EXPECT_EQ(memcmp(&frame.samples, &before.samples, sizeof(before.samples)), 0);
+  EXPECT_EQ(frame.count, 2);
+  EXPECT_EQ(frame.timestamp, 1000u);
+  EXPECT_EQ(frame.seq, 100);
+  EXPECT_EQ(lastSendMs, 0u);
+  EXPECT_EQ(lpFlushes, 0u);
+
+  // Next cycle adds to the same batch, the retry goes out under the same seq
+  sample(121000, 25.2f, 60.0f, true);
+  EXPECT_EQ(frame.count, 3);
+  EXPECT_EQ(frame.seq, 100);
+
+  forceSendOk = true;
+  EXPECT_TRUE(lowPowerFlush(121000));
+  EXPECT_EQ(frame.count, 0);
+  EXPECT_EQ(lastSendMs, 121000u);
+  EXPECT_EQ(lpFlushes, 1u);
+
+  sample(181000, 25.3f, 60.0f, true);
+  EXPECT_EQ(frame.seq, 101);
+}
+
+}  // namespace
@@ -0,0 +1,106 @@
+// handleSensorFrame: validation, duplicate suppression and gap counting on
+// the 16-bit seq, and sensor restarts (a new boot id) not counted as loss.
+#include "esp1.cpp"
+
+#include <gtest/gtest.h>
+
+#include "sim.h"
+
+namespace {
+
+const uint8_t SENSOR_MAC[6] = { 0x24, 0x0a, 0xc4, 0x00, 0x00, 0x02 };
+
+class SensorFrames : public ::testing::Test {
+protected:
+  void SetUp() override {
+    historyInit();
+    memset(sensorNodeKeys, 0, sizeof(sensorNodeKeys));
+    sensorFramesRejected = 0;
+  }
+
+  int receive(uint16_t boot, uint16_t seq, int count = 1) {
+    SensorFrame frame = {};
+    frame.version = SENSOR_FRAME_VERSION;
+    frame.sensorId = 1;
+    frame.boot = boot;
+    frame.seq = seq;
+    frame.count = count;
+    for (int i = 0; i < count; i++) frame.samples[i] = { (uint16_t)(i * 10), 250, 600 };
+
+    EspNowRxFrame rx = {};
+    memcpy(rx.mac, SENSOR_MAC, 6);
+    rx.rssi = -50;
+    rx.len = SENSOR_FRAME_HEADER_LEN + count * sizeof(SensorSample);
+    memcpy(rx.data, &frame, rx.len);
+    return handleSensorFrame(&rx);
+  }
+
+  const SensorNode& node() {
+    return sensorNodes[sensorNodeSlot(macKey(SENSOR_MAC), millis())];
+  }
+};
+
+TEST_F(SensorFrames, CountsGapsAndDropsDuplicates) {
+  for (uint16_t seq = 0; seq < 10; seq++) ASSERT_GE(receive(7, seq), 0);
+  EXPECT_EQ(node().framesLost, 0u);
+
+  // 10..12 never arrived
+  ASSERT_GE(receive(7, 13), 0);
+  EXPECT_EQ(node().framesLost, 3u);
+
+  // A retransmission of something already seen
+  EXPECT_EQ(receive(7, 12), -1);
+  EXPECT_EQ(receive(7, 13), -1);
+  EXPECT_EQ(node().framesReceived, 11u);
+  EXPECT_EQ(node().lastSeq, 13);
+}
+
+TEST_F(SensorFrames, SeqWrapIsNotAGap) {
+  ASSERT_GE(receive(7, 0xfffe), 0);
+  ASSERT_GE(receive(7, 0xffff), 0);
+  ASSERT_GE(receive(7, 0), 0);
+  ASSERT_GE(receive(7, 1), 0);
+  EXPECT_EQ(node().framesLost, 0u);
+}
+
+TEST_F(SensorFrames, RestartIsNotCountedAsLoss) {
+  // Far enough into the sequence that 0 reads as a 25k forward jump
+  for (uint16_t seq = 40000; seq < 40005; seq++) ASSERT_GE(receive(7, seq), 0);
+
+  ASSERT_GE(receive(9, 0), 0);
+  EXPECT_EQ(node().framesLost, 0u);
+  EXPECT_EQ(node().restarts, 1u);
+
+  // Within the new boot, gaps and duplicates work as before
+  ASSERT_GE(receive(9, 2), 0);
+  EXPECT_EQ(node().framesLost, 1u);
+  EXPECT_EQ(receive(9, 2), -1);
+
+  // Restarted just before, seq close to the old one: still not a duplicate
+  ASSERT_GE(receive(11, 1), 0);
+  EXPECT_EQ(node().restarts, 2u);
+  EXPECT_EQ(node().framesLost, 1u);
+}
+
+TEST_F(SensorFrames, RejectsMalformedFrames) {
+  SensorFrame frame = {};
+  frame.version = SENSOR_FRAME_VERSION;
+  frame.count = 2;
+
+  EspNowRxFrame rx = {};
+  memcpy(rx.mac, SENSOR_MAC, 6);
+  memcpy(rx.data, &frame, sizeof(frame));
+
+  // Length disagrees with count
+  rx.len = SENSOR_FRAME_HEADER_LEN + sizeof(SensorSample);
+  EXPECT_EQ(handleSensorFrame(&rx), -1);
+
+  // Older format
+  rx.len = SENSOR_FRAME_HEADER_LEN + 2 * sizeof(SensorSample);
+  rx.data[0] = SENSOR_FRAME_VERSION - 1;
+  EXPECT_EQ(handleSensorFrame(&rx), -1);
+
+  EXPECT_EQ(sensorFramesRejected, 2u);
+}
+
+}  // namespace
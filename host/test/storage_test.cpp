@@ -0,0 +1,181 @@
+// Storage log: compaction cut off by a power failure at every possible
+// flash operation must still boot into the same alarms and history,
+// whether the old or the new log survives.
+#include "esp1.cpp"
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include <vector>
+
+#include "sim.h"
+
+namespace {
+
+const uint32_t START = 1700000000 - 1700000000 % 900;
+const int ALARMS = 24;
+const int BUCKETS = 6 * LOG_HISTORY_BATCH;  // whole batches, all of them logged
+
+struct Snapshot {
+  std::vector<std::pair<int, uint32_t>> alarms;
+  std::vector<int32_t> history;
+
+  bool operator==(const Snapshot& other) const {
+    return alarms == other.alarms && history == other.history;
+  }
+};
+
+class Storage : public ::testing::Test {
+protected:
+  void SetUp() override {
+    simFsPowerRestore();
+    boot();
+  }
+
+  void TearDown() override {
+    if (logFile) logFile.close();
+    simFsPowerRestore();
+  }
+
+  // Fresh flash, RAM and log
+  void boot() {
+    char dir[] = "/tmp/storage_test_XXXXXX";
+    ASSERT_NE(mkdtemp(dir), nullptr);
+    simFsSetRoot(dir);
+    reboot();
+  }
+
+  // Forgets RAM and replays the log, as setup() does
+  void reboot() {
+    if (logFile) logFile.close();
+    alarmInit();
+    historyInit();
+    historyPersistCount = 0;
+    memset(&logHistoryBatch, 0, sizeof(logHistoryBatch));
+    memset(storageAlarmDirtyBits, 0, sizeof(storageAlarmDirtyBits));
+    logNeedsCompaction = false;
+    storageReplay();
+    alarmBuildFreeList();
+    logFile = LittleFS.open(LOG_PATH, "a");
+  }
+
+  void setAlarm(int slot, uint32_t seconds) {
+    AlarmEntry entry = {};
+    entry.seconds = seconds;
+    entry.flags = ALARM_ENABLED;
+    snprintf(entry.label, sizeof(entry.label), "alarm %d", slot);
+    alarmSet(slot, entry);
+    storageAlarmDirty(slot);
+  }
+
+  // Every alarm written twice, so the old log has superseded records at
+  // offsets the compacted one does not, plus whole history batches
+  void fillLog() {
+    for (int pass = 0; pass < 2; pass++) {
+      for (int slot = 0; slot < ALARMS; slot++) setAlarm(slot, pass * 3600 + slot * 60);
+      storageFlushAlarms();
+    }
+    for (int i = 0; i <= BUCKETS; i++) {
+      historyAdd(HISTORY_METRIC_PPM, START + i * 900, 100 + i * 37);
+      storageCollectHistory();
+    }
+  }
+
+  Snapshot snapshot() {
+    Snapshot result;
+    for (int slot = 0; slot < MAX_ALARM; slot++) {
+      AlarmEntry entry;
+      if (alarmGet(slot, entry)) result.alarms.push_back({ slot, (uint32_t)entry.seconds });
+    }
+
+    HistoryJsonWriter writer = {};
+    writer.metric = HISTORY_METRIC_PPM;
+    writer.tier = HISTORY_PERSIST_TIER;
+    writer.to = START + (BUCKETS - 1) * 900;
+    HistoryPoint points[HISTORY_JSON_BATCH];
+    while (int n = historyDecode(writer, points, HISTORY_JSON_BATCH)) {
+      for (int i = 0; i < n; i++) result.history.push_back(points[i].avg);
+    }
+    return result;
+  }
+};
+
+TEST_F(Storage, ReplayRestoresWhatWasLogged) {
+  fillLog();
+  Snapshot before = snapshot();
+  ASSERT_EQ(before.alarms.size(), (size_t)ALARMS);
+  ASSERT_EQ(before.history.size(), (size_t)BUCKETS);
+
+  reboot();
+  EXPECT_TRUE(snapshot() == before);
+  EXPECT_EQ(logRecordsCorrupt, 0u);
+}
+
+TEST_F(Storage, CompactionKeepsStateAndIndexesTheNewLog) {
+  fillLog();
+  Snapshot before = snapshot();
+  storageCompact();
+
+  // One record per alarm, then the history batches right after them
+  EXPECT_EQ(logIndex.historyOffset, (uint32_t)ALARMS * LOG_RECORD_SIZE);
+  File file = LittleFS.open(LOG_PATH, "r");
+  EXPECT_EQ(file.size(), (size_t)(ALARMS + BUCKETS / LOG_HISTORY_BATCH) * LOG_RECORD_SIZE);
+  file.close();
+
+  uint32_t corrupt = logRecordsCorrupt;
+  reboot();
+  EXPECT_TRUE(snapshot() == before);
+  EXPECT_EQ(logRecordsCorrupt, corrupt);
+  // Booted from the index, not a full scan: it covers the whole new log
+  EXPECT_EQ(logIndex.length + logAppendsSinceIndex * LOG_RECORD_SIZE,
+            (uint32_t)(ALARMS + BUCKETS / LOG_HISTORY_BATCH) * LOG_RECORD_SIZE);
+}
+
+TEST_F(Storage, HistoryOffsetAccountsForTheIndexedPrefix) {
+  // Alarms past LOG_INDEX_INTERVAL during compaction used to push the
+  // history range to where only part of it was
+  fillLog();
+  storageCompact();
+  ASSERT_GT(ALARMS, LOG_INDEX_INTERVAL);
+
+  File file = LittleFS.open(LOG_PATH, "r");
+  LogRecord record;
+  ASSERT_TRUE(storageReadRecord(file, logIndex.historyOffset, record));
+  EXPECT_EQ(record.type, LOG_HISTORY);
+  ASSERT_TRUE(storageReadRecord(file, logIndex.historyOffset - LOG_RECORD_SIZE, record));
+  EXPECT_EQ(record.type, LOG_ALARM);
+  file.close();
+}
+
+TEST_F(Storage, PowerCutAnywhereInCompactionLosesNothing) {
+  // How many flash operations one compaction takes
+  fillLog();
+  Snapshot expected = snapshot();
+  simFsPowerCut(INT32_MAX);
+  storageCompact();
+  int operations = simFsOperations();
+  simFsPowerRestore();
+  ASSERT_GT(operations, ALARMS);
+
+  for (int cut = 0; cut <= operations; cut++) {
+    boot();
+    fillLog();
+    ASSERT_TRUE(snapshot() == expected);
+
+    simFsPowerCut(cut);
+    storageCompact();
+    simFsPowerRestore();
+
+    reboot();
+    EXPECT_TRUE(snapshot() == expected) << "power cut after " << cut << " of " << operations << " operations";
+
+    // And the log still takes appends that survive the next boot
+    setAlarm(ALARMS, 7 * 3600);
+    storageFlushAlarms();
+    reboot();
+    AlarmEntry entry;
+    EXPECT_TRUE(alarmGet(ALARMS, entry)) << "power cut after " << cut;
+  }
+}
+
+}  // namespace
@@ -0,0 +1,122 @@
+// deadlinePriority() and the APP_CPU task set it orders: the mapping is
+// monotonic and stays inside the band below the WiFi and lwIP tasks, and a
+// preemptive fixed-priority simulation of APP_CPU under a pessimistic load
+// keeps every task within its DEADLINE_*_MS.
+#include "esp1.cpp"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace {
+
+// ESP-IDF default for tcpip_thread, the lowest of the tasks that keep
+// the radio up (WiFi runs at 23)
+const UBaseType_t LWIP_TASK_PRIORITY = 18;
+
+TEST(DeadlinePriority, ShorterDeadlineNeverRanksLower) {
+  UBaseType_t last = deadlinePriority(0);
+  for (uint32_t ms = 1; ms <= 120000; ms++) {
+    UBaseType_t priority = deadlinePriority(ms);
+    ASSERT_LE(priority, last) << ms << " ms";
+    last = priority;
+  }
+  EXPECT_EQ(deadlinePriority(UINT32_MAX), 1u);
+}
+
+TEST(DeadlinePriority, StaysAboveIdleAndBelowTheNetworkStack) {
+  for (uint32_t ms : { 0u, 1u, 20u, 21u, 100u, 101u, 1000u, 1001u, 10000u, 10001u, UINT32_MAX }) {
+    EXPECT_GT(deadlinePriority(ms), (UBaseType_t)tskIDLE_PRIORITY) << ms;
+    EXPECT_LT(deadlinePriority(ms), LWIP_TASK_PRIORITY) << ms;
+    EXPECT_LT(deadlinePriority(ms), configMAX_PRIORITIES) << ms;
+  }
+}
+
+TEST(DeadlinePriority, TasksRankInDeadlineOrder) {
+  EXPECT_GT(deadlinePriority(DEADLINE_AIR_POLLUTION_MS), deadlinePriority(DEADLINE_SENSOR_CONSUMER_MS));
+  EXPECT_GT(deadlinePriority(DEADLINE_SENSOR_CONSUMER_MS), deadlinePriority(DEADLINE_ALARM_SCHEDULER_MS));
+  EXPECT_GE(deadlinePriority(DEADLINE_TELEMETRY_MS), deadlinePriority(DEADLINE_ALARM_SCHEDULER_MS));
+  EXPECT_GT(deadlinePriority(DEADLINE_ALARM_SCHEDULER_MS), deadlinePriority(DEADLINE_UPDATE_TIME_MS));
+  EXPECT_GT(deadlinePriority(DEADLINE_UPDATE_TIME_MS), deadlinePriority(DEADLINE_STORAGE_MS));
+}
+
+/* ===== APP_CPU latency simulation ==== */
+// Periodic jobs on one core, highest priority first, FIFO within a
+// priority, preempted at the next step. Costs are pessimistic estimates
+// of each task's work per wakeup on the ESP32.
+struct SimTask {
+  std::string name;
+  uint32_t periodUs;
+  uint32_t costUs;
+  uint32_t deadlineUs;
+  UBaseType_t priority;
+
+  std::deque<uint64_t> released;  // pending jobs, oldest first
+  uint32_t left = 0;              // work left on the oldest job
+  uint64_t worstUs = 0;           // release to completion
+};
+
+const uint32_t STEP_US = 10;
+
+void simulate(std::vector<SimTask>& tasks, uint64_t durationUs) {
+  for (uint64_t now = 0; now < durationUs; now += STEP_US) {
+    SimTask* running = NULL;
+    for (SimTask& task : tasks) {
+      if (now % task.periodUs == 0) {
+        if (task.released.empty()) task.left = task.costUs;
+        task.released.push_back(now);
+      }
+      if (task.released.empty()) continue;
+      if (running == NULL || task.priority > running->priority
+          || (task.priority == running->priority && task.released.front() < running->released.front())) {
+        running = &task;
+      }
+    }
+    if (running == NULL) continue;
+
+    running->left -= std::min(running->left, STEP_US);
+    if (running->left > 0) continue;
+    running->worstUs = std::max(running->worstUs, now + STEP_US - running->released.front());
+    running->released.pop_front();
+    if (!running->released.empty()) running->left = running->costUs;
+  }
+}
+
+// APP_CPU as setup() lays it out. taskSensorConsumer drains a full ring in
+// one burst; taskStorage compacts the log, the longest flash job it has.
+std::vector<SimTask> appCpuTasks() {
+  return {
+    { "air pollution", MQ2_SAMPLE_PERIOD_MS * 1000, 400, DEADLINE_AIR_POLLUTION_MS * 1000,
+      deadlinePriority(DEADLINE_AIR_POLLUTION_MS) },
+    { "sensor consumer", 250000, ESPNOW_RX_QUEUE_LEN * 300, DEADLINE_SENSOR_CONSUMER_MS * 1000,
+      deadlinePriority(DEADLINE_SENSOR_CONSUMER_MS) },
+    { "alarm scheduler", 1000000, 3000, DEADLINE_ALARM_SCHEDULER_MS * 1000, deadlinePriority(DEADLINE_ALARM_SCHEDULER_MS) },
+    { "update time", TIME_DRIFT_CHECK_MS * 1000, 5000, DEADLINE_UPDATE_TIME_MS * 1000,
+      deadlinePriority(DEADLINE_UPDATE_TIME_MS) },
+    { "storage", 5000000, 250000, DEADLINE_STORAGE_MS * 1000, deadlinePriority(DEADLINE_STORAGE_MS) },
+  };
+}
+
+TEST(AppCpuLatency, EveryTaskMeetsItsDeadline) {
+  std::vector<SimTask> tasks = appCpuTasks();
+  simulate(tasks, 120000000ULL);
+
+  for (const SimTask& task : tasks) EXPECT_LE(task.worstUs, task.deadlineUs) << task.name;
+  // Nothing above it, so the MQ-2 sample only ever waits for itself
+  EXPECT_LE(tasks[0].worstUs, tasks[0].costUs + STEP_US);
+}
+
+TEST(AppCpuLatency, InvertedPrioritiesMissTheShortDeadlines) {
+  // The same load with storage on top, as a check that the simulation
+  // does catch what the deadline order prevents
+  std::vector<SimTask> tasks = appCpuTasks();
+  for (SimTask& task : tasks) task.priority = deadlinePriority(0) + 1 - task.priority;
+  simulate(tasks, 120000000ULL);
+
+  EXPECT_GT(tasks[0].worstUs, tasks[0].deadlineUs);
+  EXPECT_GT(tasks[1].worstUs, tasks[1].deadlineUs);
+}
+
+}  // namespace
@@ -0,0 +1,143 @@
+// TOPIC_SNAPSHOT on WebSocket connect: the frame is exactly as long as the
+// nodes and alarms it carries, and decodes back to them.
+#include "esp1.cpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "sim.h"
+
+namespace {
+
+const size_t HEADER_LEN = 15;  // topic, epoch ms, UTC offset, ppm
+
+class TelemetrySnapshot : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    telemetry.onEvent(onTelemetryEvent);
+  }
+
+  void SetUp() override {
+    historyInit();
+    alarmInit();
+    memset(sensorNodeKeys, 0, sizeof(sensorNodeKeys));
+    memset(telemetryLatestLen, 0, sizeof(telemetryLatestLen));
+  }
+
+  void addAlarm(const std::string& label, uint32_t seconds) {
+    AlarmEntry entry = {};
+    entry.seconds = seconds;
+    entry.days = ALARM_DAYS_ALL;
+    entry.flags = ALARM_ENABLED;
+    snprintf(entry.label, sizeof(entry.label), "%s", label.c_str());
+    int slot = alarmAlloc();
+    ASSERT_GE(slot, 0);
+    ASSERT_TRUE(alarmSet(slot, entry));
+  }
+
+  void addNode(uint8_t sensor, int16_t T, uint16_t H) {
+    SensorFrame frame = {};
+    frame.version = SENSOR_FRAME_VERSION;
+    frame.sensorId = sensor;
+    frame.boot = 1;
+    frame.count = 1;
+    frame.samples[0] = { 0, T, H };
+
+    EspNowRxFrame rx = {};
+    uint8_t mac[6] = { 0x24, 0x0a, 0xc4, 0x00, 0x01, sensor };
+    memcpy(rx.mac, mac, 6);
+    rx.rssi = -50;
+    rx.len = SENSOR_FRAME_HEADER_LEN + sizeof(SensorSample);
+    memcpy(rx.data, &frame, rx.len);
+    ASSERT_GE(handleSensorFrame(&rx), 0);
+  }
+
+  // The first frame a fresh client gets
+  std::vector<uint8_t> connect() {
+    SimWsPeer* peer = simWsConnect(telemetry);
+    std::vector<std::vector<uint8_t>> frames = simWsReceived(peer);
+    simWsDisconnect(peer);
+    return frames.empty() ? std::vector<uint8_t>() : frames[0];
+  }
+};
+
+template <typename T>
+T read(const std::vector<uint8_t>& frame, size_t at) {
+  T value;
+  memcpy(&value, frame.data() + at, sizeof(value));
+  return value;
+}
+
+TEST_F(TelemetrySnapshot, EmptyTablesMakeTheSmallestFrame) {
+  std::vector<uint8_t> frame = connect();
+  ASSERT_EQ(frame.size(), HEADER_LEN + 1 + 6);
+  EXPECT_EQ(frame[0], TOPIC_SNAPSHOT);
+  EXPECT_EQ(read<uint16_t>(frame, 13), 0xffff);
+  EXPECT_EQ(frame[15], 0);
+  EXPECT_EQ(read<uint32_t>(frame, 16), alarmRevision);
+  EXPECT_EQ(read<uint16_t>(frame, 20), 0);
+}
+
+TEST_F(TelemetrySnapshot, FrameCarriesExactlyTheNodesAndAlarms) {
+  addNode(3, 215, 604);
+  addNode(9, -40, 1000);
+  const std::vector<std::string> labels = { "", "Wake up", std::string(ALARM_LABEL_MAX_LEN, 'x') };
+  for (size_t i = 0; i < labels.size(); i++) addAlarm(labels[i], 6 * 3600 + i * 60);
+
+  std::vector<uint8_t> frame = connect();
+  size_t expected = HEADER_LEN + 1 + 2 * 6 + 6;
+  for (const std::string& label : labels) expected += 9 + label.size();
+  ASSERT_EQ(frame.size(), expected);
+
+  ASSERT_EQ(frame[15], 2);
+  EXPECT_EQ(frame[17], 3);
+  EXPECT_EQ(read<int16_t>(frame, 18), 215);
+  EXPECT_EQ(read<uint16_t>(frame, 20), 604);
+  EXPECT_EQ(frame[23], 9);
+  EXPECT_EQ(read<int16_t>(frame, 24), -40);
+  EXPECT_EQ(read<uint16_t>(frame, 26), 1000);
+
+  size_t at = 16 + 2 * 6;
+  EXPECT_EQ(read<uint32_t>(frame, at), alarmRevision);
+  ASSERT_EQ(read<uint16_t>(frame, at + 4), labels.size());
+  at += 6;
+  for (size_t i = 0; i < labels.size(); i++) {
+    EXPECT_EQ(read<uint16_t>(frame, at), i);
+    EXPECT_EQ(read<uint32_t>(frame, at + 2), 6 * 3600 + i * 60);
+    ASSERT_EQ(frame[at + 8], labels[i].size());
+    EXPECT_EQ(std::string((const char*)frame.data() + at + 9, labels[i].size()), labels[i]);
+    at += 9 + labels[i].size();
+  }
+  EXPECT_EQ(at, frame.size());
+}
+
+TEST_F(TelemetrySnapshot, FullTablesFitOneFrame) {
+  for (int sensor = 0; sensor < MAX_SENSOR_NODES; sensor++) addNode(sensor, sensor, sensor);
+  size_t labelBytes = 0;
+  for (int i = 0; i < MAX_ALARM; i++) {
+    std::string label = i % 16 == 0 ? std::string(ALARM_LABEL_MAX_LEN, 'a' + i / 16) : "alarm " + std::to_string(i % 100);
+    addAlarm(label, i * 60);
+    labelBytes += label.size();
+  }
+
+  std::vector<uint8_t> frame = connect();
+  EXPECT_EQ(frame.size(), HEADER_LEN + 1 + MAX_SENSOR_NODES * 6 + 6 + MAX_ALARM * 9 + labelBytes);
+  EXPECT_EQ(frame[15], MAX_SENSOR_NODES);
+  EXPECT_EQ(read<uint16_t>(frame, 16 + MAX_SENSOR_NODES * 6 + 4), MAX_ALARM);
+}
+
+TEST_F(TelemetrySnapshot, BufferOfAnotherSizeIsRejected) {
+  // What a node or alarm changing between sizing and encoding looks like
+  addAlarm("one", 3600);
+  size_t length = 0;
+  EXPECT_FALSE(encodeSnapshot(NULL, length));
+  std::vector<uint8_t> buffer(length + 1);
+  size_t sized = buffer.size();
+  EXPECT_FALSE(encodeSnapshot(buffer.data(), sized));
+  EXPECT_EQ(sized, length);
+  EXPECT_TRUE(encodeSnapshot(buffer.data(), length));
+}
+
+}  // namespace
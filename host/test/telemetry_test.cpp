@@ -0,0 +1,107 @@
+// Telemetry fan-out: state topics coalesce to their latest value, events
+// do not. The real taskAlarmScheduler and taskTelemetry run on threads
+// against the simulated clock and WebSocket.
+#include "esp1.cpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "sim.h"
+
+namespace {
+
+// 2023-11-14 22:13:20 UTC, 05:13:20 at UTC+7
+const time_t START = 1700000000;
+
+class Telemetry : public ::testing::Test {
+protected:
+  static void SetUpTestSuite() {
+    clockUtcOffset = 7 * 3600;
+    simSetWallClock((int64_t)START * 1000000);
+    alarmInit();
+    telemetryQueue = xQueueCreate(TELEMETRY_QUEUE_LEN, sizeof(TelemetryFrame));
+    telemetry.onEvent(onTelemetryEvent);
+    xTaskCreate(taskTelemetry, "telemetry", 4096, NULL, 1, &taskHandleTelemetry);
+  }
+
+  static int add(const char* time) {
+    AlarmEntry entry = {};
+    entry.seconds = parseAlarmTime(time);
+    entry.days = ALARM_DAYS_ALL;
+    entry.flags = ALARM_ENABLED;
+    portENTER_CRITICAL(&alarmMux);
+    int slot = alarmAlloc();
+    alarmSet(slot, entry);
+    portEXIT_CRITICAL(&alarmMux);
+    return slot;
+  }
+
+  // Payloads of every frame on topic the peer has got so far
+  static std::vector<std::vector<uint8_t>> frames(SimWsPeer* peer, uint8_t topic) {
+    std::vector<std::vector<uint8_t>> result;
+    for (const std::vector<uint8_t>& frame : simWsReceived(peer)) {
+      if (!frame.empty() && frame[0] == topic) result.emplace_back(frame.begin() + 1, frame.end());
+    }
+    return result;
+  }
+
+  static std::vector<std::vector<uint8_t>> waitFor(SimWsPeer* peer, uint8_t topic, size_t count) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    std::vector<std::vector<uint8_t>> result;
+    while ((result = frames(peer, topic)).size() < count && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return result;
+  }
+};
+
+TEST_F(Telemetry, EveryAlarmInABatchRings) {
+  SimWsPeer* peer = simWsConnect(telemetry);
+
+  // Both due on the same second, so one alarmFireDue pass fires them
+  int first = add("05:13:21");
+  int second = add("05:13:21");
+  xTaskCreate(taskAlarmScheduler, "alarm", 4096, NULL, 1, &taskHandleAlarmScheduler);
+
+  std::vector<std::vector<uint8_t>> rings = waitFor(peer, TOPIC_ALARM, 2);
+  ASSERT_EQ(rings.size(), 2u);
+  std::vector<int> ids;
+  for (const std::vector<uint8_t>& ring : rings) {
+    ASSERT_EQ(ring.size(), 2u);
+    ids.push_back(ring[0] | ring[1] << 8);
+  }
+  EXPECT_EQ(ids, (std::vector<int>{ first, second }));
+  EXPECT_EQ(wsCoalesced, 0u);
+  // Timed on both sides of the queue
+  EXPECT_GE(metricTimers[METRIC_WS_PUBLISH].count, 2u);
+  EXPECT_GT(metricTimers[METRIC_WS_SEND].count, 0u);
+  simWsDisconnect(peer);
+}
+
+TEST_F(Telemetry, StateTopicsKeepOnlyTheLatestValue) {
+  // A client that is not reading owes only the newest ppm
+  SimWsPeer* peer = simWsConnect(telemetry, false);
+  simWsDrain(peer, SIZE_MAX);
+  uint32_t coalesced = wsCoalesced;
+
+  for (uint16_t ppm = 100; ppm < 100 + 3 * WS_MAX_QUEUED_MESSAGES; ppm++) {
+    uint8_t payload[2] = { (uint8_t)ppm, (uint8_t)(ppm >> 8) };
+    telemetryPublish(TOPIC_POLLUTION, payload, sizeof(payload));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(3 * WS_SERVICE_INTERVAL_MS));
+  simWsDrain(peer, SIZE_MAX);
+  std::this_thread::sleep_for(std::chrono::milliseconds(3 * WS_SERVICE_INTERVAL_MS));
+  simWsDrain(peer, SIZE_MAX);
+
+  std::vector<std::vector<uint8_t>> values = frames(peer, TOPIC_POLLUTION);
+  ASSERT_FALSE(values.empty());
+  uint16_t last = values.back()[0] | values.back()[1] << 8;
+  EXPECT_EQ(last, 100 + 3 * WS_MAX_QUEUED_MESSAGES - 1);
+  EXPECT_GT(wsCoalesced, coalesced);
+  simWsDisconnect(peer);
+}
+
+}  // namespace
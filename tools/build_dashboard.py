@@ -0,0 +1,186 @@
+#!/usr/bin/env python3
+"""Build the dashboard for esp1.cpp.
+
+- dashboard.html is minified and gzipped into dashboard_html_gz.h.
+- The static assets are gzipped into data/a/ under content-hashed names,
+  ready to upload as the LittleFS image. They are the icon sprite from
+  assets/ and the alarm beep generated here.
+- dashboard_assets.h lists them for webAssets().
+
+{{asset:<name>}} in dashboard.html becomes the hashed URL of that asset.
+The build fails if the page would still fetch anything from another host.
+
+Run from the repository root after editing dashboard.html or assets/:
+
+    python3 tools/build_dashboard.py
+"""
+
+import gzip
+import hashlib
+import io
+import math
+import pathlib
+import re
+import shutil
+import sys
+import wave
+
+ROOT = pathlib.Path(__file__).resolve().parent.parent
+SOURCE = ROOT / "dashboard.html"
+OUTPUT = ROOT / "dashboard_html_gz.h"
+ASSET_SOURCE = ROOT / "assets"
+ASSET_OUTPUT = ROOT / "data" / "a"
+ASSET_HEADER = ROOT / "dashboard_assets.h"
+ASSET_URL = "/a/"
+
+CONTENT_TYPES = {
+    ".svg": "image/svg+xml",
+    ".wav": "audio/wav",
+}
+
+# Same-origin URLs are built from window.location, anything else is external
+EXTERNAL_URL = re.compile(r"""(?:https?:)?//(?!\$\{window\.location\.)[\w.-]+""")
+URL_CONTEXT = re.compile(r"""(?:src|href)\s*=\s*["']([^"']*)|url\(\s*["']?([^"')]*)|@import\s+["']([^"']*)|fetch\(\s*[`"']([^`"']*)|new\s+(?:Audio|WebSocket)\(\s*[`"']([^`"']*)""")
+
+
+def minify(html):
+    # Comments first, then leading/trailing whitespace and blank lines.
+    # Newlines are kept so the inline scripts never depend on ASI tricks.
+    html = re.sub(r"<!--.*?-->", "", html, flags=re.S)
+    html = re.sub(r"/\*.*?\*/", "", html, flags=re.S)
+    lines = (line.strip() for line in html.splitlines())
+    return "\n".join(line for line in lines if line) + "\n"
+
+
+def alarm_wav():
+    # Three 880 Hz beeps and a pause, 8 kHz 8-bit mono. Looped by the page.
+    rate = 8000
+    samples = bytearray()
+    for beep in range(3):
+        for i in range(int(rate * 0.12)):
+            fade = min(1.0, i / 80, (rate * 0.12 - i) / 80)
+            samples.append(128 + int(100 * fade * math.sin(2 * math.pi * 880 * i / rate)))
+        samples.extend([128] * int(rate * 0.08))
+    samples.extend([128] * int(rate * 0.4))
+
+    out = io.BytesIO()
+    with wave.open(out, "wb") as w:
+        w.setnchannels(1)
+        w.setsampwidth(1)
+        w.setframerate(rate)
+        w.writeframes(bytes(samples))
+    return out.getvalue()
+
+
+def collect_assets():
+    assets = {path.name: path.read_bytes() for path in sorted(ASSET_SOURCE.iterdir()) if path.is_file()}
+    assets["alarm.wav"] = alarm_wav()
+    return assets
+
+
+def write_assets(assets):
+    # Old hashes are dropped so the image only carries what the page uses
+    shutil.rmtree(ASSET_OUTPUT, ignore_errors=True)
+    ASSET_OUTPUT.mkdir(parents=True)
+
+    urls = {}
+    rows = []
+    for name, content in assets.items():
+        stem, ext = name.rsplit(".", 1)
+        ext = "." + ext
+        if ext not in CONTENT_TYPES:
+            sys.exit("asset %s: no content type for %s" % (name, ext))
+
+        hashed = "%s.%s%s" % (stem, hashlib.sha256(content).hexdigest()[:10], ext)
+        compressed = gzip.compress(content, compresslevel=9, mtime=0)
+        (ASSET_OUTPUT / (hashed + ".gz")).write_bytes(compressed)
+
+        urls[name] = ASSET_URL + hashed
+        rows.append('  { "%s", "%s.gz", "%s" },  // %d -> %d bytes'
+                    % (ASSET_URL + hashed, ASSET_URL + hashed, CONTENT_TYPES[ext], len(content), len(compressed)))
+        print("asset %s: %d -> %d bytes, %s" % (name, len(content), len(compressed), ASSET_URL + hashed))
+
+    ASSET_HEADER.write_text(
+        "// Generated by tools/build_dashboard.py from assets/, do not edit.\n"
+        "// The files live in data/a/, upload data/ as the LittleFS image.\n"
+        "#pragma once\n"
+        "\n"
+        "#include <Arduino.h>\n"
+        "\n"
+        "typedef struct DashboardAsset {\n"
+        "  const char* url;\n"
+        "  const char* path;  // gzipped file on LittleFS\n"
+        "  const char* contentType;\n"
+        "} DashboardAsset;\n"
+        "\n"
+        "constexpr DashboardAsset DASHBOARD_ASSETS[] = {\n"
+        "%s\n"
+        "};\n"
+        "\n"
+        "constexpr size_t DASHBOARD_ASSET_COUNT = sizeof(DASHBOARD_ASSETS) / sizeof(DASHBOARD_ASSETS[0]);\n"
+        % "\n".join(rows),
+        encoding="utf-8",
+    )
+    return urls
+
+
+def link_assets(html, urls):
+    def replace(match):
+        name = match.group(1)
+        if name not in urls:
+            sys.exit("dashboard.html: unknown asset %s" % name)
+        return urls[name]
+
+    return re.sub(r"\{\{asset:([\w.-]+)\}\}", replace, html)
+
+
+def check_no_external_requests(html):
+    external = []
+    for match in URL_CONTEXT.finditer(html):
+        url = next(group for group in match.groups() if group is not None)
+        if EXTERNAL_URL.match(url):
+            external.append(url)
+    if external:
+        sys.exit("dashboard.html loads from other hosts: %s" % ", ".join(external))
+
+
+def main():
+    urls = write_assets(collect_assets())
+
+    raw = SOURCE.read_text(encoding="utf-8")
+    page = link_assets(raw, urls)
+    check_no_external_requests(page)
+
+    minified = minify(page).encode("utf-8")
+    # mtime=0 keeps the output (and so the ETag) reproducible.
+    compressed = gzip.compress(minified, compresslevel=9, mtime=0)
+    etag = '"' + hashlib.sha256(compressed).hexdigest()[:16] + '"'
+
+    rows = []
+    for i in range(0, len(compressed), 16):
+        rows.append("  " + ", ".join("0x%02x" % b for b in compressed[i:i + 16]) + ",")
+
+    OUTPUT.write_text(
+        "// Generated by tools/build_dashboard.py from dashboard.html, do not edit.\n"
+        "// raw %d bytes, minified %d bytes, gzip %d bytes\n"
+        "#pragma once\n"
+        "\n"
+        "#include <Arduino.h>\n"
+        "\n"
+        "#define DASHBOARD_HTML_GZ_ETAG \"%s\"\n"
+        "\n"
+        "constexpr size_t DASHBOARD_HTML_GZ_LEN = %d;\n"
+        "\n"
+        "constexpr uint8_t DASHBOARD_HTML_GZ[] PROGMEM = {\n"
+        "%s\n"
+        "};\n"
+        % (len(raw.encode("utf-8")), len(minified), len(compressed),
+           etag.replace('"', '\\"'), len(compressed), "\n".join(rows)),
+        encoding="utf-8",
+    )
+    print("dashboard: %d -> %d -> %d bytes, ETag %s"
+          % (len(raw.encode("utf-8")), len(minified), len(compressed), etag))
+
+
+if __name__ == "__main__":
+    main()